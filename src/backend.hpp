@@ -0,0 +1,122 @@
+#ifndef GPUFANCTL_BACKEND_HPP_INCLUDED
+#define GPUFANCTL_BACKEND_HPP_INCLUDED
+
+#include <concepts>
+#include <optional>
+#include <system_error>
+
+namespace gfc
+{
+
+/* NOTE:
+ * The sensors to read on each update, in addition to the GPU temperature
+ */
+struct SampleSensors
+{
+    bool memory_temperature { false };
+    bool power_usage { false };
+    bool thermal_slowdown { false };
+};
+
+/* NOTE:
+ * A device's sensors, read together. A reading is empty if it wasn't
+ * requested, or if the device doesn't support it. Power usage is in
+ * milliwatts. `thermal_slowdown` is whether the device is slowing itself down
+ * because it's too hot.
+ */
+struct Sample
+{
+    unsigned int gpu_temperature { 0 };
+    std::optional<unsigned int> memory_temperature {};
+    std::optional<unsigned int> power_usage {};
+    std::optional<bool> thermal_slowdown {};
+};
+
+/* NOTE:
+ * What a device supports, probed once when it's acquired. A temperature
+ * threshold of 0 means that the device didn't report it.
+ */
+struct DeviceCapabilities
+{
+    unsigned int min_fan_speed { 0 };
+    unsigned int max_fan_speed { 100 };
+    unsigned int slowdown_temperature { 0 };
+    unsigned int shutdown_temperature { 0 };
+};
+
+/* NOTE:
+ * What the control loop needs from a device's driver. Every operation
+ * reports failure through `ec` rather than throwing, and a fan speed of 0
+ * is never written with `set_fan_speed()`: it means the driver's default
+ * fan profile, which is restored with `set_default_fan_speed()`.
+ */
+template <typename T>
+concept FanControlBackend = requires(T& backend,
+                                     T const& const_backend,
+                                     SampleSensors const& sensors,
+                                     Sample& sample,
+                                     unsigned int fan,
+                                     unsigned int speed,
+                                     std::error_code& ec,
+                                     std::error_code const& error) {
+    { backend.sample(sensors, sample, ec) } noexcept -> std::same_as<bool>;
+    { const_backend.fan_count() } noexcept -> std::same_as<unsigned int>;
+    {
+        backend.set_fan_speed(fan, speed, ec)
+    } noexcept -> std::same_as<bool>;
+    {
+        backend.set_default_fan_speed(fan, ec)
+    } noexcept -> std::same_as<bool>;
+    { T::error_string(error) } noexcept -> std::same_as<char const*>;
+};
+
+/* NOTE:
+ * A backend whose device can go away (e.g. a GPU reset) and be acquired
+ * again. `reacquire()` only succeeds once the device is usable.
+ */
+template <typename T>
+concept RecoverableBackend =
+    FanControlBackend<T> &&
+    requires(T& backend, std::error_code& ec, std::error_code const& error) {
+        { backend.reacquire(ec) } noexcept -> std::same_as<bool>;
+        { T::is_device_lost(error) } noexcept -> std::same_as<bool>;
+    };
+
+/* NOTE:
+ * A backend that can report the speed each fan has been set to, and the
+ * speed it's actually running at, as needed for closed-loop control
+ */
+template <typename T>
+concept FanReadBackBackend =
+    FanControlBackend<T> && requires(T& backend,
+                                     unsigned int fan,
+                                     unsigned int& speed,
+                                     std::error_code& ec,
+                                     std::error_code const& error) {
+        {
+            backend.get_target_fan_speed(fan, speed, ec)
+        } noexcept -> std::same_as<bool>;
+        {
+            backend.get_fan_speed(fan, speed, ec)
+        } noexcept -> std::same_as<bool>;
+        { T::is_unsupported(error) } noexcept -> std::same_as<bool>;
+    };
+
+/* NOTE:
+ * A backend that can cap the device's power draw. Limits are in milliwatts.
+ */
+template <typename T>
+concept PowerLimitBackend =
+    FanControlBackend<T> && requires(T& backend,
+                                     unsigned int limit,
+                                     unsigned int& output,
+                                     std::error_code& ec) {
+        {
+            backend.get_power_limit_constraints(output, output, ec)
+        } noexcept -> std::same_as<bool>;
+        { backend.get_power_limit(output, ec) } noexcept -> std::same_as<bool>;
+        { backend.set_power_limit(limit, ec) } noexcept -> std::same_as<bool>;
+    };
+
+} // namespace gfc
+#endif // GPUFANCTL_BACKEND_HPP_INCLUDED
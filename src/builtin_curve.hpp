@@ -0,0 +1,104 @@
+#ifndef GPUFANCTL_BUILTIN_CURVE_HPP_INCLUDED
+#define GPUFANCTL_BUILTIN_CURVE_HPP_INCLUDED
+
+#include "config.hpp"
+#include "delimiter.hpp"
+#include "parsing.hpp"
+#include "slope.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace gfc
+{
+
+constexpr std::size_t kMaxBakedCurvePoints = 32;
+
+/* NOTE:
+ * A curve that's parsed, validated and evaluated by the compiler. `points`
+ * includes the point at `MaxTemperature` added by parsing, and `fan_speeds`
+ * is the curve's `FanSpeedTable`.
+ */
+template <std::size_t MaxTemperature>
+struct BakedCurve
+{
+    FixedCurvePoints<kMaxBakedCurvePoints + 1> points {};
+    std::array<std::uint8_t, MaxTemperature + 1> fan_speeds {};
+};
+
+/* NOTE:
+ * A malformed definition fails the build. The `throw` can't be evaluated
+ * in a constant expression, so the compiler reports it as an error.
+ */
+template <std::size_t MaxTemperature>
+consteval auto bake_curve(std::string_view definition)
+    -> BakedCurve<MaxTemperature>
+{
+    BakedCurve<MaxTemperature> curve {};
+    if (parse_fixed_curve(definition,
+                          CommaOrWhiteSpaceDelimiter {},
+                          MaxTemperature,
+                          curve.points)) {
+        throw "Invalid built-in fan curve";
+    }
+
+    auto const points = curve.points.view();
+    if (!points.size()) {
+        return curve;
+    }
+
+    /* NOTE:
+     * The same as `evaluate_curve()` on the curve's slopes, which can't be
+     * held in an array here as `Slope` has no default
+     */
+    std::size_t next = 1;
+    for (unsigned int t = 0; t <= MaxTemperature; ++t) {
+        while (next < points.size() - 1 && points[next].temperature < t) {
+            ++next;
+        }
+
+        auto const speed =
+            t < points.front().temperature ? 0u
+            : t > points.back().temperature
+                ? points.back().fan_speed
+                : Slope { points[next - 1], points[next] }(t);
+        curve.fan_speeds[t] = static_cast<std::uint8_t>(speed);
+    }
+
+    return curve;
+}
+
+/* NOTE:
+ * The curve given by `GPUFANCTL_BUILTIN_CURVE` at configure time. It's used
+ * when no curve is given on the command line. Empty if there's none.
+ */
+inline constexpr auto kBuiltinCurve =
+    bake_curve<config::kBuiltinMaxTemperature>(config::kBuiltinCurve);
+
+/* NOTE:
+ * The slopes of a baked curve, without parsing anything at runtime
+ */
+template <std::size_t MaxTemperature>
+auto baked_slopes(BakedCurve<MaxTemperature> const& curve)
+    -> std::vector<Slope>
+{
+    auto const points = curve.points.view();
+
+    std::vector<Slope> slopes;
+    slopes.reserve(points.size() ? points.size() - 1 : 0);
+    transform_adjacent_pairs(points.begin(),
+                             points.end(),
+                             std::back_inserter(slopes),
+                             [](auto const& first, auto const& second) {
+                                 return Slope { first, second };
+                             });
+
+    return slopes;
+}
+
+} // namespace gfc
+#endif // GPUFANCTL_BUILTIN_CURVE_HPP_INCLUDED
@@ -1,94 +1,856 @@
 #include "curve.hpp"
+#include "errors.hpp"
+#include "hwmon.hpp"
 #include "logging.hpp"
-#include "nvml.hpp"
+#include "metrics.hpp"
+#include "nvml_backend.hpp"
 #include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <cstdio>
+#include <limits>
+#include <system_error>
+#include <utility>
+
+namespace
+{
+constexpr auto kMinRecoveryBackoff = std::chrono::seconds(1);
+constexpr auto kMaxRecoveryBackoff = std::chrono::seconds(60);
+
+/* NOTE:
+ * A fan that runs more than `kFanSpeedTolerance` percent away from the speed
+ * it was set to, for `kMaxDivergedTicks` updates in a row, is reported as
+ * ignoring commands. Fans take a few seconds to spin up or down, so a
+ * single reading isn't enough.
+ */
+constexpr unsigned int kFanSpeedTolerance = 10;
+constexpr unsigned int kMaxDivergedTicks = 3;
+
+/* NOTE:
+ * Each power governor step is this percentage of the default power limit.
+ * The temperature has to drop this far below the end of the curve before
+ * the limit is raised again, so that it doesn't oscillate.
+ */
+constexpr unsigned int kPowerStepPercent = 5;
+constexpr unsigned int kPowerRestoreHysteresis = 3;
+
+template <typename Backend>
+auto is_device_lost(std::error_code const& ec) noexcept -> bool
+{
+    if constexpr (gfc::RecoverableBackend<Backend>) {
+        return Backend::is_device_lost(ec);
+    }
+    else {
+        return false;
+    }
+}
+} // namespace
 
 namespace gfc
 {
-auto Curve::operator()() -> void
+template <FanControlBackend Backend>
+auto BasicCurve<Backend>::operator()() noexcept -> void
+{
+    if (recovery.active && !recover()) {
+        return;
+    }
+
+    std::error_code ec {};
+    if (update(ec)) {
+        return;
+    }
+
+    if (is_device_lost<Backend>(ec)) {
+        log(LogLevel::warn,
+            "GPU %u: %s. Re-acquiring the device",
+            device_index,
+            Backend::error_string(ec));
+
+        auto const now = ClockType::now();
+        recovery = Recovery { true, 0, now, now, {} };
+        static_cast<void>(recover());
+    }
+    else if (ec == ErrorCodes::nvml_call_timeout) {
+        log(LogLevel::error,
+            "GPU %u: %s. Setting fans to 100%%",
+            device_index,
+            Backend::error_string(ec));
+        fail_safe();
+    }
+    else {
+        log(LogLevel::warn,
+            "GPU %u: %s. Retrying on the next tick",
+            device_index,
+            Backend::error_string(ec));
+    }
+}
+
+template <FanControlBackend Backend>
+auto BasicCurve<Backend>::recover() noexcept -> bool
+{
+    namespace ch = std::chrono;
+
+    auto const now = ClockType::now();
+    if (now < recovery.next_attempt) {
+        return false;
+    }
+
+    recovery.attempts += 1;
+
+    std::error_code ec {};
+    auto reacquired = false;
+    if constexpr (RecoverableBackend<Backend>) {
+        reacquired = backend.reacquire(ec);
+    }
+
+    if (!reacquired) {
+        recovery.backoff = std::clamp<ClockType::duration>(
+            recovery.backoff * 2, kMinRecoveryBackoff, kMaxRecoveryBackoff);
+        recovery.next_attempt = now + recovery.backoff;
+        log(LogLevel::debug,
+            "GPU %u: Couldn't re-acquire the device: %s. Retrying in %lld ms",
+            device_index,
+            Backend::error_string(ec),
+            static_cast<long long>(
+                ch::duration_cast<ch::milliseconds>(recovery.backoff).count()));
+        return false;
+    }
+
+    /* NOTE:
+     * A reset device will have gone back to its default fan profile, so the
+     * fan speed has to be set again
+     */
+    for (auto& fan : fans) {
+        fan = Fan {};
+    }
+    ramp.active = false;
+    if (pid) {
+        pid->reset();
+    }
+    recovery.active = false;
+
+    /* NOTE:
+     * A reset may also have put back the default power limit
+     */
+    if constexpr (PowerLimitBackend<Backend>) {
+        if (power_governor.enabled) {
+            static_cast<void>(
+                backend.get_power_limit(power_governor.limit, ec));
+        }
+    }
+
+    log(LogLevel::info,
+        "GPU %u: Recovered after %lld ms (%u attempt%s)",
+        device_index,
+        static_cast<long long>(
+            ch::duration_cast<ch::milliseconds>(now - recovery.started)
+                .count()),
+        recovery.attempts,
+        (recovery.attempts > 1 ? "s" : ""));
+
+    return true;
+}
+
+template <FanControlBackend Backend>
+auto BasicCurve<Backend>::fail_safe() noexcept -> void
+{
+    ramp.active = false;
+
+    std::error_code ec {};
+    if (set_fan_speed(capabilities.max_fan_speed, ec)) {
+        return;
+    }
+
+    log(LogLevel::error,
+        "GPU %u: Couldn't set fans to %u%%: %s",
+        device_index,
+        capabilities.max_fan_speed,
+        Backend::error_string(ec));
+}
+
+template <FanControlBackend Backend>
+auto BasicCurve<Backend>::update(std::error_code& ec) noexcept -> bool
 {
     namespace ch = std::chrono;
 
+    Sample sample;
+    if (!backend.sample(sensors, sample, ec)) {
+        return false;
+    }
+
+    auto const raw_temperature = control_temperature(sample);
     auto const current_temperature =
-        nvml::get_device_temperature(device, NVML_TEMPERATURE_GPU);
+        filter_temperature(temperature_filter, raw_temperature);
+    auto const table_fan_speed =
+        get_target_fan_speed(current_temperature, sample.power_usage);
+    auto const curve_fan_speed =
+        pid ? pid_fan_speed(current_temperature, table_fan_speed)
+            : table_fan_speed;
+    if (curve_fan_speed != write_counts.curve_fan_speed) {
+        write_counts.curve_fan_speed = curve_fan_speed;
+        write_counts.unbanded_fan_writes += fans.size();
+    }
 
-    auto const target_fan_speed = get_target_fan_speed(current_temperature);
+    auto const throttled = update_throttling(sample);
+    auto const target_fan_speed = ramp_fan_speed(
+        throttled ? capabilities.max_fan_speed
+                  : hold_fan_speed(current_temperature,
+                                   filter_fan_speed(curve_fan_speed)),
+        throttled);
 
-    if (target_fan_speed != previous_fan_speed) {
+    if (closed_loop && target_fan_speed) {
+        if (!reconcile_fan_speed(target_fan_speed, ec)) {
+            return false;
+        }
+    }
+    else if (!fans_set_to(target_fan_speed)) {
         log(LogLevel::debug,
-            "Current temp. %u -> Target fan speed %u",
+            "GPU %u: Current temp. %u -> Target fan speed %u",
+            device_index,
             current_temperature,
             target_fan_speed);
 
-        set_fan_speed(target_fan_speed);
+        if (!set_fan_speed(target_fan_speed, ec)) {
+            return false;
+        }
     }
     else {
-        log(LogLevel::debug, "No fan speed change");
+        log(LogLevel::debug, "GPU %u: No fan speed change", device_index);
+    }
+
+    if (power_governor.enabled) {
+        update_power_limit(current_temperature, target_fan_speed);
     }
 
     if (print_metrics_to_stdout) {
-        if (!invoked_at_least_once) {
-            dprintf(STDOUT_FILENO, "seconds temperature fan_speed\n");
+        print_metrics(MetricsRecord {
+            ch::duration_cast<ch::seconds>(ClockType::now() - start_time),
+            device_index,
+            current_temperature,
+            target_fan_speed,
+            sample.memory_temperature,
+            sample.power_usage,
+            write_counts.fan_writes,
+            write_counts.unbanded_fan_writes,
+            raw_temperature,
+            pid ? std::optional<PidTerms> { pid->terms } : std::nullopt });
+    }
+
+    return true;
+}
+
+template <FanControlBackend Backend>
+auto BasicCurve<Backend>::pid_fan_speed(unsigned int temperature,
+                                        unsigned int fan_speed) noexcept
+    -> unsigned int
+{
+    namespace ch = std::chrono;
+
+    /* NOTE:
+     * A fan speed of 0 would hand the fans back to the driver, so the
+     * controller never goes below 1%
+     */
+    auto const now = ClockType::now();
+    auto const seconds =
+        ch::duration<double>(now - std::exchange(pid_updated, now)).count();
+    pid->min_output = std::max(capabilities.min_fan_speed, 1u);
+    pid->max_output = capabilities.max_fan_speed;
+
+    return static_cast<unsigned int>(
+        std::lround((*pid)(temperature, fan_speed, seconds)));
+}
+
+template <FanControlBackend Backend>
+auto BasicCurve<Backend>::filter_fan_speed(unsigned int fan_speed) noexcept
+    -> unsigned int
+{
+    namespace ch = std::chrono;
+
+    auto& filter = response;
+    if (filter.attack == ClockType::duration::zero() &&
+        filter.release == ClockType::duration::zero()) {
+        return fan_speed;
+    }
+
+    auto const floor = slopes.size() ? slopes.front().start().fan_speed : 0u;
+    auto const target = static_cast<double>(fan_speed ? fan_speed : floor);
+    auto const now = ClockType::now();
+    auto const previous_update = std::exchange(filter.updated, now);
+
+    if (filter.fan_speed < 0) {
+        filter.fan_speed = target;
+    }
+    else {
+        auto const tau = ch::duration<double>(
+            target > filter.fan_speed ? filter.attack : filter.release);
+        auto const dt = ch::duration<double>(now - previous_update);
+        filter.fan_speed +=
+            (target - filter.fan_speed) *
+            (tau.count() > 0 ? 1 - std::exp(-dt.count() / tau.count()) : 1);
+    }
+
+    auto const filtered =
+        static_cast<unsigned int>(std::lround(filter.fan_speed));
+    return !fan_speed && filtered <= floor ? 0u : filtered;
+}
+
+template <FanControlBackend Backend>
+auto BasicCurve<Backend>::hold_fan_speed(unsigned int temperature,
+                                         unsigned int fan_speed) noexcept
+    -> unsigned int
+{
+    /* NOTE:
+     * Once the fans are no longer at the held speed (e.g. after a thermal
+     * slowdown, a failed write, or re-acquiring the device), they follow the
+     * curve again straight away
+     */
+    auto& band = hysteresis;
+    if (!band.up && !band.down && band.dwell == ClockType::duration::zero()) {
+        return fan_speed;
+    }
+
+    /* NOTE:
+     * While ramping, the fans are on their way to the held speed
+     */
+    auto const now = ClockType::now();
+    auto const held = ramp.active ? ramp.target == band.fan_speed
+                                  : fans_set_to(band.fan_speed);
+    if (band.fan_speed != kUnknownFanSpeed && held) {
+        if (fan_speed == band.fan_speed) {
+            return band.fan_speed;
         }
-        dprintf(STDOUT_FILENO,
-                "%lu %lu %u\n",
-                ch::duration_cast<ch::seconds>(ClockType::now() - start_time)
-                    .count(),
-                current_temperature,
-                target_fan_speed);
 
-        invoked_at_least_once = true;
+        auto const outside_band =
+            fan_speed > band.fan_speed
+                ? temperature >= band.temperature + band.up
+                : temperature + band.down <= band.temperature;
+        auto const dwelling = fan_speed < band.fan_speed &&
+                              now - band.changed < band.dwell;
+        if (!outside_band || dwelling) {
+            return band.fan_speed;
+        }
     }
 
-    previous_fan_speed = target_fan_speed;
+    band.fan_speed = fan_speed;
+    band.temperature = temperature;
+    band.changed = now;
+    return fan_speed;
 }
 
-auto Curve::get_target_fan_speed(unsigned int current_temperature)
+template <FanControlBackend Backend>
+auto BasicCurve<Backend>::ramp_fan_speed(unsigned int fan_speed,
+                                         bool immediate) noexcept
     -> unsigned int
 {
-    if (!slopes.size()) {
-        return 0;
+    if (!ramp.rate || immediate || !fan_speed) {
+        ramp.active = false;
+        return fan_speed;
     }
 
-    auto const slope_pos = std::lower_bound(
-        slopes.begin(),
-        slopes.end(),
-        current_temperature,
-        [&](auto const& a, auto const& b) { return a.end().temperature < b; });
+    auto const now = ClockType::now();
+    if (ramp.active && ramp.target == fan_speed) {
+        auto const position = ramp_position(now);
+        ramp.active = position != fan_speed;
+        return position;
+    }
 
-    if (slope_pos == slopes.end()) {
-        return slopes.back().end().fan_speed;
+    /* NOTE:
+     * A fan whose speed isn't known, or that's under the driver's control,
+     * has no speed to ramp from
+     */
+    auto const current = ramp.active ? ramp_position(now)
+                         : fans.size() ? fans.front().speed
+                                       : kUnknownFanSpeed;
+    if (current == kUnknownFanSpeed || !current || current == fan_speed ||
+        (!ramp.active && !fans_set_to(current))) {
+        ramp.active = false;
+        return fan_speed;
     }
 
-    auto const& slope = *slope_pos;
+    log(LogLevel::debug,
+        "GPU %u: Ramping fans from %u%% to %u%% at %u%%/s",
+        device_index,
+        current,
+        fan_speed,
+        ramp.rate);
+    ramp = Ramp { ramp.rate, true, current, fan_speed, now };
+    return current;
+}
 
-    if (current_temperature < slope.start().temperature) {
-        return 0;
+template <FanControlBackend Backend>
+auto BasicCurve<Backend>::ramp_position(
+    ClockType::time_point now) const noexcept -> unsigned int
+{
+    namespace ch = std::chrono;
+
+    auto const elapsed =
+        ch::duration_cast<ch::milliseconds>(now - ramp.started).count();
+    auto const rising = ramp.target > ramp.from;
+    auto const distance =
+        rising ? ramp.target - ramp.from : ramp.from - ramp.target;
+    auto const change = static_cast<unsigned int>(std::min<long long>(
+        std::max<long long>(elapsed, 0) * ramp.rate / 1000, distance));
+
+    return rising ? ramp.from + change : ramp.from - change;
+}
+
+template <FanControlBackend Backend>
+auto BasicCurve<Backend>::ramp_step_period() const noexcept
+    -> ClockType::duration
+{
+    return std::max<ClockType::duration>(
+        std::chrono::milliseconds(1000 / std::max(ramp.rate, 1u)),
+        kMinRampStepPeriod);
+}
+
+template <FanControlBackend Backend>
+auto BasicCurve<Backend>::step_ramp() noexcept -> void
+{
+    if (!ramp.active) {
+        return;
     }
 
-    return slope(current_temperature);
+    auto const speed = ramp_position(ClockType::now());
+    ramp.active = speed != ramp.target;
+
+    std::error_code ec {};
+    if (!set_fan_speed(speed, ec)) {
+        ramp.active = false;
+        log(LogLevel::warn,
+            "GPU %u: Couldn't ramp the fans to %u%%: %s. Retrying on the "
+            "next tick",
+            device_index,
+            speed,
+            Backend::error_string(ec));
+    }
 }
 
-auto Curve::set_fan_speed(unsigned int speed) -> void
+template <FanControlBackend Backend>
+auto BasicCurve<Backend>::control_temperature(
+    Sample const& sample) const noexcept -> unsigned int
 {
-    for (unsigned int i = 0; i < fan_count; ++i) {
-        if (!speed) {
-            nvml::set_device_default_fan_speed(device, i);
+    switch (control_sensor) {
+    case ControlSensor::memory:
+        return sample.memory_temperature.value_or(sample.gpu_temperature);
+    case ControlSensor::hottest:
+        return std::max(sample.gpu_temperature,
+                        sample.memory_temperature.value_or(0));
+    case ControlSensor::gpu:
+        break;
+    }
+
+    return sample.gpu_temperature;
+}
+
+template <FanControlBackend Backend>
+auto BasicCurve<Backend>::update_throttling(Sample const& sample) noexcept
+    -> bool
+{
+    namespace ch = std::chrono;
+
+    auto const thermal = sample.thermal_slowdown.value_or(false);
+
+    if (thermal && !throttling.active) {
+        throttling.active = true;
+        throttling.events += 1;
+        throttling.started = ClockType::now();
+        log(LogLevel::warn,
+            "GPU %u: Thermal slowdown at %uC (slowdown #%u). Setting fans to "
+            "%u%%",
+            device_index,
+            sample.gpu_temperature,
+            throttling.events,
+            capabilities.max_fan_speed);
+    }
+    else if (!thermal && throttling.active) {
+        throttling.active = false;
+        log(LogLevel::info,
+            "GPU %u: Thermal slowdown cleared after %lld ms",
+            device_index,
+            static_cast<long long>(
+                ch::duration_cast<ch::milliseconds>(ClockType::now() -
+                                                    throttling.started)
+                    .count()));
+    }
+
+    return throttling.active;
+}
+
+template <FanControlBackend Backend>
+auto BasicCurve<Backend>::enable_power_governor(std::error_code& ec) noexcept
+    -> bool
+{
+    if constexpr (!PowerLimitBackend<Backend>) {
+        ec = std::make_error_code(std::errc::operation_not_supported);
+        return false;
+    }
+    else {
+        auto& governor = power_governor;
+        unsigned int max_limit;
+        if (!backend.get_power_limit_constraints(
+                governor.min_limit, max_limit, ec) ||
+            !backend.get_power_limit(governor.default_limit, ec)) {
+            return false;
+        }
+
+        governor.limit = governor.default_limit;
+        governor.step = std::max(
+            governor.default_limit * kPowerStepPercent / 100, 1u);
+        governor.ticks_since_step = kPowerStepTicks;
+        governor.enabled = true;
+
+        log(LogLevel::info,
+            "GPU %u: Power limit %u W, and can be lowered to %u W",
+            device_index,
+            governor.default_limit / 1000,
+            governor.min_limit / 1000);
+        return true;
+    }
+}
+
+template <FanControlBackend Backend>
+auto BasicCurve<Backend>::update_power_limit(
+    unsigned int temperature, unsigned int target_fan_speed) noexcept -> void
+{
+    if constexpr (PowerLimitBackend<Backend>) {
+        auto& governor = power_governor;
+        auto const previous_temperature =
+            std::exchange(governor.previous_temperature, temperature);
+
+        if (!slopes.size() || ++governor.ticks_since_step < kPowerStepTicks) {
+            return;
+        }
+
+        /* NOTE:
+         * The fans can do no more once they're at the top of the curve,
+         * which can be below the device's maximum, or beyond it during a
+         * thermal slowdown
+         */
+        auto const ceiling = slopes.back().end().temperature;
+        auto const saturated =
+            target_fan_speed >= std::min(slopes.back().end().fan_speed,
+                                         capabilities.max_fan_speed);
+        auto limit = governor.limit;
+        if (saturated && temperature > ceiling &&
+            temperature >= previous_temperature &&
+            limit > governor.min_limit) {
+            limit = limit > governor.min_limit + governor.step
+                        ? limit - governor.step
+                        : governor.min_limit;
+        }
+        else if (temperature + kPowerRestoreHysteresis <= ceiling &&
+                 limit < governor.default_limit) {
+            limit = std::min(limit + governor.step, governor.default_limit);
         }
         else {
-            nvml::set_device_fan_speed(device, i, speed);
+            return;
+        }
+
+        std::error_code ec {};
+        if (!backend.set_power_limit(limit, ec)) {
+            log(LogLevel::warn,
+                "GPU %u: Couldn't set the power limit to %u W: %s",
+                device_index,
+                limit / 1000,
+                Backend::error_string(ec));
+            return;
         }
+
+        log(LogLevel::info,
+            "GPU %u: %s the power limit to %u W at %uC",
+            device_index,
+            (limit < governor.limit ? "Lowered" : "Raised"),
+            limit / 1000,
+            temperature);
+        governor.limit = limit;
+        governor.ticks_since_step = 0;
+    }
+    else {
+        static_cast<void>(temperature);
+        static_cast<void>(target_fan_speed);
     }
 }
 
-auto curve(nvmlDevice_t device,
-           std::size_t fan_count,
+template <FanControlBackend Backend>
+auto BasicCurve<Backend>::restore_power_limit() noexcept -> void
+{
+    if constexpr (PowerLimitBackend<Backend>) {
+        auto const& governor = power_governor;
+        if (!governor.enabled || governor.limit == governor.default_limit) {
+            return;
+        }
+
+        std::error_code ec {};
+        if (!backend.set_power_limit(governor.default_limit, ec)) {
+            log(LogLevel::warn,
+                "GPU %u: Couldn't restore the power limit to %u W: %s",
+                device_index,
+                governor.default_limit / 1000,
+                Backend::error_string(ec));
+            return;
+        }
+
+        log(LogLevel::info,
+            "GPU %u: Restored the power limit to %u W",
+            device_index,
+            governor.default_limit / 1000);
+        power_governor.limit = governor.default_limit;
+    }
+}
+
+template <FanControlBackend Backend>
+auto BasicCurve<Backend>::get_target_fan_speed(
+    unsigned int current_temperature,
+    std::optional<unsigned int> power_usage) -> unsigned int
+{
+    if (power_curve && power_usage) {
+        return (*power_curve)(current_temperature, *power_usage);
+    }
+
+    return speed_table(current_temperature);
+}
+
+template <FanControlBackend Backend>
+auto BasicCurve<Backend>::fans_set_to(unsigned int speed) const noexcept
+    -> bool
+{
+    return std::all_of(fans.begin(), fans.end(), [&](auto const& fan) {
+        return fan.speed == speed;
+    });
+}
+
+template <FanControlBackend Backend>
+auto BasicCurve<Backend>::set_fan(unsigned int fan_index,
+                                  unsigned int speed,
+                                  std::error_code& ec) noexcept -> bool
+{
+    auto& fan = fans[fan_index];
+    auto const result =
+        speed ? backend.set_fan_speed(fan_index, speed, ec)
+              : backend.set_default_fan_speed(fan_index, ec);
+    write_counts.fan_writes += 1;
+
+    /* NOTE:
+     * After a failed write, the fan's state isn't known, so it will always
+     * be written to again
+     */
+    fan.speed = result ? speed : kUnknownFanSpeed;
+    fan.error = ec;
+    return result;
+}
+
+template <FanControlBackend Backend>
+auto BasicCurve<Backend>::set_fan_speed(unsigned int speed,
+                                        std::error_code& ec) noexcept -> bool
+{
+    std::error_code fan_ec {};
+    for (unsigned int i = 0; i < fans.size(); ++i) {
+        if (fans[i].speed == speed) {
+            continue;
+        }
+
+        if (!set_fan(i, speed, fan_ec)) {
+            log(LogLevel::debug,
+                "GPU %u: Couldn't set fan %u: %s",
+                device_index,
+                i,
+                Backend::error_string(fan_ec));
+            if (!ec) {
+                ec = fan_ec;
+            }
+            fan_ec.clear();
+        }
+    }
+
+    return !ec;
+}
+
+template <FanControlBackend Backend>
+auto BasicCurve<Backend>::reconcile_fan_speed(unsigned int speed,
+                                              std::error_code& ec) noexcept
+    -> bool
+{
+    if constexpr (!FanReadBackBackend<Backend>) {
+        return set_fan_speed(speed, ec);
+    }
+    else {
+        std::error_code fan_ec {};
+        for (unsigned int i = 0; i < fans.size(); ++i) {
+            /* NOTE:
+             * A fan that's still under the driver's control can report the
+             * same target speed as ours by coincidence, so a fan that we
+             * haven't set yet is always written to
+             */
+            unsigned int target_speed;
+            if (!backend.get_target_fan_speed(i, target_speed, fan_ec)) {
+                if (Backend::is_unsupported(fan_ec)) {
+                    log(LogLevel::warn,
+                        "GPU %u: Can't read back fan speeds: %s. Falling "
+                        "back to open-loop control",
+                        device_index,
+                        Backend::error_string(fan_ec));
+                    closed_loop = false;
+                    ec.clear();
+                    return set_fan_speed(speed, ec);
+                }
+
+                if (!ec) {
+                    ec = fan_ec;
+                }
+                fan_ec.clear();
+                continue;
+            }
+
+            if (fans[i].speed == speed && target_speed == speed) {
+                check_fan_speed(i, speed);
+                continue;
+            }
+
+            log(LogLevel::debug,
+                "GPU %u: Fan %u target speed is %u%%. Setting it to %u%%",
+                device_index,
+                i,
+                target_speed,
+                speed);
+
+            if (!set_fan(i, speed, fan_ec)) {
+                if (!ec) {
+                    ec = fan_ec;
+                }
+                fan_ec.clear();
+                continue;
+            }
+
+            check_fan_speed(i, speed);
+        }
+
+        return !ec;
+    }
+}
+
+template <FanControlBackend Backend>
+auto BasicCurve<Backend>::check_fan_speed(unsigned int fan_index,
+                                          unsigned int speed) noexcept -> void
+{
+    if constexpr (!FanReadBackBackend<Backend>) {
+        static_cast<void>(fan_index);
+        static_cast<void>(speed);
+    }
+    else {
+        std::error_code ec {};
+        unsigned int actual_speed;
+        if (!backend.get_fan_speed(fan_index, actual_speed, ec)) {
+            log(LogLevel::debug,
+                "GPU %u: Couldn't read fan %u speed: %s",
+                device_index,
+                fan_index,
+                Backend::error_string(ec));
+            return;
+        }
+
+        auto& fan = fans[fan_index];
+        auto const difference =
+            actual_speed > speed ? actual_speed - speed : speed - actual_speed;
+        if (difference <= kFanSpeedTolerance) {
+            if (fan.diverged_ticks >= kMaxDivergedTicks) {
+                log(LogLevel::info,
+                    "GPU %u: Fan %u is running at its set speed again",
+                    device_index,
+                    fan_index);
+            }
+            fan.diverged_ticks = 0;
+            return;
+        }
+
+        if (++fan.diverged_ticks == kMaxDivergedTicks) {
+            log(LogLevel::warn,
+                "GPU %u: Fan %u is running at %u%%, but was set to %u%%",
+                device_index,
+                fan_index,
+                actual_speed,
+                speed);
+        }
+    }
+}
+
+template <FanControlBackend Backend>
+auto curve(Backend backend,
+           unsigned int device_index,
+           DeviceCapabilities const& capabilities,
            std::span<Slope const> slopes,
-           bool print_metrics_to_stdout) noexcept -> Curve
+           bool print_metrics_to_stdout,
+           bool closed_loop,
+           ControlSensor control_sensor) -> BasicCurve<Backend>
+{
+    auto const fan_count = backend.fan_count();
+    auto result = BasicCurve<Backend> { std::move(backend),
+                                        slopes,
+                                        print_metrics_to_stdout,
+                                        device_index };
+
+    if constexpr (FanReadBackBackend<Backend>) {
+        result.closed_loop = closed_loop;
+    }
+    else if (closed_loop) {
+        log(LogLevel::warn,
+            "GPU %u: Can't read back fan speeds. Using open-loop control",
+            device_index);
+    }
+
+    result.speed_table = fan_speed_table(slopes);
+    result.fans.resize(fan_count);
+    result.capabilities = capabilities;
+    result.control_sensor = control_sensor;
+
+    /* NOTE:
+     * Only the sensors that are used are read on each update
+     */
+    result.sensors.memory_temperature =
+        control_sensor != ControlSensor::gpu || print_metrics_to_stdout;
+    result.sensors.power_usage = print_metrics_to_stdout;
+    result.sensors.thermal_slowdown = true;
+    return result;
+}
+
+auto clamp_curve(std::span<Slope const> slopes,
+                 DeviceCapabilities const& capabilities) -> std::vector<Slope>
 {
-    return Curve { device, fan_count, slopes, print_metrics_to_stdout };
+    auto const clamp = [&](CurvePoint const& point) {
+        if (!point.fan_speed) {
+            return point;
+        }
+        return CurvePoint { point.temperature,
+                            std::clamp(point.fan_speed,
+                                       capabilities.min_fan_speed,
+                                       capabilities.max_fan_speed) };
+    };
+
+    std::vector<Slope> result;
+    result.reserve(slopes.size());
+    for (auto const& slope : slopes) {
+        result.emplace_back(clamp(slope.start()), clamp(slope.end()));
+    }
+
+    return result;
 }
 
+template struct BasicCurve<NvmlBackend>;
+template struct BasicCurve<HwmonBackend>;
+
+template auto curve(NvmlBackend backend,
+                    unsigned int device_index,
+                    DeviceCapabilities const& capabilities,
+                    std::span<Slope const> slopes,
+                    bool print_metrics_to_stdout,
+                    bool closed_loop,
+                    ControlSensor control_sensor) -> BasicCurve<NvmlBackend>;
+
+template auto curve(HwmonBackend backend,
+                    unsigned int device_index,
+                    DeviceCapabilities const& capabilities,
+                    std::span<Slope const> slopes,
+                    bool print_metrics_to_stdout,
+                    bool closed_loop,
+                    ControlSensor control_sensor) -> BasicCurve<HwmonBackend>;
+
 } // namespace gfc
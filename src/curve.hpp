@@ -1,40 +1,347 @@
 #ifndef GPUFANCTL_CURVE_HPP_INCLUDED
 #define GPUFANCTL_CURVE_HPP_INCLUDED
 
-#include "nvml.h"
+#include "backend.hpp"
+#include "pid_controller.hpp"
+#include "power_curve.hpp"
 #include "slope.hpp"
+#include "temperature_filter.hpp"
 #include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <limits>
+#include <optional>
 #include <span>
+#include <system_error>
+#include <vector>
 
 namespace gfc
 {
 
-struct Curve
+/* NOTE:
+ * The state of a fan that hasn't been set yet, or whose last write failed.
+ * A speed of 0 is the driver's default fan profile.
+ */
+constexpr unsigned int kUnknownFanSpeed =
+    std::numeric_limits<unsigned int>::max();
+
+/* NOTE:
+ * The reading that drives the fan curve. `hottest` is the higher of the GPU
+ * and memory temperatures. If the device can't report its memory
+ * temperature, the GPU temperature is used.
+ */
+enum class ControlSensor
+{
+    gpu,
+    memory,
+    hottest,
+};
+
+/* NOTE:
+ * The control engine for a single device, which drives the device through
+ * `Backend`. Recovering a lost device and closed-loop control are only
+ * available for backends that support them.
+ */
+template <FanControlBackend Backend>
+struct BasicCurve
 {
     using ClockType = std::chrono::high_resolution_clock;
 
-    auto operator()() -> void;
+    /* NOTE:
+     * The state of re-acquiring a device that has been lost (e.g. after a
+     * GPU reset), or after NVML has become uninitialized
+     */
+    struct Recovery
+    {
+        bool active { false };
+        unsigned int attempts { 0 };
+        ClockType::time_point started {};
+        ClockType::time_point next_attempt {};
+        ClockType::duration backoff {};
+    };
+
+    /* NOTE:
+     * A thermal slowdown reported by the device. While it's active, the fans
+     * are held at their maximum speed, regardless of the curve. `events`
+     * counts the slowdowns since startup.
+     */
+    struct Throttling
+    {
+        bool active { false };
+        unsigned int events { 0 };
+        ClockType::time_point started {};
+    };
+
+    /* NOTE:
+     * Manages the device's power limit once the fans can do no more. While
+     * the fans are at the top of the curve, and the temperature is above the
+     * end of the curve and still climbing, the limit is stepped down by
+     * `step`, to no lower than `min_limit`. Once the temperature has
+     * dropped back below the end of the curve, it's stepped back up to
+     * `default_limit`. At most one step is taken every `kPowerStepTicks`
+     * updates. Limits are in milliwatts.
+     */
+    struct PowerGovernor
+    {
+        bool enabled { false };
+        unsigned int min_limit { 0 };
+        unsigned int default_limit { 0 };
+        unsigned int limit { 0 };
+        unsigned int step { 0 };
+        unsigned int previous_temperature { 0 };
+        unsigned int ticks_since_step { 0 };
+    };
+
+    static constexpr unsigned int kPowerStepTicks = 2;
+
+    /* NOTE:
+     * Holds the fan speed while the temperature wanders around a point on
+     * the curve. The fans only follow the curve up once the temperature is
+     * `up` degrees above where their speed was last changed, and down once
+     * it's `down` degrees below it. The fans are only slowed down once
+     * `dwell` has passed since the last change, but are sped up straight
+     * away. A thermal slowdown isn't held back.
+     */
+    struct Hysteresis
+    {
+        unsigned int up { 0 };
+        unsigned int down { 0 };
+        ClockType::duration dwell {};
+        unsigned int temperature { 0 };
+        unsigned int fan_speed { kUnknownFanSpeed };
+        ClockType::time_point changed {};
+    };
+
+    /* NOTE:
+     * Smooths the curve's fan speed with separate time constants for when
+     * it's rising (`attack`) and falling (`release`), so that the fans
+     * react quickly to heat but don't chase brief dips in temperature.
+     * Each update moves `fan_speed` towards the curve by `1 - e^(-dt/tau)`
+     * of the way. A curve speed of 0 (the driver's default fan profile) is
+     * approached as the start of the curve, and only handed back once it's
+     * reached. Both at 0 turns the filter off.
+     */
+    struct Response
+    {
+        ClockType::duration attack {};
+        ClockType::duration release {};
+        double fan_speed { -1 };
+        ClockType::time_point updated {};
+    };
+
+    /* NOTE:
+     * Limits how fast the fan speed changes, to `rate` percent per second.
+     * A change of target starts a ramp from the current fan speed, which is
+     * then moved along by `step_ramp()` every `ramp_step_period()` between
+     * updates. A new target replaces the ramp, and a thermal slowdown, the
+     * fail-safe, or going back to the driver's default fan profile skip it.
+     * A `rate` of 0 turns ramping off.
+     */
+    struct Ramp
+    {
+        unsigned int rate { 0 };
+        bool active { false };
+        unsigned int from { 0 };
+        unsigned int target { 0 };
+        ClockType::time_point started {};
+    };
+
+    static constexpr auto kMinRampStepPeriod = std::chrono::milliseconds(100);
+
+    /* NOTE:
+     * `fan_writes` counts the writes made to the fans, and
+     * `unbanded_fan_writes` the writes that following the curve on every
+     * change of its fan speed would have made, for comparison. Both count
+     * one write per fan.
+     */
+    struct WriteCounts
+    {
+        std::uint64_t fan_writes { 0 };
+        std::uint64_t unbanded_fan_writes { 0 };
+        unsigned int curve_fan_speed { kUnknownFanSpeed };
+    };
+
+    /* NOTE:
+     * What we know of each fan's state. `speed` is the last write that
+     * succeeded, and `error` is the result of the last write. For
+     * closed-loop control, `diverged_ticks` counts the consecutive updates
+     * on which the fan wasn't running at the speed it was set to.
+     */
+    struct Fan
+    {
+        unsigned int speed { kUnknownFanSpeed };
+        std::error_code error {};
+        unsigned int diverged_ticks { 0 };
+    };
+
+    /* NOTE:
+     * Runs a single update. A failed update is retried on the next call. If
+     * a driver call times out then the fans are also set to 100%. If the
+     * device has been lost then it is re-acquired, with a backoff, before
+     * any further updates.
+     */
+    auto operator()() noexcept -> void;
+
+    auto recover() noexcept -> bool;
 
-    auto get_target_fan_speed(unsigned int current_temperature) -> unsigned int;
+    auto update(std::error_code& ec) noexcept -> bool;
 
-    auto set_fan_speed(unsigned int speed) -> void;
+    auto fail_safe() noexcept -> void;
 
-    nvmlDevice_t device;
-    std::size_t fan_count;
+    /* NOTE:
+     * A lookup in `speed_table`, which is built from `slopes` by `curve()`,
+     * or in `power_curve` if there's one and the power draw was sampled
+     */
+    auto get_target_fan_speed(unsigned int current_temperature,
+                              std::optional<unsigned int> power_usage = {})
+        -> unsigned int;
+
+    /* NOTE:
+     * The fan speed that `pid` gives to hold its setpoint, with the curve's
+     * `fan_speed` for `temperature` as the feed-forward
+     */
+    auto pid_fan_speed(unsigned int temperature,
+                       unsigned int fan_speed) noexcept -> unsigned int;
+
+    /* NOTE:
+     * The curve's `fan_speed` after the attack and release filter
+     */
+    auto filter_fan_speed(unsigned int fan_speed) noexcept -> unsigned int;
+
+    /* NOTE:
+     * The fan speed to set given the curve's `fan_speed` for `temperature`,
+     * after applying `hysteresis`
+     */
+    auto hold_fan_speed(unsigned int temperature,
+                        unsigned int fan_speed) noexcept -> unsigned int;
+
+    /* NOTE:
+     * The fan speed to set now on the way to `fan_speed`, starting or
+     * replacing the ramp as needed. `immediate` skips the ramp.
+     */
+    auto ramp_fan_speed(unsigned int fan_speed, bool immediate) noexcept
+        -> unsigned int;
+
+    auto ramp_position(ClockType::time_point now) const noexcept
+        -> unsigned int;
+
+    /* NOTE:
+     * The time between ramp sub-steps, which move the fans by about 1% each
+     */
+    auto ramp_step_period() const noexcept -> ClockType::duration;
+
+    /* NOTE:
+     * Writes the next sub-step of the ramp, without sampling the device.
+     * The ramp is dropped if the write fails, so that the next update
+     * starts from what the fans are known to be set to.
+     */
+    auto step_ramp() noexcept -> void;
+
+    auto control_temperature(Sample const& sample) const noexcept
+        -> unsigned int;
+
+    /* NOTE:
+     * Returns whether the device is in a thermal slowdown, logging when one
+     * starts or ends
+     */
+    auto update_throttling(Sample const& sample) noexcept -> bool;
+
+    /* NOTE:
+     * Reads the device's power limits, and turns on the power governor.
+     * Fails, leaving the governor off, if the backend or the device doesn't
+     * support power limits.
+     */
+    auto enable_power_governor(std::error_code& ec) noexcept -> bool;
+
+    auto update_power_limit(unsigned int temperature,
+                            unsigned int target_fan_speed) noexcept -> void;
+
+    /* NOTE:
+     * Puts back the power limit that the device had at startup, if the
+     * governor has changed it
+     */
+    auto restore_power_limit() noexcept -> void;
+
+    auto fans_set_to(unsigned int speed) const noexcept -> bool;
+
+    auto set_fan(unsigned int fan_index,
+                 unsigned int speed,
+                 std::error_code& ec) noexcept -> bool;
+
+    /* NOTE:
+     * Only writes to the fans that aren't already set to `speed`. A fan
+     * that fails doesn't stop the others from being set.
+     */
+    auto set_fan_speed(unsigned int speed, std::error_code& ec) noexcept
+        -> bool;
+
+    /* NOTE:
+     * Reads back the speed each fan has been set to, and only writes to the
+     * fans that don't match `speed`. Falls back to open-loop control if the
+     * driver can't report fan speeds.
+     */
+    auto reconcile_fan_speed(unsigned int speed, std::error_code& ec) noexcept
+        -> bool;
+
+    auto check_fan_speed(unsigned int fan_index, unsigned int speed) noexcept
+        -> void;
+
+    Backend backend;
     std::span<Slope const> slopes;
     bool print_metrics_to_stdout { false };
+    unsigned int device_index { 0 };
     ClockType::time_point start_time { ClockType::now() };
-    unsigned int previous_fan_speed {
-        std::numeric_limits<unsigned int>::max()
-    };
-    bool invoked_at_least_once { false };
+    Recovery recovery {};
+    bool closed_loop { false };
+    std::vector<Fan> fans {};
+    DeviceCapabilities capabilities {};
+    ControlSensor control_sensor { ControlSensor::gpu };
+    SampleSensors sensors {};
+    Throttling throttling {};
+    PowerGovernor power_governor {};
+    FanSpeedTable speed_table {};
+    Hysteresis hysteresis {};
+    WriteCounts write_counts {};
+    Ramp ramp {};
+    Response response {};
+    TemperatureFilter temperature_filter {};
+
+    /* NOTE:
+     * With a PID controller, the fans hold the temperature at its setpoint
+     * rather than following the curve, which is only the feed-forward
+     */
+    std::optional<PidController> pid {};
+    ClockType::time_point pid_updated {};
+
+    /* NOTE:
+     * Replaces `speed_table` while the device reports its power draw, which
+     * must then be sampled on every update
+     */
+    std::optional<PowerCurve> power_curve {};
 };
 
-auto curve(nvmlDevice_t device,
-           std::size_t fan_count,
+/* NOTE:
+ * Clamps the fan speed of every point on the curve to the range that the
+ * device accepts, so that the control loop never writes a speed that the
+ * driver would reject or ignore. Points at 0% hand the fans back to the
+ * driver's default fan profile rather than setting a speed, so they're left
+ * as they are.
+ */
+auto clamp_curve(std::span<Slope const> slopes,
+                 DeviceCapabilities const& capabilities) -> std::vector<Slope>;
+
+/* NOTE:
+ * Closed-loop control is turned off, with a warning, if the backend can't
+ * read back its fan speeds
+ */
+template <FanControlBackend Backend>
+auto curve(Backend backend,
+           unsigned int device_index,
+           DeviceCapabilities const& capabilities,
            std::span<Slope const> slopes,
-           bool print_metrics_to_stdout = false) noexcept -> Curve;
+           bool print_metrics_to_stdout = false,
+           bool closed_loop = false,
+           ControlSensor control_sensor = ControlSensor::gpu)
+    -> BasicCurve<Backend>;
 } // namespace gfc
 #endif // GPUFANCTL_CURVE_HPP_INCLUDED
@@ -4,27 +4,49 @@
 namespace gfc
 {
 
+/* NOTE:
+ * The comparisons are constexpr, so that curves can be split at compile
+ * time
+ */
 struct CommaOrWhiteSpaceDelimiter
 {
-    friend auto operator==(char lhs,
-                           CommaOrWhiteSpaceDelimiter const& rhs) noexcept
+    friend constexpr auto
+    operator==(char lhs, CommaOrWhiteSpaceDelimiter const& rhs) noexcept
         -> bool;
 
 private:
     static constexpr char const kValues[] = { ',', ' ', '\r', '\n', '\t' };
 };
 
-auto operator==(char lhs, CommaOrWhiteSpaceDelimiter const& rhs) noexcept
-    -> bool;
+constexpr auto operator==(char lhs,
+                          CommaOrWhiteSpaceDelimiter const&) noexcept -> bool
+{
+    for (auto const& c : CommaOrWhiteSpaceDelimiter::kValues) {
+        if (c == lhs)
+            return true;
+    }
 
-auto operator!=(char lhs, CommaOrWhiteSpaceDelimiter const& rhs) noexcept
-    -> bool;
+    return false;
+}
 
-auto operator==(CommaOrWhiteSpaceDelimiter const& lhs, char rhs) noexcept
-    -> bool;
+constexpr auto operator!=(char lhs,
+                          CommaOrWhiteSpaceDelimiter const& rhs) noexcept
+    -> bool
+{
+    return !(lhs == rhs);
+}
 
-auto operator!=(CommaOrWhiteSpaceDelimiter const& lhs, char rhs) noexcept
-    -> bool;
+constexpr auto operator==(CommaOrWhiteSpaceDelimiter const& lhs,
+                          char rhs) noexcept -> bool
+{
+    return rhs == lhs;
+}
+
+constexpr auto operator!=(CommaOrWhiteSpaceDelimiter const& lhs,
+                          char rhs) noexcept -> bool
+{
+    return !(rhs == lhs);
+}
 
 } // namespace gfc
 
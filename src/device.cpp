@@ -0,0 +1,257 @@
+#include "device.hpp"
+#include "logging.hpp"
+#include "nvml.hpp"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+namespace
+{
+struct PciLocation
+{
+    unsigned int domain { 0 };
+    unsigned int bus { 0 };
+    unsigned int device { 0 };
+    unsigned int function { 0 };
+};
+
+auto parse_hex(std::string_view input, unsigned int& value) noexcept -> bool
+{
+    auto const* last = input.data() + input.size();
+    auto const result = std::from_chars(input.data(), last, value, 16);
+    return input.size() && result.ec == std::errc {} && result.ptr == last;
+}
+
+auto parse_pci_bus_id(std::string_view input, PciLocation& location) noexcept
+    -> bool
+{
+    location = PciLocation {};
+
+    if (auto const dot = input.find('.'); dot != std::string_view::npos) {
+        if (!parse_hex(input.substr(dot + 1), location.function)) {
+            return false;
+        }
+        input = input.substr(0, dot);
+    }
+
+    auto const device_sep = input.rfind(':');
+    if (device_sep == std::string_view::npos ||
+        !parse_hex(input.substr(device_sep + 1), location.device)) {
+        return false;
+    }
+    input = input.substr(0, device_sep);
+
+    if (auto const bus_sep = input.rfind(':');
+        bus_sep != std::string_view::npos) {
+        if (!parse_hex(input.substr(0, bus_sep), location.domain)) {
+            return false;
+        }
+        input = input.substr(bus_sep + 1);
+    }
+
+    return parse_hex(input, location.bus);
+}
+
+auto is_uuid(std::string_view selector) noexcept -> bool
+{
+    return selector.starts_with("GPU-") || selector.starts_with("MIG-");
+}
+
+/* NOTE:
+ * NVML reports UUIDs in lower case, but they're often copied from tools
+ * that don't
+ */
+auto equal_ignoring_case(std::string_view lhs, std::string_view rhs) noexcept
+    -> bool
+{
+    return std::equal(
+        lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), [](char a, char b) {
+            return std::tolower(static_cast<unsigned char>(a)) ==
+                   std::tolower(static_cast<unsigned char>(b));
+        });
+}
+
+auto describe(gfc::Device const& device) -> std::string
+{
+    return "GPU " + std::to_string(device.index) + " (" +
+           (device.uuid.size() ? device.uuid : std::string { "no UUID" }) +
+           ")";
+}
+} // namespace
+
+namespace gfc
+{
+auto probe_capabilities(nvmlDevice_t handle) noexcept -> DeviceCapabilities
+{
+    DeviceCapabilities capabilities {};
+    std::error_code ec {};
+
+    unsigned int min_speed;
+    unsigned int max_speed;
+    if (nvml::get_device_min_max_fan_speed(handle, min_speed, max_speed, ec) &&
+        min_speed <= max_speed) {
+        capabilities.min_fan_speed = min_speed;
+        capabilities.max_fan_speed = std::min(max_speed, 100u);
+    }
+
+    ec.clear();
+    unsigned int temperature;
+    if (nvml::get_device_temperature_threshold(
+            handle, NVML_TEMPERATURE_THRESHOLD_SLOWDOWN, temperature, ec)) {
+        capabilities.slowdown_temperature = temperature;
+    }
+
+    ec.clear();
+    if (nvml::get_device_temperature_threshold(
+            handle, NVML_TEMPERATURE_THRESHOLD_SHUTDOWN, temperature, ec)) {
+        capabilities.shutdown_temperature = temperature;
+    }
+
+    return capabilities;
+}
+
+auto enumerate_devices() -> std::vector<Device>
+{
+    auto const device_count =
+        static_cast<unsigned int>(nvml::get_device_count());
+
+    std::vector<Device> devices;
+    devices.reserve(device_count);
+
+    for (unsigned int i = 0; i < device_count; ++i) {
+        try {
+            auto handle = nvml::get_device_handle_by_index(i);
+            auto const fan_count = nvml::get_device_fan_count(handle);
+            if (fan_count < 1) {
+                log(LogLevel::warn, "GPU %u has no fans. Skipping", i);
+                continue;
+            }
+
+            auto const capabilities = probe_capabilities(handle);
+
+            log(LogLevel::info,
+                "GPU %u has %u fan%s, with speeds of %u-%u%%",
+                i,
+                fan_count,
+                (fan_count > 1 ? "s" : ""),
+                capabilities.min_fan_speed,
+                capabilities.max_fan_speed);
+
+            if (capabilities.slowdown_temperature) {
+                log(LogLevel::info,
+                    "GPU %u slows down at %uC",
+                    i,
+                    capabilities.slowdown_temperature);
+            }
+            if (capabilities.shutdown_temperature) {
+                log(LogLevel::info,
+                    "GPU %u shuts down at %uC",
+                    i,
+                    capabilities.shutdown_temperature);
+            }
+
+            Device device { i, handle, fan_count, capabilities };
+
+            std::error_code ec {};
+            nvml::Uuid uuid {};
+            if (nvml::get_device_uuid(handle, uuid, ec)) {
+                device.uuid = uuid.value;
+            }
+
+            ec.clear();
+            nvmlPciInfo_t pci {};
+            if (nvml::get_device_pci_info(handle, pci, ec)) {
+                device.pci = pci;
+            }
+
+            if (device.uuid.size() && device.pci) {
+                log(LogLevel::info,
+                    "GPU %u is %s, at PCI %s",
+                    i,
+                    device.uuid.c_str(),
+                    device.pci->busId);
+            }
+
+            devices.push_back(std::move(device));
+        }
+        catch (std::exception const& e) {
+            log(LogLevel::warn, "Couldn't acquire GPU %u: %s", i, e.what());
+        }
+    }
+
+    return devices;
+}
+
+auto matches_device(Device const& device, std::string_view selector) -> bool
+{
+    if (is_uuid(selector)) {
+        return device.uuid.size() && equal_ignoring_case(device.uuid, selector);
+    }
+
+    /* NOTE:
+     * `nvmlPciInfo_t` has no function number, but a GPU is always function 0
+     */
+    PciLocation location;
+    return device.pci && parse_pci_bus_id(selector, location) &&
+           location.domain == device.pci->domain &&
+           location.bus == device.pci->bus &&
+           location.device == device.pci->device && location.function == 0;
+}
+
+auto select_devices(std::span<Device const> devices,
+                    std::span<std::string_view const> selectors)
+    -> std::vector<Device>
+{
+    std::vector<Device> selected;
+    selected.reserve(selectors.size());
+
+    for (auto const selector : selectors) {
+        PciLocation location;
+        if (!is_uuid(selector) && !parse_pci_bus_id(selector, location)) {
+            throw std::runtime_error { "Invalid device '" +
+                                       std::string { selector } +
+                                       "'. Expected a UUID or PCI bus ID" };
+        }
+
+        auto const matching = std::count_if(
+            devices.begin(), devices.end(), [&](auto const& device) {
+                return matches_device(device, selector);
+            });
+
+        if (matching != 1) {
+            throw std::runtime_error {
+                std::string { matching ? "More than one device matches '"
+                                       : "No device with fans matches '" } +
+                std::string { selector } + "'"
+            };
+        }
+
+        auto const& device = *std::find_if(
+            devices.begin(), devices.end(), [&](auto const& candidate) {
+                return matches_device(candidate, selector);
+            });
+
+        if (device.uuid.empty()) {
+            throw std::runtime_error { describe(device) +
+                                       " can't be selected, because it "
+                                       "doesn't report its UUID" };
+        }
+
+        if (std::any_of(
+                selected.begin(), selected.end(), [&](auto const& other) {
+                    return other.uuid == device.uuid;
+                })) {
+            throw std::runtime_error { describe(device) +
+                                       " is selected more than once" };
+        }
+
+        selected.push_back(device);
+    }
+
+    return selected;
+}
+} // namespace gfc
@@ -0,0 +1,60 @@
+#ifndef GPUFANCTL_DEVICE_HPP_INCLUDED
+#define GPUFANCTL_DEVICE_HPP_INCLUDED
+
+#include "backend.hpp"
+#include "nvml.h"
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace gfc
+{
+
+/* NOTE:
+ * `index` is only where NVML enumerated the device this time around. The
+ * UUID and PCI location identify the card itself, and are empty if the
+ * device couldn't report them.
+ */
+struct Device
+{
+    unsigned int index;
+    nvmlDevice_t handle;
+    unsigned int fan_count;
+    DeviceCapabilities capabilities {};
+    std::string uuid {};
+    std::optional<nvmlPciInfo_t> pci {};
+};
+
+/* NOTE:
+ * Anything the device can't report is left at its default.
+ */
+auto probe_capabilities(nvmlDevice_t handle) noexcept -> DeviceCapabilities;
+
+/* NOTE:
+ * Acquires every device that has at least one fan. Devices that can't be
+ * acquired, or that have no fans, are skipped with a warning.
+ */
+auto enumerate_devices() -> std::vector<Device>;
+
+/* NOTE:
+ * A selector is either a UUID, starting with `GPU-` or `MIG-`, or a PCI bus
+ * ID of the form `[DOMAIN:]BUS:DEVICE[.FUNCTION]` in hex. A PCI bus ID matches
+ * regardless of its zero padding, so `1:0.0`, `01:00.0` and NVML's own
+ * `00000000:01:00.0` are the same device.
+ */
+auto matches_device(Device const& device, std::string_view selector) -> bool;
+
+/* NOTE:
+ * Returns the device matching each selector, in the order of `selectors`.
+ * Throws unless every selector matches exactly one device, and no device is
+ * selected twice. A device must report its UUID to be selected, so that it
+ * can be found again by UUID if it's lost.
+ */
+auto select_devices(std::span<Device const> devices,
+                    std::span<std::string_view const> selectors)
+    -> std::vector<Device>;
+
+} // namespace gfc
+#endif // GPUFANCTL_DEVICE_HPP_INCLUDED
@@ -1,4 +1,6 @@
 #include "errors.hpp"
+#include <cstring>
+#include <string.h>
 
 namespace gfc
 {
@@ -32,6 +34,17 @@ auto ErrorCategory::message(int condition) const -> std::string
                "--force if this is intentional";
     case ErrorCodes::invalid_flag_value:
         return "Invalid flag argument";
+    case ErrorCodes::nvml_call_timeout:
+        return "NVML call timed out";
+    case ErrorCodes::too_many_curve_points:
+        return "Too many curve points";
+    case ErrorCodes::duplicate_power:
+        return "Duplicate power curve";
+    case ErrorCodes::power_curve_order:
+        return "Fan speeds must not drop as power rises";
+    case ErrorCodes::builtin_curve_max_temperature:
+        return "The built-in fan curve's maximum temperature is set at build "
+               "time";
     }
 
     return "Unknown";
@@ -48,4 +61,36 @@ auto make_error_code(ErrorCodes errc) noexcept -> std::error_code
     return std::error_code { static_cast<int>(errc), validation_category() };
 }
 
+auto error_message(std::error_code const& ec) noexcept -> char const*
+{
+    thread_local char buffer[256];
+
+    auto const copy = [](char const* message) {
+        std::strncpy(buffer, message, sizeof(buffer) - 1);
+        buffer[sizeof(buffer) - 1] = '\0';
+    };
+
+    /* NOTE:
+     * This is the GNU `strerror_r()`, which may return a static string
+     * rather than writing to the buffer
+     */
+    if (ec.category() == std::system_category() ||
+        ec.category() == std::generic_category()) {
+        auto const* message = ::strerror_r(ec.value(), buffer, sizeof(buffer));
+        if (message != buffer) {
+            copy(message);
+        }
+        return buffer;
+    }
+
+    try {
+        copy(ec.message().c_str());
+    }
+    catch (...) {
+        copy("Unknown error");
+    }
+
+    return buffer;
+}
+
 } // namespace gfc
@@ -19,6 +19,11 @@ enum class ErrorCodes : int
     max_temperature_exceeded,
     force_required_to_set_temperature,
     invalid_flag_value,
+    nvml_call_timeout,
+    too_many_curve_points,
+    duplicate_power,
+    power_curve_order,
+    builtin_curve_max_temperature,
 };
 
 struct ErrorCategory : std::error_category
@@ -30,6 +35,13 @@ struct ErrorCategory : std::error_category
 auto validation_category() noexcept -> std::error_category const&;
 
 auto make_error_code(ErrorCodes errc) noexcept -> std::error_code;
+
+/* NOTE:
+ * The message for any error code, written to a buffer owned by the calling
+ * thread, which stays valid until that thread's next call. Unlike
+ * `std::strerror()`, this is safe to call from any thread.
+ */
+auto error_message(std::error_code const& ec) noexcept -> char const*;
 } // namespace gfc
 
 namespace std
@@ -0,0 +1,162 @@
+#include "event_listener.hpp"
+#include "logging.hpp"
+#include "nvml.hpp"
+#include <algorithm>
+#include <system_error>
+#include <utility>
+
+namespace gfc
+{
+EventListener::~EventListener()
+{
+    stop();
+}
+
+auto EventListener::start(std::span<Device const> devices, Callback callback)
+    -> bool
+{
+    handles.clear();
+    indices.clear();
+    for (auto const& device : devices) {
+        handles.push_back(device.handle);
+        indices.push_back(device.index);
+    }
+
+    if (!register_devices()) {
+        return false;
+    }
+
+    on_event = std::move(callback);
+    request_stop = false;
+    listen_thread = std::thread { [this] {
+        while (!request_stop) {
+            if (std::unique_lock lock { mutex }; refresh_requested) {
+                refresh_requested = false;
+                lock.unlock();
+                static_cast<void>(register_devices());
+            }
+
+            /* NOTE:
+             * No device could be registered again yet. It's retried on
+             * the next refresh.
+             */
+            if (!event_set) {
+                std::this_thread::sleep_for(kWaitTimeout);
+                continue;
+            }
+
+            std::error_code wait_ec {};
+            nvmlEventData_t event {};
+            if (nvml::wait_for_event(
+                    event_set, event, kWaitTimeout, wait_ec)) {
+                std::unique_lock lock { mutex };
+                auto const pos =
+                    std::find(handles.begin(), handles.end(), event.device);
+                auto const found = pos != handles.end();
+                auto const position =
+                    static_cast<std::size_t>(pos - handles.begin());
+                lock.unlock();
+
+                if (found) {
+                    on_event(position);
+                }
+                continue;
+            }
+
+            if (wait_ec == nvml::make_error_code(NVML_ERROR_TIMEOUT)) {
+                continue;
+            }
+
+            /* NOTE:
+             * E.g. a lost device. Don't spin on an error that persists
+             */
+            log(LogLevel::debug,
+                "Waiting on NVML events: %s",
+                nvml::error_string(wait_ec));
+            std::this_thread::sleep_for(kWaitTimeout);
+        }
+    } };
+
+    return true;
+}
+
+auto EventListener::refresh(std::size_t position,
+                            nvmlDevice_t handle) noexcept -> void
+{
+    std::unique_lock lock { mutex };
+    if (position < handles.size()) {
+        handles[position] = handle;
+        refresh_requested = true;
+    }
+}
+
+auto EventListener::register_devices() noexcept -> bool
+{
+    if (event_set) {
+        nvml::free_event_set(std::exchange(event_set, nullptr));
+    }
+
+    std::error_code ec {};
+    if (!nvml::create_event_set(event_set, ec)) {
+        log(LogLevel::warn,
+            "Couldn't create an NVML event set: %s",
+            nvml::error_string(ec));
+        event_set = nullptr;
+        return false;
+    }
+
+    std::unique_lock lock { mutex };
+    auto const devices = handles;
+    lock.unlock();
+
+    bool registered = false;
+    for (std::size_t i = 0; i < devices.size(); ++i) {
+        ec.clear();
+        unsigned long long supported = 0;
+        static_cast<void>(nvml::get_device_supported_event_types(
+            devices[i], supported, ec));
+
+        auto const event_types = supported & kWakeEventTypes;
+        if (!event_types) {
+            log(LogLevel::info,
+                "GPU %u doesn't report any clock or power events",
+                indices[i]);
+            continue;
+        }
+
+        if (!nvml::register_device_events(
+                devices[i], event_types, event_set, ec)) {
+            log(LogLevel::warn,
+                "Couldn't register for GPU %u events: %s",
+                indices[i],
+                nvml::error_string(ec));
+            continue;
+        }
+
+        log(LogLevel::debug,
+            "Waiting on GPU %u events 0x%llx",
+            indices[i],
+            event_types);
+        registered = true;
+    }
+
+    if (!registered) {
+        nvml::free_event_set(std::exchange(event_set, nullptr));
+    }
+
+    return registered;
+}
+
+auto EventListener::stop() noexcept -> void
+{
+    if (listen_thread.joinable()) {
+        request_stop = true;
+        listen_thread.join();
+    }
+
+    if (event_set) {
+        nvml::free_event_set(std::exchange(event_set, nullptr));
+    }
+}
+
+} // namespace gfc
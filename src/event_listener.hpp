@@ -0,0 +1,78 @@
+#ifndef GPUFANCTL_EVENT_LISTENER_HPP_INCLUDED
+#define GPUFANCTL_EVENT_LISTENER_HPP_INCLUDED
+
+#include "device.hpp"
+#include "nvml.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace gfc
+{
+
+/* NOTE:
+ * The events that suggest a device's load, and so its temperature, is about
+ * to change
+ */
+constexpr unsigned long long kWakeEventTypes =
+    nvmlEventTypeClock | nvmlEventTypePState | nvmlEventTypePowerSourceChange;
+
+/* NOTE:
+ * Waits on NVML events from a set of devices on its own thread, and calls
+ * `on_event` on that thread with the position in `devices` of the device
+ * that each event came from. Only the `kWakeEventTypes` that each device
+ * supports are registered.
+ */
+struct EventListener
+{
+    using Callback = std::function<void(std::size_t)>;
+
+    /* NOTE:
+     * The longest that `stop()` waits on the listening thread, unless the
+     * driver itself doesn't return
+     */
+    static constexpr auto kWaitTimeout = std::chrono::milliseconds(250);
+
+    EventListener() = default;
+    EventListener(EventListener const&) = delete;
+    auto operator=(EventListener const&) -> EventListener& = delete;
+    ~EventListener();
+
+    /* NOTE:
+     * Returns false, without starting the thread, if none of the devices
+     * support any of the events
+     */
+    auto start(std::span<Device const> devices, Callback callback) -> bool;
+
+    auto stop() noexcept -> void;
+
+    /* NOTE:
+     * Called once the device at `position` has been re-acquired, with its
+     * new handle. A GPU reset drops the device's registrations, and
+     * re-initializing NVML frees the event set, so the listening thread
+     * registers every device again in a new event set.
+     */
+    auto refresh(std::size_t position, nvmlDevice_t handle) noexcept -> void;
+
+    /* NOTE:
+     * Only called on the listening thread, or before it has started
+     */
+    auto register_devices() noexcept -> bool;
+
+    nvmlEventSet_t event_set { nullptr };
+    std::mutex mutex {};
+    std::vector<nvmlDevice_t> handles {};
+    std::vector<unsigned int> indices {};
+    bool refresh_requested { false };
+    Callback on_event {};
+    std::atomic_bool request_stop { false };
+    std::thread listen_thread {};
+};
+
+} // namespace gfc
+#endif // GPUFANCTL_EVENT_LISTENER_HPP_INCLUDED
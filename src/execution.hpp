@@ -20,9 +20,12 @@
 #include "execution/repeat_effect.hpp"
 #include "execution/schedule.hpp"
 #include "execution/single_thread_context.hpp"
+#include "execution/static_thread_pool.hpp"
 #include "execution/start.hpp"
 #include "execution/stop_when.hpp"
 #include "execution/sync_wait.hpp"
 #include "execution/then.hpp"
+#include "execution/timer_context.hpp"
+#include "execution/when_all.hpp"
 
 #endif
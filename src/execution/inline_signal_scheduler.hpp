@@ -2,6 +2,7 @@
 #define GPUFANCTL_EXECUTION_INLINE_SIGNAL_SCHEDULER_HPP_INCLUDED
 
 #include "execution/get_stop_token.hpp"
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <csignal>
@@ -56,8 +57,17 @@ struct InlineSignalOperation
                                  struct sigaction> { sig, {} };
             });
 
+        /* NOTE:
+         * Only this operation's signals are unblocked while waiting, so that
+         * several operations can wait on different signals, each on their
+         * own thread.
+         */
         sigset_t unblock;
-        sigemptyset(&unblock);
+        pthread_sigmask(SIG_SETMASK, nullptr, &unblock);
+
+        for (auto& sig : signal_and_actions) {
+            sigdelset(&unblock, std::get<0>(sig));
+        }
 
         for (auto& sig : signal_and_actions) {
             struct sigaction action
@@ -77,11 +87,13 @@ struct InlineSignalOperation
                 ch::duration_cast<ch::nanoseconds>(kKeepAliveInterval).count()
         };
 
+        bool received = false;
         while (!should_stop()) {
             auto e =
                 ppoll(nullptr, 0, std::addressof(ts), std::addressof(unblock));
             if (e < 0) {
                 EXEC_CHECK(errno == EINTR);
+                received = true;
                 break;
             }
         }
@@ -91,7 +103,16 @@ struct InlineSignalOperation
                 std::get<0>(sig), std::addressof(std::get<1>(sig)), nullptr);
         }
 
-        static_cast<Receiver&&>(receiver).set_value();
+        /* NOTE:
+         * Only a received signal completes with a value. A stop request
+         * completes with `done`.
+         */
+        if (received) {
+            static_cast<Receiver&&>(receiver).set_value();
+        }
+        else {
+            static_cast<Receiver&&>(receiver).set_done();
+        }
     }
 
     auto start()
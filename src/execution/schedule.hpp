@@ -26,10 +26,33 @@ struct after_fn
     }
 };
 
+struct at_fn
+{
+    template <typename Scheduler, typename Clock, typename Duration>
+    auto operator()(Scheduler&& scheduler,
+                    std::chrono::time_point<Clock, Duration> const& at)
+        const noexcept
+    {
+        return static_cast<Scheduler&&>(scheduler).schedule_at(at);
+    }
+
+    template <typename Scheduler,
+              typename Clock,
+              typename Duration,
+              typename Wake>
+    auto operator()(Scheduler&& scheduler,
+                    std::chrono::time_point<Clock, Duration> const& at,
+                    Wake& wake) const noexcept
+    {
+        return static_cast<Scheduler&&>(scheduler).schedule_at(at, wake);
+    }
+};
+
 } // namespace schedule_
 
 inline constexpr schedule_::fn schedule {};
 inline constexpr schedule_::after_fn schedule_after {};
+inline constexpr schedule_::at_fn schedule_at {};
 
 } // namespace gfc::execution
 #endif // GPUFANCTL_EXECUTION_SCHEDULE_HPP_INCLUDED
@@ -0,0 +1,84 @@
+#include "execution/static_thread_pool.hpp"
+#include "execution/assertion.hpp"
+#include <utility>
+
+namespace gfc::execution::static_thread_pool_
+{
+auto static_thread_pool::scheduler::schedule() noexcept -> schedule_sender
+{
+    return schedule_sender { pool };
+}
+
+auto static_thread_pool::run(std::size_t thread_count) -> void
+{
+    EXEC_CHECK(thread_count > 0);
+    EXEC_CHECK(run_threads.empty());
+
+    request_stop.exchange(0);
+    run_threads.reserve(thread_count);
+    for (std::size_t i = 0; i < thread_count; ++i) {
+        run_threads.emplace_back([this]() {
+            std::unique_lock lock { mutex };
+            while (!request_stop) {
+                while (head == nullptr) {
+                    if (request_stop) {
+                        return;
+                    }
+                    cv.wait(lock);
+                }
+
+                EXEC_CHECK(head != nullptr);
+                pending_completion* c = head;
+                head = std::exchange(c->next, nullptr);
+                if (head == nullptr) {
+                    tail = nullptr;
+                }
+                lock.unlock();
+
+                pending_completion::completion execute =
+                    std::exchange(c->execute, nullptr);
+                EXEC_CHECK(execute != nullptr);
+                execute(c);
+
+                lock.lock();
+            }
+        });
+    }
+}
+
+auto static_thread_pool::stop() noexcept -> void
+{
+    if (!request_stop) {
+        EXEC_CHECK(run_threads.size());
+        {
+            std::unique_lock lock { mutex };
+            request_stop.exchange(1);
+        }
+        cv.notify_all();
+        for (auto& t : run_threads) {
+            t.join();
+        }
+        run_threads.clear();
+    }
+}
+
+auto static_thread_pool::enqueue(pending_completion* c) noexcept -> void
+{
+    std::unique_lock lock { mutex };
+    if (head == nullptr) {
+        head = c;
+    }
+    else {
+        tail->next = c;
+    }
+    tail = c;
+    c->next = nullptr;
+    cv.notify_one();
+}
+
+auto get_scheduler(static_thread_pool& pool) noexcept
+    -> static_thread_pool::scheduler
+{
+    return static_thread_pool::scheduler { std::addressof(pool) };
+}
+} // namespace gfc::execution::static_thread_pool_
@@ -0,0 +1,113 @@
+#ifndef GPUFANCTL_EXECUTION_STATIC_THREAD_POOL_HPP_INCLUDED
+#define GPUFANCTL_EXECUTION_STATIC_THREAD_POOL_HPP_INCLUDED
+
+#include "execution/assertion.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+namespace gfc::execution
+{
+namespace static_thread_pool_
+{
+
+struct pending_completion
+{
+    using completion = auto (*)(pending_completion*) noexcept -> void;
+    completion execute;
+    pending_completion* next = nullptr;
+};
+
+/* NOTE:
+ * A fixed number of threads servicing a single FIFO queue. Unlike a
+ * `single_thread_context`, work that blocks one of the threads doesn't
+ * prevent the remaining queued work from being executed.
+ */
+struct static_thread_pool
+{
+    pending_completion* head = nullptr;
+    pending_completion* tail = head;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::atomic_int8_t request_stop = 0;
+    std::vector<std::thread> run_threads;
+
+    template <typename Receiver>
+    requires(!std::is_reference_v<Receiver>)
+    struct operation : pending_completion
+    {
+        template <typename Receiver_>
+        operation(Receiver_&& r, static_thread_pool* p) noexcept
+            : pending_completion { &operation::execute_impl }
+            , receiver { std::forward<Receiver_>(r) }
+            , pool { p }
+        {
+        }
+
+        auto start() noexcept -> void;
+
+        static auto execute_impl(pending_completion* self) noexcept -> void
+        {
+            operation& op = *static_cast<operation*>(self);
+            try {
+                static_cast<Receiver&&>(op.receiver).set_value();
+            }
+            catch (...) {
+                static_cast<Receiver&&>(op.receiver)
+                    .set_error(std::current_exception());
+            }
+        }
+
+        Receiver receiver;
+        static_thread_pool* pool;
+    };
+
+    struct schedule_sender
+    {
+        template <typename Receiver>
+        auto connect(Receiver&& r) noexcept
+        {
+            return operation<std::remove_cvref_t<Receiver>> {
+                std::forward<Receiver>(r), pool
+            };
+        }
+
+        static_thread_pool* pool;
+    };
+
+    struct scheduler
+    {
+        auto schedule() noexcept -> schedule_sender;
+
+        static_thread_pool* pool;
+    };
+
+    friend auto get_scheduler(static_thread_pool& pool) noexcept -> scheduler;
+
+    auto run(std::size_t thread_count) -> void;
+
+    auto stop() noexcept -> void;
+
+    auto enqueue(pending_completion* c) noexcept -> void;
+};
+
+auto get_scheduler(static_thread_pool& pool) noexcept
+    -> static_thread_pool::scheduler;
+
+template <typename Receiver>
+requires(!std::is_reference_v<Receiver>)
+auto static_thread_pool::operation<Receiver>::start() noexcept -> void
+{
+    EXEC_CHECK(pool != nullptr);
+    pool->enqueue(this);
+}
+} // namespace static_thread_pool_
+
+using static_thread_pool = static_thread_pool_::static_thread_pool;
+} // namespace gfc::execution
+
+#endif // GPUFANCTL_EXECUTION_STATIC_THREAD_POOL_HPP_INCLUDED
@@ -2,9 +2,11 @@
 #define GPUFANCTL_EXECUTION_STOP_WHEN_HPP_INCLUDED
 
 #include "execution/connect.hpp"
+#include "execution/get_stop_token.hpp"
 #include "execution/start.hpp"
 #include <exception>
 #include <mutex>
+#include <optional>
 #include <stop_token>
 namespace gfc::execution
 {
@@ -71,9 +73,25 @@ struct StopWhenStopReceiver
     Op* state { nullptr };
 };
 
+/* NOTE:
+ * A stop request on the receiver's stop token is forwarded to both senders,
+ * so that a `stop_when` can itself be stopped by an enclosing `stop_when`.
+ */
 template <typename Sender, typename StopSender, typename Receiver>
 struct StopWhenOperation
 {
+    struct forward_stop
+    {
+        auto operator()() const noexcept
+        {
+            stop_source->request_stop();
+        }
+
+        std::stop_source* stop_source;
+    };
+
+    using StopCallback = std::stop_callback<forward_stop>;
+
     using OnwardOperation = std::remove_cvref_t<
         std::invoke_result_t<decltype(execution::connect),
                              Sender&&,
@@ -99,6 +117,8 @@ struct StopWhenOperation
 
     auto start()
     {
+        stop_callback.emplace(execution::get_stop_token(receiver),
+                              forward_stop { &stop_source });
         execution::start(onward_operation);
         execution::start(stop_operation);
     }
@@ -114,6 +134,7 @@ struct StopWhenOperation
             auto err = std::move(error);
             lock.unlock();
 
+            stop_callback.reset();
             if (err) {
                 static_cast<Receiver&&>(receiver).set_error(std::move(err));
             }
@@ -135,6 +156,7 @@ struct StopWhenOperation
             auto err = std::move(error);
             lock.unlock();
 
+            stop_callback.reset();
             if (err) {
                 static_cast<Receiver&&>(receiver).set_error(std::move(err));
             }
@@ -151,6 +173,7 @@ struct StopWhenOperation
     OnwardOperation onward_operation;
     StopOperation stop_operation;
     std::stop_source stop_source {};
+    std::optional<StopCallback> stop_callback {};
     std::atomic_uint32_t remaining { 2 };
     std::exception_ptr error;
     std::mutex mutex;
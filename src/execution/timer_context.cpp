@@ -0,0 +1,111 @@
+#include "execution/timer_context.hpp"
+#include "execution/assertion.hpp"
+#include <memory>
+#include <utility>
+
+namespace gfc::execution::timer_context_
+{
+auto timer_context::scheduler::schedule_at(
+    clock_type::time_point deadline) noexcept -> schedule_at_sender
+{
+    return schedule_at_sender { deadline, nullptr, ctx };
+}
+
+auto timer_context::scheduler::schedule_at(clock_type::time_point deadline,
+                                           std::atomic_bool& wake) noexcept
+    -> schedule_at_sender
+{
+    return schedule_at_sender { deadline, std::addressof(wake), ctx };
+}
+
+auto timer_context::run() -> void
+{
+    request_stop.exchange(0);
+    run_thread = std::thread([this]() {
+        std::unique_lock lock { mutex };
+        while (!request_stop) {
+            auto wake_at = clock_type::now() + kKeepAliveInterval;
+            if (head != nullptr && head->deadline < wake_at) {
+                wake_at = head->deadline;
+            }
+            cv.wait_until(lock, wake_at);
+
+            /* NOTE:
+             * Unlink every timer that has either expired or had a stop
+             * requested, then complete them outside of the lock. The list
+             * is ordered by deadline, but stop requests can arrive for any
+             * of the timers, so the whole list has to be checked...
+             */
+            auto const now = clock_type::now();
+            pending_timer* ready = nullptr;
+            pending_timer** ready_tail = &ready;
+            pending_timer** pos = &head;
+            while (*pos != nullptr) {
+                pending_timer* t = *pos;
+                bool const stopped = t->stop_requested(t);
+                bool const woken = t->wake && t->wake->exchange(false);
+                if (stopped || woken || t->deadline <= now) {
+                    *pos = std::exchange(t->next, nullptr);
+                    t->stopped = stopped;
+                    *ready_tail = t;
+                    ready_tail = &t->next;
+                }
+                else {
+                    pos = &t->next;
+                }
+            }
+            lock.unlock();
+
+            while (ready != nullptr) {
+                pending_timer* t = ready;
+                ready = std::exchange(t->next, nullptr);
+
+                pending_timer::completion execute =
+                    std::exchange(t->execute, nullptr);
+                EXEC_CHECK(execute != nullptr);
+                execute(t);
+            }
+
+            lock.lock();
+        }
+    });
+}
+
+auto timer_context::stop() noexcept -> void
+{
+    if (!request_stop) {
+        EXEC_CHECK(run_thread.joinable());
+        request_stop.exchange(1);
+        cv.notify_one();
+        run_thread.join();
+    }
+}
+
+auto timer_context::enqueue(pending_timer* t) noexcept -> void
+{
+    std::unique_lock lock { mutex };
+    pending_timer** pos = &head;
+    while (*pos != nullptr && (*pos)->deadline <= t->deadline) {
+        pos = &(*pos)->next;
+    }
+
+    t->next = *pos;
+    *pos = t;
+
+    if (head == t) {
+        cv.notify_one();
+    }
+}
+
+auto timer_context::wake(std::atomic_bool& flag) noexcept -> void
+{
+    flag = true;
+    std::unique_lock lock { mutex };
+    cv.notify_one();
+}
+
+auto get_scheduler(timer_context& ctx) noexcept -> timer_context::scheduler
+{
+    return timer_context::scheduler { std::addressof(ctx) };
+}
+} // namespace gfc::execution::timer_context_
@@ -0,0 +1,166 @@
+#ifndef GPUFANCTL_EXECUTION_TIMER_CONTEXT_HPP_INCLUDED
+#define GPUFANCTL_EXECUTION_TIMER_CONTEXT_HPP_INCLUDED
+
+#include "execution/assertion.hpp"
+#include "execution/get_stop_token.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+namespace gfc::execution
+{
+namespace timer_context_
+{
+
+using clock_type = std::chrono::steady_clock;
+
+struct pending_timer
+{
+    using completion = auto (*)(pending_timer*) noexcept -> void;
+    using stop_check = auto (*)(pending_timer*) noexcept -> bool;
+    completion execute;
+    stop_check stop_requested;
+    clock_type::time_point deadline;
+    std::atomic_bool* wake = nullptr;
+    pending_timer* next = nullptr;
+    bool stopped = false;
+};
+
+/* NOTE:
+ * A single thread that completes operations when their deadline is reached.
+ * None of the scheduled work should be run here: the completion of a timer
+ * should immediately transfer execution to another context, so that a
+ * long-running operation can never delay another timer's deadline.
+ *
+ * Pending operations are checked for stop requests at least every
+ * `kKeepAliveInterval`, in which case they complete with `set_done()`.
+ *
+ * An operation scheduled with a wake flag also completes before its deadline
+ * once the flag is set by `wake()`. A flag that is set while no operation is
+ * waiting on it completes the next operation that does, straight away.
+ */
+struct timer_context
+{
+    static constexpr auto kKeepAliveInterval = std::chrono::milliseconds(50);
+
+    pending_timer* head = nullptr;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::atomic_int8_t request_stop = 0;
+    std::thread run_thread;
+
+    template <typename Receiver>
+    requires(!std::is_reference_v<Receiver>)
+    struct operation : pending_timer
+    {
+        template <typename Receiver_>
+        operation(Receiver_&& r,
+                  clock_type::time_point at,
+                  std::atomic_bool* w,
+                  timer_context* c) noexcept
+            : pending_timer { &operation::execute_impl,
+                              &operation::stop_requested_impl,
+                              at,
+                              w }
+            , receiver { std::forward<Receiver_>(r) }
+            , ctx { c }
+        {
+        }
+
+        auto start() noexcept -> void;
+
+        static auto stop_requested_impl(pending_timer* self) noexcept -> bool
+        {
+            operation& op = *static_cast<operation*>(self);
+            return execution::get_stop_token(op.receiver).stop_requested();
+        }
+
+        static auto execute_impl(pending_timer* self) noexcept -> void
+        {
+            operation& op = *static_cast<operation*>(self);
+            if (op.stopped) {
+                static_cast<Receiver&&>(op.receiver).set_done();
+                return;
+            }
+
+            try {
+                static_cast<Receiver&&>(op.receiver).set_value();
+            }
+            catch (...) {
+                static_cast<Receiver&&>(op.receiver)
+                    .set_error(std::current_exception());
+            }
+        }
+
+        Receiver receiver;
+        timer_context* ctx;
+    };
+
+    struct schedule_at_sender
+    {
+        template <typename Receiver>
+        auto connect(Receiver&& r) noexcept
+        {
+            return operation<std::remove_cvref_t<Receiver>> {
+                std::forward<Receiver>(r), deadline, wake, ctx
+            };
+        }
+
+        clock_type::time_point deadline;
+        std::atomic_bool* wake;
+        timer_context* ctx;
+    };
+
+    struct scheduler
+    {
+        auto schedule_at(clock_type::time_point deadline) noexcept
+            -> schedule_at_sender;
+
+        auto schedule_at(clock_type::time_point deadline,
+                         std::atomic_bool& wake) noexcept -> schedule_at_sender;
+
+        template <typename Rep, typename Period>
+        auto
+        schedule_after(std::chrono::duration<Rep, Period> const& after) noexcept
+            -> schedule_at_sender
+        {
+            return schedule_at(
+                clock_type::now() +
+                std::chrono::duration_cast<clock_type::duration>(after));
+        }
+
+        timer_context* ctx;
+    };
+
+    friend auto get_scheduler(timer_context& ctx) noexcept -> scheduler;
+
+    auto run() -> void;
+
+    auto stop() noexcept -> void;
+
+    auto enqueue(pending_timer* t) noexcept -> void;
+
+    /* NOTE:
+     * Sets `flag`, completing the operation waiting on it (if any) early
+     */
+    auto wake(std::atomic_bool& flag) noexcept -> void;
+};
+
+auto get_scheduler(timer_context& ctx) noexcept -> timer_context::scheduler;
+
+template <typename Receiver>
+requires(!std::is_reference_v<Receiver>)
+auto timer_context::operation<Receiver>::start() noexcept -> void
+{
+    EXEC_CHECK(ctx != nullptr);
+    ctx->enqueue(this);
+}
+} // namespace timer_context_
+
+using timer_context = timer_context_::timer_context;
+} // namespace gfc::execution
+
+#endif // GPUFANCTL_EXECUTION_TIMER_CONTEXT_HPP_INCLUDED
@@ -0,0 +1,200 @@
+#ifndef GPUFANCTL_EXECUTION_WHEN_ALL_HPP_INCLUDED
+#define GPUFANCTL_EXECUTION_WHEN_ALL_HPP_INCLUDED
+
+#include "execution/box.hpp"
+#include "execution/connect.hpp"
+#include "execution/get_stop_token.hpp"
+#include "execution/start.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <type_traits>
+#include <vector>
+namespace gfc::execution
+{
+namespace when_all_
+{
+
+template <typename Op>
+struct WhenAllReceiver
+{
+    auto set_value()
+    {
+        EXEC_CHECK(state != nullptr);
+        state->complete();
+    }
+
+    auto set_error(std::exception_ptr e) noexcept
+    {
+        EXEC_CHECK(state != nullptr);
+        state->set_error(std::move(e));
+    }
+
+    auto set_done() noexcept
+    {
+        EXEC_CHECK(state != nullptr);
+        state->set_done();
+    }
+
+    auto get_stop_token() const noexcept
+    {
+        EXEC_CHECK(state != nullptr);
+        return state->stop_source.get_token();
+    }
+
+    Op* state;
+};
+
+/* NOTE:
+ * Starts every sender in the range concurrently, and completes once they
+ * have all completed. If any of them completes with an error or `done`,
+ * a stop is requested on the remaining ones, and the first error (or
+ * otherwise `done`) is forwarded to the receiver. A stop request on the
+ * receiver's stop token is forwarded to every sender.
+ */
+template <typename Sender, typename Receiver>
+requires(!(std::is_reference_v<Sender> || std::is_reference_v<Receiver>))
+struct WhenAllOperation
+{
+    using InnerOperation = std::remove_cvref_t<
+        std::invoke_result_t<decltype(execution::connect),
+                             Sender&&,
+                             WhenAllReceiver<WhenAllOperation>&&>>;
+
+    struct forward_stop
+    {
+        auto operator()() const noexcept
+        {
+            stop_source->request_stop();
+        }
+
+        std::stop_source* stop_source;
+    };
+
+    using StopCallback = std::stop_callback<forward_stop>;
+
+    template <typename Receiver_>
+    WhenAllOperation(std::vector<Sender>&& s, Receiver_&& r)
+        : receiver { std::forward<Receiver_>(r) }
+        , senders { std::move(s) }
+        , operations { std::make_unique<Box<InnerOperation>[]>(
+              senders.size()) }
+        , remaining { static_cast<std::uint32_t>(senders.size()) }
+    {
+    }
+
+    auto start()
+    {
+        if (!senders.size()) {
+            static_cast<Receiver&&>(receiver).set_value();
+            return;
+        }
+
+        stop_callback.emplace(execution::get_stop_token(receiver),
+                              forward_stop { &stop_source });
+
+        for (std::size_t i = 0; i < senders.size(); ++i) {
+            operations[i].construct_with([&] {
+                return execution::connect(static_cast<Sender&&>(senders[i]),
+                                          WhenAllReceiver { this });
+            });
+        }
+
+        for (std::size_t i = 0; i < senders.size(); ++i) {
+            execution::start(get(operations[i]));
+        }
+    }
+
+    auto complete() noexcept
+    {
+        auto const n = remaining.fetch_sub(1);
+        EXEC_CHECK(n > 0);
+        if (n > 1) {
+            return;
+        }
+
+        stop_callback.reset();
+
+        std::unique_lock lock { mutex };
+        auto err = std::move(error);
+        auto const was_done = done;
+        lock.unlock();
+
+        if (err) {
+            static_cast<Receiver&&>(receiver).set_error(std::move(err));
+        }
+        else if (was_done) {
+            static_cast<Receiver&&>(receiver).set_done();
+        }
+        else {
+            static_cast<Receiver&&>(receiver).set_value();
+        }
+    }
+
+    auto set_error(std::exception_ptr e) noexcept
+    {
+        {
+            std::unique_lock lock { mutex };
+            if (!error) {
+                error = std::move(e);
+            }
+        }
+        stop_source.request_stop();
+        complete();
+    }
+
+    auto set_done() noexcept
+    {
+        {
+            std::unique_lock lock { mutex };
+            done = true;
+        }
+        stop_source.request_stop();
+        complete();
+    }
+
+    Receiver receiver;
+    std::vector<Sender> senders;
+    std::unique_ptr<Box<InnerOperation>[]> operations;
+    std::stop_source stop_source {};
+    std::optional<StopCallback> stop_callback {};
+    std::atomic_uint32_t remaining;
+    std::exception_ptr error {};
+    bool done { false };
+    std::mutex mutex;
+};
+
+template <typename Sender>
+requires(!std::is_reference_v<Sender>)
+struct WhenAllSender
+{
+    template <typename Receiver>
+    auto connect(Receiver&& receiver)
+    {
+        return WhenAllOperation<Sender, std::remove_cvref_t<Receiver>> {
+            std::move(senders), std::forward<Receiver>(receiver)
+        };
+    }
+
+    std::vector<Sender> senders;
+};
+
+struct fn
+{
+    template <typename Sender>
+    auto operator()(std::vector<Sender> senders) const
+    {
+        return WhenAllSender<Sender> { std::move(senders) };
+    }
+};
+
+} // namespace when_all_
+
+inline constexpr when_all_::fn when_all {};
+} // namespace gfc::execution
+#endif // GPUFANCTL_EXECUTION_WHEN_ALL_HPP_INCLUDED
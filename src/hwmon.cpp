@@ -0,0 +1,329 @@
+#include "hwmon.hpp"
+#include "errors.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <fcntl.h>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+
+namespace
+{
+constexpr std::size_t kMaxAttributeSize = 32;
+
+auto last_error() noexcept -> std::error_code
+{
+    return std::error_code { errno, std::system_category() };
+}
+
+auto is_missing(std::error_code const& ec) noexcept -> bool
+{
+    return ec == std::errc::no_such_file_or_directory;
+}
+
+/* NOTE:
+ * Only used while opening the attributes, to find the memory temperature
+ * channel
+ */
+auto read_label(std::string const& path, std::string& label) noexcept -> bool
+{
+    std::error_code ec {};
+    gfc::hwmon::File file;
+    if (!gfc::hwmon::open_attribute(path, O_RDONLY, file, ec)) {
+        return false;
+    }
+
+    char buffer[kMaxAttributeSize];
+    auto const n = ::pread(file.fd, buffer, sizeof(buffer), 0);
+    if (n < 0) {
+        return false;
+    }
+
+    std::string_view value { buffer, static_cast<std::size_t>(n) };
+    while (value.size() && (value.back() == '\n' || value.back() == ' ')) {
+        value.remove_suffix(1);
+    }
+
+    label = value;
+    return true;
+}
+
+} // namespace
+
+namespace gfc
+{
+namespace hwmon
+{
+File::File(int descriptor) noexcept
+    : fd { descriptor }
+{
+}
+
+File::File(File&& other) noexcept
+    : fd { std::exchange(other.fd, -1) }
+{
+}
+
+File::~File()
+{
+    if (fd >= 0) {
+        ::close(fd);
+    }
+}
+
+auto File::operator=(File&& other) noexcept -> File&
+{
+    File tmp { std::move(other) };
+    std::swap(fd, tmp.fd);
+    return *this;
+}
+
+File::operator bool() const noexcept
+{
+    return fd >= 0;
+}
+
+auto open_attribute(std::string const& path,
+                    int flags,
+                    File& file,
+                    std::error_code& ec) noexcept -> bool
+{
+    auto const fd = ::open(path.c_str(), flags | O_CLOEXEC);
+    if (fd < 0) {
+        ec = last_error();
+        return false;
+    }
+
+    file = File { fd };
+    return true;
+}
+
+auto read_attribute(File const& file,
+                    long long& value,
+                    std::error_code& ec) noexcept -> bool
+{
+    char buffer[kMaxAttributeSize];
+    ssize_t n;
+    while ((n = ::pread(file.fd, buffer, sizeof(buffer), 0)) < 0 &&
+           errno == EINTR)
+        ;
+
+    if (n < 0) {
+        ec = last_error();
+        return false;
+    }
+
+    auto const result = std::from_chars(buffer, buffer + n, value);
+    if (result.ec != std::errc {}) {
+        ec = std::make_error_code(std::errc::invalid_argument);
+        return false;
+    }
+
+    return true;
+}
+
+auto write_attribute(File const& file,
+                     long long value,
+                     std::error_code& ec) noexcept -> bool
+{
+    char buffer[kMaxAttributeSize];
+    auto const result =
+        std::to_chars(buffer, buffer + sizeof(buffer) - 1, value);
+    *result.ptr = '\n';
+    auto const size = static_cast<std::size_t>(result.ptr + 1 - buffer);
+
+    ssize_t n;
+    while ((n = ::pwrite(file.fd, buffer, size, 0)) < 0 && errno == EINTR)
+        ;
+
+    if (n < 0) {
+        ec = last_error();
+        return false;
+    }
+
+    if (static_cast<std::size_t>(n) != size) {
+        ec = std::make_error_code(std::errc::io_error);
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace hwmon
+
+auto HwmonBackend::open(std::error_code& ec) noexcept -> bool
+{
+    temperature = hwmon::File {};
+    memory_temperature = hwmon::File {};
+    power = hwmon::File {};
+
+    if (!hwmon::open_attribute(
+            path + "/temp1_input", O_RDONLY, temperature, ec)) {
+        return false;
+    }
+
+    std::error_code optional_ec {};
+    for (unsigned int i = 1; i <= hwmon::kMaxChannels; ++i) {
+        auto const channel = path + "/temp" + std::to_string(i);
+        std::string label;
+        if (read_label(channel + "_label", label) && label == "mem") {
+            static_cast<void>(hwmon::open_attribute(
+                channel + "_input", O_RDONLY, memory_temperature, optional_ec));
+            break;
+        }
+    }
+
+    /* NOTE:
+     * Not every driver reports an average power
+     */
+    if (!hwmon::open_attribute(
+            path + "/power1_average", O_RDONLY, power, optional_ec)) {
+        static_cast<void>(hwmon::open_attribute(
+            path + "/power1_input", O_RDONLY, power, optional_ec));
+    }
+
+    std::vector<hwmon::Fan> opened;
+    for (unsigned int i = 1; i <= hwmon::kMaxChannels; ++i) {
+        auto const channel = path + "/pwm" + std::to_string(i);
+        hwmon::Fan fan {};
+        fan.channel = i;
+        std::error_code fan_ec {};
+        if (!hwmon::open_attribute(channel, O_RDWR, fan.pwm, fan_ec)) {
+            if (is_missing(fan_ec)) {
+                continue;
+            }
+            ec = fan_ec;
+            return false;
+        }
+
+        if (!hwmon::open_attribute(
+                channel + "_enable", O_RDWR, fan.enable, ec)) {
+            return false;
+        }
+
+        /* NOTE:
+         * The mode to hand the fan back in is the one it was in when it
+         * was first opened, not what it's been left in since. A fan that
+         * was already under manual control (e.g. by a run that didn't exit
+         * cleanly) has no mode to go back to, so it's given to the
+         * driver's automatic control.
+         */
+        auto const previous =
+            std::find_if(fans.begin(), fans.end(), [&](auto const& other) {
+                return other.channel == i;
+            });
+        long long mode;
+        if (previous != fans.end()) {
+            fan.automatic_mode = previous->automatic_mode;
+        }
+        else if (hwmon::read_attribute(fan.enable, mode, fan_ec) &&
+                 mode != hwmon::kPwmEnableManual) {
+            fan.automatic_mode = mode;
+        }
+
+        opened.push_back(std::move(fan));
+    }
+
+    fans = std::move(opened);
+    return true;
+}
+
+auto HwmonBackend::sample(SampleSensors const& sensors,
+                          Sample& sample,
+                          std::error_code& ec) noexcept -> bool
+{
+    long long value;
+    if (!hwmon::read_attribute(temperature, value, ec)) {
+        return false;
+    }
+
+    /* NOTE:
+     * Temperatures are in millidegrees, and power in microwatts
+     */
+    sample = Sample {};
+    sample.gpu_temperature = static_cast<unsigned int>(
+        std::max<long long>(value / 1000, 0));
+
+    std::error_code sensor_ec {};
+    if (sensors.memory_temperature && memory_temperature &&
+        hwmon::read_attribute(memory_temperature, value, sensor_ec)) {
+        sample.memory_temperature = static_cast<unsigned int>(
+            std::max<long long>(value / 1000, 0));
+    }
+
+    if (sensors.power_usage && power &&
+        hwmon::read_attribute(power, value, sensor_ec)) {
+        sample.power_usage =
+            static_cast<unsigned int>(std::max<long long>(value / 1000, 0));
+    }
+
+    return true;
+}
+
+auto HwmonBackend::fan_count() const noexcept -> unsigned int
+{
+    return static_cast<unsigned int>(fans.size());
+}
+
+auto HwmonBackend::set_fan_speed(unsigned int fan_index,
+                                 unsigned int speed,
+                                 std::error_code& ec) noexcept -> bool
+{
+    if (fan_index >= fans.size()) {
+        ec = std::make_error_code(std::errc::invalid_argument);
+        return false;
+    }
+
+    auto& fan = fans[fan_index];
+    if (!fan.manual) {
+        if (!hwmon::write_attribute(
+                fan.enable, hwmon::kPwmEnableManual, ec)) {
+            return false;
+        }
+        fan.manual = true;
+    }
+
+    auto const pwm =
+        (std::min(speed, 100u) * hwmon::kPwmMax + 50) / 100;
+    return hwmon::write_attribute(fan.pwm, pwm, ec);
+}
+
+auto HwmonBackend::set_default_fan_speed(unsigned int fan_index,
+                                         std::error_code& ec) noexcept -> bool
+{
+    if (fan_index >= fans.size()) {
+        ec = std::make_error_code(std::errc::invalid_argument);
+        return false;
+    }
+
+    auto& fan = fans[fan_index];
+    if (!hwmon::write_attribute(fan.enable, fan.automatic_mode, ec)) {
+        return false;
+    }
+
+    fan.manual = false;
+    return true;
+}
+
+auto HwmonBackend::reacquire(std::error_code& ec) noexcept -> bool
+{
+    long long value;
+    return open(ec) && hwmon::read_attribute(temperature, value, ec);
+}
+
+auto HwmonBackend::is_device_lost(std::error_code const& ec) noexcept -> bool
+{
+    return ec == std::errc::no_such_device ||
+           ec == std::errc::no_such_device_or_address;
+}
+
+auto HwmonBackend::error_string(std::error_code const& ec) noexcept
+    -> char const*
+{
+    return error_message(ec);
+}
+
+} // namespace gfc
@@ -0,0 +1,127 @@
+#ifndef GPUFANCTL_HWMON_HPP_INCLUDED
+#define GPUFANCTL_HWMON_HPP_INCLUDED
+
+#include "backend.hpp"
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace gfc
+{
+namespace hwmon
+{
+
+/* NOTE:
+ * An open sysfs attribute, closed when it goes out of scope
+ */
+struct File
+{
+    File() noexcept = default;
+    explicit File(int fd) noexcept;
+    File(File&& other) noexcept;
+    ~File();
+
+    auto operator=(File&& other) noexcept -> File&;
+
+    explicit operator bool() const noexcept;
+
+    int fd { -1 };
+};
+
+/* NOTE:
+ * Attributes are opened once, and then read and written with
+ * `pread()`/`pwrite()` at offset 0 on every update. sysfs regenerates an
+ * attribute's value on each read from the start of the file.
+ */
+auto open_attribute(std::string const& path,
+                    int flags,
+                    File& file,
+                    std::error_code& ec) noexcept -> bool;
+
+auto read_attribute(File const& file,
+                    long long& value,
+                    std::error_code& ec) noexcept -> bool;
+
+auto write_attribute(File const& file,
+                     long long value,
+                     std::error_code& ec) noexcept -> bool;
+
+constexpr long long kPwmMax = 255;
+constexpr long long kPwmEnableManual = 1;
+constexpr long long kPwmEnableAutomatic = 2;
+
+/* NOTE:
+ * `pwm` is the fan's duty cycle, from 0 to 255. `enable` selects manual
+ * control (1) or one of the driver's automatic modes, which vary between
+ * drivers (e.g. nct6775 has several). `automatic_mode` is the one that the
+ * fan was in before it was taken over, and is put back by
+ * `set_default_fan_speed()`. `channel` is the number in `pwm<N>`.
+ */
+struct Fan
+{
+    unsigned int channel { 0 };
+    File pwm;
+    File enable;
+    bool manual { false };
+    long long automatic_mode { kPwmEnableAutomatic };
+};
+
+/* NOTE:
+ * The highest numbered `temp*` and `pwm*` attributes that are looked for
+ */
+constexpr unsigned int kMaxChannels = 16;
+
+} // namespace hwmon
+
+/* NOTE:
+ * Controls the fans of a device through its hwmon directory in sysfs (e.g.
+ * `/sys/class/drm/card0/device/hwmon/hwmon2`), as exposed by amdgpu and
+ * most other hwmon drivers. The GPU temperature is `temp1_input`, and the
+ * memory temperature is the channel labelled "mem", if there is one. Every
+ * `pwm*` attribute is a fan.
+ */
+struct HwmonBackend
+{
+    /* NOTE:
+     * Opens every attribute that's used. Any that are already open are
+     * closed first, except for the fans, which are only replaced once they
+     * have all been opened, so that a failed open doesn't lose their
+     * original modes.
+     */
+    auto open(std::error_code& ec) noexcept -> bool;
+
+    auto sample(SampleSensors const& sensors,
+                Sample& sample,
+                std::error_code& ec) noexcept -> bool;
+
+    auto fan_count() const noexcept -> unsigned int;
+
+    auto set_fan_speed(unsigned int fan,
+                       unsigned int speed,
+                       std::error_code& ec) noexcept -> bool;
+
+    auto set_default_fan_speed(unsigned int fan, std::error_code& ec) noexcept
+        -> bool;
+
+    /* NOTE:
+     * The attributes go away along with the device (e.g. when the driver
+     * is unbound), so they're opened again
+     */
+    auto reacquire(std::error_code& ec) noexcept -> bool;
+
+    static auto is_device_lost(std::error_code const& ec) noexcept -> bool;
+
+    static auto error_string(std::error_code const& ec) noexcept
+        -> char const*;
+
+    std::string path;
+    hwmon::File temperature {};
+    hwmon::File memory_temperature {};
+    hwmon::File power {};
+    std::vector<hwmon::Fan> fans {};
+};
+
+static_assert(RecoverableBackend<HwmonBackend>);
+
+} // namespace gfc
+#endif // GPUFANCTL_HWMON_HPP_INCLUDED
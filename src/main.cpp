@@ -1,42 +1,189 @@
+#include "builtin_curve.hpp"
 #include "cmdline.hpp"
 #include "config.hpp"
 #include "curve.hpp"
 #include "delimiter.hpp"
+#include "device.hpp"
+#include "errors.hpp"
+#include "event_listener.hpp"
 #include "execution.hpp"
+#include "hwmon.hpp"
 #include "logging.hpp"
+#include "metrics.hpp"
 #include "nvml.h"
 #include "nvml.hpp"
+#include "nvml_backend.hpp"
+#include "nvml_stats.hpp"
 #include "parameters.hpp"
 #include "parsing.hpp"
 #include "pid.hpp"
+#include "power_curve.hpp"
 #include "scope_guard.hpp"
 #include "signal.hpp"
 #include "slope.hpp"
+#include "spline.hpp"
+#include "temperature_filter.hpp"
+#include "utils.hpp"
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <cstdio>
 #include <exception>
+#include <iterator>
 #include <span>
+#include <string>
+#include <string_view>
 #include <system_error>
+#include <type_traits>
 #include <unistd.h>
 #include <vector>
 
-auto reset_fans(nvmlDevice_t device, unsigned int fan_count) noexcept -> void
+/* NOTE:
+ * The upper bound on the number of threads running the control loops. Any
+ * devices beyond this share the threads.
+ */
+constexpr std::size_t kMaxWorkThreads = 4;
+
+/* NOTE:
+ * The interval used for a device while it's in a thermal slowdown, so that
+ * the slowdown is followed closely until it clears
+ */
+constexpr auto kThrottledInterval = std::chrono::seconds(1);
+
+/* NOTE:
+ * The shortest time between two updates of a device that are triggered by
+ * its events. Clock events in particular can arrive in bursts.
+ */
+constexpr auto kMinWakeInterval = std::chrono::milliseconds(500);
+
+using clock_type = std::chrono::steady_clock;
+
+/* NOTE:
+ * Takes the curve rather than the device, because the curve holds the
+ * device's backend, whose handle changes if the device has been lost and
+ * re-acquired.
+ */
+template <gfc::FanControlBackend Backend>
+auto reset_fans(gfc::BasicCurve<Backend>& curve) noexcept -> void
 {
-    gfc::log(gfc::LogLevel::info, "Resetting fans to default state");
-    for (unsigned int i = 0; i < fan_count; ++i) {
-        try {
-            gfc::nvml::set_device_default_fan_speed(device, i);
+    gfc::log(gfc::LogLevel::info,
+             "Resetting GPU %u fans to default state",
+             curve.device_index);
+    for (unsigned int i = 0; i < curve.fans.size(); ++i) {
+        std::error_code ec {};
+        if (curve.backend.set_default_fan_speed(i, ec)) {
+            continue;
         }
-        catch (std::exception const& e) {
-            gfc::log(gfc::LogLevel::warn,
-                     "Couldn't reset fan %u to default: %s",
-                     i,
-                     e.what());
+
+        gfc::log(gfc::LogLevel::warn,
+                 "Couldn't reset GPU %u fan %u to default: %s",
+                 curve.device_index,
+                 i,
+                 Backend::error_string(ec));
+
+        /* NOTE:
+         * Don't hold up the shutdown waiting on the rest of a device that
+         * isn't responding
+         */
+        if (ec == gfc::ErrorCodes::nvml_call_timeout) {
+            return;
         }
     }
 }
 
+auto control_sensor(gfc::app::TemperatureSensor sensor) noexcept
+    -> gfc::ControlSensor
+{
+    switch (sensor) {
+    case gfc::app::TemperatureSensor::memory:
+        return gfc::ControlSensor::memory;
+    case gfc::app::TemperatureSensor::hottest:
+        return gfc::ControlSensor::hottest;
+    case gfc::app::TemperatureSensor::gpu:
+        break;
+    }
+
+    return gfc::ControlSensor::gpu;
+}
+
+auto temperature_filter(gfc::app::TemperatureFilter filter,
+                        unsigned int size) noexcept -> gfc::TemperatureFilter
+{
+    switch (filter) {
+    case gfc::app::TemperatureFilter::ema:
+        return gfc::EmaTemperatureFilter { size };
+    case gfc::app::TemperatureFilter::median:
+        return gfc::MedianTemperatureFilter { size };
+    case gfc::app::TemperatureFilter::none:
+        break;
+    }
+
+    return gfc::NoTemperatureFilter {};
+}
+
+/* NOTE:
+ * Whether a device's curve is the built-in one, unchanged by clamping it to
+ * the device, so that its table can be the one baked at build time
+ */
+auto is_builtin_curve(std::span<gfc::Slope const> slopes) noexcept -> bool
+{
+    auto const points = gfc::kBuiltinCurve.points.view();
+    if (!points.size() || slopes.size() != points.size() - 1) {
+        return false;
+    }
+
+    auto const same = [](gfc::CurvePoint const& a, gfc::CurvePoint const& b) {
+        return a.temperature == b.temperature && a.fan_speed == b.fan_speed;
+    };
+
+    for (std::size_t i = 0; i < slopes.size(); ++i) {
+        if (!same(slopes[i].start(), points[i]) ||
+            !same(slopes[i].end(), points[i + 1])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+auto speed_table(gfc::Parameters const& params,
+                 std::span<gfc::Slope const> slopes) -> gfc::FanSpeedTable
+{
+    return params.spline
+               ? gfc::spline_fan_speed_table(gfc::monotone_spline(slopes))
+               : gfc::fan_speed_table(slopes);
+}
+
+/* NOTE:
+ * `table` is the main curve's, for 0 W. The curve for each power is
+ * clamped to the device's fan speeds, and joined with a spline, in the same
+ * way as the main curve.
+ */
+auto power_curve(gfc::Parameters const& params,
+                 gfc::FanSpeedTable const& table,
+                 std::span<std::vector<gfc::Slope> const> power_slopes,
+                 gfc::DeviceCapabilities const& capabilities)
+    -> gfc::PowerCurve
+{
+    std::vector<gfc::PowerCurveRow> rows { gfc::PowerCurveRow { 0, table } };
+    rows.reserve(power_slopes.size() + 1);
+    for (std::size_t i = 0; i < power_slopes.size(); ++i) {
+        auto const slopes =
+            gfc::clamp_curve(std::span<gfc::Slope const> {
+                                 power_slopes[i].data(),
+                                 power_slopes[i].size() },
+                             capabilities);
+        rows.push_back(gfc::PowerCurveRow {
+            params.power_curves[i].power,
+            speed_table(params, { slopes.data(), slopes.size() }) });
+    }
+
+    return gfc::power_curve({ rows.data(), rows.size() });
+}
+
 template <typename Allocator>
 auto print_fan_curve(std::vector<gfc::Slope, Allocator> const& curve) -> void
 {
@@ -63,125 +210,338 @@ auto print_fan_curve(std::vector<gfc::Slope, Allocator> const& curve) -> void
     }
 }
 
-auto next_delay(auto const& elapsed, auto const& interval) noexcept
+auto print_fan_speed_table(std::span<std::uint8_t const> speeds) -> void
 {
-    if (elapsed > interval)
-        return interval - (elapsed % interval);
+    dprintf(STDOUT_FILENO, "temperature fan_speed\n");
+    for (std::size_t i = 0; i < speeds.size(); ++i) {
+        dprintf(STDOUT_FILENO, "%zu %u\n", i, speeds[i]);
+    }
+}
 
-    return interval - elapsed;
-};
+/* NOTE:
+ * Ticks are kept on a fixed grid of `interval` from the first tick. If the
+ * work overruns one or more intervals then the missed ticks are skipped
+ * rather than run back-to-back.
+ */
+auto next_tick(auto const& previous, auto const& now, auto const& interval)
+{
+    auto next = previous + interval;
+    if (next <= now) {
+        next += interval * ((now - next) / interval + 1);
+    }
 
-auto app(gfc::Parameters const& params) -> void
+    return next;
+}
+
+/* NOTE:
+ * Sets each curve's attack and release time constants. One given for a
+ * device, by a selector that `matches(curve, selector)`, overrides one for
+ * every device. Throws if a selector doesn't match any of the curves.
+ */
+template <gfc::FanControlBackend Backend, typename Matches>
+auto set_response_times(gfc::Parameters const& params,
+                        std::vector<gfc::BasicCurve<Backend>>& curves,
+                        Matches matches) -> void
 {
-    using namespace std::chrono_literals;
     namespace ch = std::chrono;
-    namespace ex = gfc::execution;
 
-    using clock_type = std::chrono::steady_clock;
+    auto const apply = [](gfc::BasicCurve<Backend>& curve,
+                          gfc::ResponseTime const& response_time) {
+        curve.response.attack = ch::seconds(response_time.attack);
+        curve.response.release = ch::seconds(response_time.release);
+    };
 
-    auto const slopes = gfc::parse_curve(params.curve_points_data,
-                                         gfc::CommaOrWhiteSpaceDelimiter {},
-                                         params.max_temperature);
+    for (auto const& response_time : params.response_times) {
+        if (response_time.selector.size()) {
+            continue;
+        }
 
-    if (params.mode == gfc::app::Mode::print_fan_curve) {
-        print_fan_curve(slopes);
-        return;
+        for (auto& curve : curves) {
+            apply(curve, response_time);
+        }
     }
 
-    if (params.use_pidfile) {
-        gfc::write_pid_file();
-    }
-    GFC_SCOPE_GUARD([&params] {
-        if (params.use_pidfile) {
-            gfc::remove_pid_file();
+    for (auto const& response_time : params.response_times) {
+        if (!response_time.selector.size()) {
+            continue;
         }
-    });
 
-    gfc::block_signals({ SIGINT, SIGTERM });
+        auto matched = false;
+        for (auto& curve : curves) {
+            if (matches(curve, response_time.selector)) {
+                apply(curve, response_time);
+                matched = true;
+            }
+        }
 
-    gfc::nvml::init();
-    GFC_SCOPE_GUARD([&] { gfc::nvml::shutdown(); });
+        if (!matched) {
+            throw std::runtime_error {
+                "No controlled device matches '" +
+                std::string { response_time.selector } + "'"
+            };
+        }
+    }
+}
 
-    auto const device_count = gfc::nvml::get_device_count();
+/* NOTE:
+ * Each device gets its own control loop, with its own curve state. The
+ * loops wait for their next tick on the (single) tick context, and then
+ * run the curve on the work pool. The pool is smaller than the number of
+ * devices on large systems, but has more than one thread whenever there
+ * is more than one device, so a slow driver call for one device doesn't
+ * hold up another device's tick. A loop's wait is cut short if its wake
+ * flag is set by one of its device's events.
+ */
+template <gfc::FanControlBackend Backend>
+struct ControlLoop
+{
+    gfc::BasicCurve<Backend> curve;
+    clock_type::time_point next_tick;
+    std::atomic_bool* wake;
+    clock_type::time_point next_update;
+};
 
-    if (device_count < 1) {
-        throw std::runtime_error { "No devices found" };
-    }
+/* NOTE:
+ * The part of the app that's the same for every backend. Runs the control
+ * loops until SIGINT or SIGTERM is received, calling `print_stats` whenever
+ * SIGUSR1 is received. Only NVML devices can wake their loops with events,
+ * so `event_devices` is empty for any other backend.
+ */
+template <gfc::FanControlBackend Backend, typename PrintStats>
+auto run(gfc::Parameters const& params,
+         std::vector<gfc::BasicCurve<Backend>> curves,
+         std::span<std::vector<gfc::Slope> const> power_slopes,
+         std::span<gfc::Device const> event_devices,
+         PrintStats print_stats_fn) -> void
+{
+    namespace ch = std::chrono;
+    namespace ex = gfc::execution;
 
-    gfc::log(gfc::LogLevel::info,
-             "Found %u GPU%s",
-             device_count,
-             (device_count > 1 ? "s" : ""));
+    std::vector<std::atomic_bool> wake_flags(curves.size());
 
-    auto device = gfc::nvml::get_device_handle_by_index(0);
+    std::vector<ControlLoop<Backend>> loops;
+    loops.reserve(curves.size());
+    for (std::size_t i = 0; i < curves.size(); ++i) {
+        auto const now = clock_type::now();
+        loops.push_back(ControlLoop<Backend> {
+            std::move(curves[i]), now, &wake_flags[i], now });
+    }
 
-    if (params.enable_persistence_mode) {
-        gfc::log(gfc::LogLevel::info, "Enabling persistence mode");
-        gfc::nvml::set_device_persistence_mode(device, NVML_FEATURE_ENABLED);
+    if (params.power_governor) {
+        for (auto& loop : loops) {
+            std::error_code ec {};
+            if (!loop.curve.enable_power_governor(ec)) {
+                gfc::log(gfc::LogLevel::warn,
+                         "GPU %u: Can't manage the power limit: %s",
+                         loop.curve.device_index,
+                         Backend::error_string(ec));
+            }
+        }
     }
 
-    auto const fan_count = gfc::nvml::get_device_fan_count(device);
-    if (fan_count < 1) {
-        throw std::runtime_error { "Device has no fans" };
+    for (auto& loop : loops) {
+        auto& hysteresis = loop.curve.hysteresis;
+        hysteresis.up = params.hysteresis_up;
+        hysteresis.down = params.hysteresis_down;
+        hysteresis.dwell = ch::seconds(params.dwell_time);
+        loop.curve.ramp.rate = params.slew_rate;
+        loop.curve.temperature_filter =
+            temperature_filter(params.temperature_filter,
+                               params.temperature_filter_size);
+
+        /* NOTE:
+         * The spline goes through the curve as it was clamped for the
+         * device
+         */
+        if (params.spline) {
+            loop.curve.speed_table = speed_table(params, loop.curve.slopes);
+        }
+        else if (is_builtin_curve(loop.curve.slopes)) {
+            loop.curve.speed_table.speeds.assign(
+                gfc::kBuiltinCurve.fan_speeds.begin(),
+                gfc::kBuiltinCurve.fan_speeds.end());
+        }
+
+        if (power_slopes.size()) {
+            loop.curve.power_curve = power_curve(params,
+                                                 loop.curve.speed_table,
+                                                 power_slopes,
+                                                 loop.curve.capabilities);
+            loop.curve.sensors.power_usage = true;
+        }
+
+        if (params.target_temperature) {
+            gfc::PidController pid {};
+            pid.setpoint = *params.target_temperature;
+            pid.gains = gfc::PidGains { params.pid_proportional_gain,
+                                        params.pid_integral_gain,
+                                        params.pid_derivative_gain };
+            loop.curve.pid = pid;
+        }
     }
 
-    gfc::log(gfc::LogLevel::info,
-             "Device has %u fan%s",
-             fan_count,
-             (fan_count > 1 ? "s" : ""));
+    GFC_SCOPE_GUARD([&] {
+        for (auto& loop : loops) {
+            reset_fans(loop.curve);
+            loop.curve.restore_power_limit();
+        }
+    });
 
-    GFC_SCOPE_GUARD([&] { reset_fans(device, fan_count); });
+    if (params.output_metrics) {
+        gfc::set_metrics_layout(loops.size() > 1
+                                    ? gfc::MetricsLayout::per_device
+                                    : gfc::MetricsLayout::single_device);
+        gfc::set_metrics_columns(gfc::MetricsColumns {
+            params.hysteresis_up || params.hysteresis_down ||
+                params.dwell_time,
+            params.temperature_filter != gfc::app::TemperatureFilter::none,
+            params.target_temperature.has_value() });
+        gfc::print_metrics_header();
+    }
 
-    gfc::execution::single_thread_context work_context;
-    gfc::execution::single_thread_context signal_context;
+    ex::timer_context tick_context;
+    ex::static_thread_pool work_pool;
+    ex::single_thread_context signal_context;
+    ex::single_thread_context stats_signal_context;
 
-    work_context.run();
+    tick_context.run();
+    work_pool.run(std::min(loops.size(), kMaxWorkThreads));
     signal_context.run();
+    stats_signal_context.run();
+
+    /* NOTE:
+     * With events enabled, the interval is the longest time between updates
+     * rather than the only trigger for them
+     */
+    gfc::EventListener event_listener;
+    std::vector<clock_type::time_point> last_wake(loops.size());
+    if (params.wake_on_events && event_devices.size() &&
+        !event_listener.start(event_devices, [&](std::size_t i) {
+            auto const now = clock_type::now();
+            if (now - last_wake[i] < kMinWakeInterval) {
+                return;
+            }
+            last_wake[i] = now;
+            tick_context.wake(wake_flags[i]);
+        })) {
+        gfc::log(gfc::LogLevel::warn,
+                 "No GPU reports clock or power events. Updating on the "
+                 "interval only");
+    }
 
     GFC_SCOPE_GUARD([&] {
+        event_listener.stop();
+        stats_signal_context.stop();
         signal_context.stop();
-        work_context.stop();
+        work_pool.stop();
+        tick_context.stop();
     });
 
-    auto work_start = clock_type::now();
+    auto const interval = ch::milliseconds(params.interval_length * 1000);
 
     // clang-format off
-    auto work = ex::stop_when(
+    auto control_loop = [&](ControlLoop<Backend>& loop) {
         /* NOTE:
          * Loop:
-         * - Record the current loop start time
-         * - Schedule execution onto the work thread context
+         * - Wait on the tick context until the next tick is due
+         * - Schedule execution onto the work pool
          * - Execute the curve function
-         * - Delay the loop for the remainder of the interval
+         * - Calculate the next tick
          * - Repeat forever
          */
-        ex::repeat_effect(
+        return ex::repeat_effect(
             ex::then(
-                ex::just_from([&] { work_start = clock_type::now(); }),
+                ex::defer([&] {
+                    return ex::schedule_at(get_scheduler(tick_context),
+                                           loop.next_tick,
+                                           *loop.wake);
+                }),
                 ex::then(
-                    ex::schedule(get_scheduler(work_context)),
-                    ex::then(
-                        ex::just_from(
-                            gfc::curve(device,
-                                       fan_count,
-                                       std::span<gfc::Slope const> {
-                                           slopes.data(),
-                                           slopes.size()
-                                       },
-                                       params.output_metrics)
-                        ),
-                        ex::defer([&] {
-                            return ex::schedule_after(
-                                ex::inline_delay_scheduler {},
-                                next_delay(
-                                    clock_type::now() - work_start,
-                                    ch::milliseconds(params.interval_length * 1000))
-                            );
-                        })
-                    )
+                    ex::schedule(get_scheduler(work_pool)),
+                    ex::just_from([&] {
+                        /* NOTE:
+                         * A tick between updates only moves the fans along
+                         * their ramp. Waking up early for an event is
+                         * always a full update.
+                         */
+                        auto now = clock_type::now();
+                        auto const ramp_step = now >= loop.next_tick &&
+                                               now < loop.next_update;
+                        if (ramp_step) {
+                            loop.curve.step_ramp();
+                        }
+                        else {
+                            auto const recovering =
+                                loop.curve.recovery.active;
+                            loop.curve();
+
+                            /* NOTE:
+                             * A device that's been re-acquired has to be
+                             * registered for events again
+                             */
+                            if constexpr (std::is_same_v<Backend,
+                                                         gfc::NvmlBackend>) {
+                                if (recovering &&
+                                    !loop.curve.recovery.active) {
+                                    event_listener.refresh(
+                                        static_cast<std::size_t>(
+                                            &loop - loops.data()),
+                                        loop.curve.backend.handle);
+                                }
+                            }
+
+                            now = clock_type::now();
+                            auto const period =
+                                loop.curve.throttling.active
+                                    ? ch::duration_cast<ch::milliseconds>(
+                                          kThrottledInterval)
+                                    : interval;
+
+                            /* NOTE:
+                             * After an early wake-up, the grid starts again
+                             * from now
+                             */
+                            loop.next_update =
+                                now < loop.next_update
+                                    ? now + period
+                                    : next_tick(loop.next_update, now, period);
+                        }
+
+                        loop.next_tick = loop.next_update;
+                        if (loop.curve.ramp.active) {
+                            loop.next_tick = std::min(
+                                loop.next_tick,
+                                now + ch::duration_cast<clock_type::duration>(
+                                          loop.curve.ramp_step_period()));
+                        }
+                    })
                 )
             )
-        ),
+        );
+    };
+
+    std::vector<decltype(control_loop(loops.front()))> control_loops;
+    control_loops.reserve(loops.size());
+    for (auto& loop : loops) {
+        control_loops.push_back(control_loop(loop));
+    }
+
+    /* NOTE:
+     * Print the stats whenever SIGUSR1 is received, until stopped
+     */
+    auto print_stats = ex::repeat_effect(
+        ex::then(
+            ex::schedule(get_scheduler(stats_signal_context)),
+            ex::then(
+                ex::schedule(ex::inline_signal_scheduler(SIGUSR1)),
+                ex::just_from([&] { print_stats_fn(); })
+            )
+        )
+    );
+
+    auto work = ex::stop_when(
+        ex::stop_when(ex::when_all(std::move(control_loops)),
+                      std::move(print_stats)),
         /* NOTE:
          * Stop condition:
          * - Schedule signal handler execution onto the signal thread context
@@ -204,6 +564,282 @@ auto app(gfc::Parameters const& params) -> void
     gfc::log(gfc::LogLevel::info, "Stopped");
 }
 
+auto app_nvml(gfc::Parameters const& params,
+              std::vector<gfc::Slope> const& slopes,
+              std::span<std::vector<gfc::Slope> const> power_slopes) -> void
+{
+    namespace ch = std::chrono;
+
+    if (params.nvml_library.size()) {
+        gfc::nvml::set_library_path(params.nvml_library);
+    }
+
+    if (params.nvml_timeout) {
+        gfc::nvml::set_call_timeout(ch::milliseconds(*params.nvml_timeout));
+    }
+
+    gfc::nvml::init();
+    GFC_SCOPE_GUARD([&] { gfc::nvml::shutdown(); });
+
+    /* NOTE:
+     * The NVML call stats are printed on exit, and whenever SIGUSR1 is
+     * received. They go along with the metrics if they're enabled.
+     */
+    auto const stats_fd =
+        params.output_metrics ? STDOUT_FILENO : STDERR_FILENO;
+    GFC_SCOPE_GUARD([&] { gfc::nvml::print_call_stats(stats_fd); });
+
+    auto devices = gfc::enumerate_devices();
+
+    if (devices.size() < 1) {
+        throw std::runtime_error { "No devices with fans found" };
+    }
+
+    /* NOTE:
+     * With `--device`, only the selected devices are controlled, each with
+     * its own curve if one was given. Devices are resolved to handles once,
+     * here, and again only if they're lost.
+     */
+    std::vector<std::vector<gfc::Slope>> selected_slopes;
+    if (params.devices.size()) {
+        std::vector<std::string_view> selectors;
+        selectors.reserve(params.devices.size());
+        selected_slopes.reserve(params.devices.size());
+        for (auto const device : params.devices) {
+            auto const sep = device.find('=');
+            selectors.push_back(device.substr(0, sep));
+            selected_slopes.push_back(
+                sep == std::string_view::npos
+                    ? slopes
+                    : gfc::parse_curve(device.substr(sep + 1),
+                                       gfc::CommaOrWhiteSpaceDelimiter {},
+                                       params.max_temperature));
+        }
+
+        devices = gfc::select_devices(
+            std::span<gfc::Device const> { devices.data(), devices.size() },
+            std::span<std::string_view const> { selectors.data(),
+                                                selectors.size() });
+    }
+
+    gfc::log(gfc::LogLevel::info,
+             "Controlling %zu GPU%s",
+             devices.size(),
+             (devices.size() > 1 ? "s" : ""));
+
+    if (params.enable_persistence_mode) {
+        for (auto const& device : devices) {
+            gfc::log(gfc::LogLevel::info,
+                     "Enabling persistence mode on GPU %u",
+                     device.index);
+            gfc::nvml::set_device_persistence_mode(device.handle,
+                                                   NVML_FEATURE_ENABLED);
+        }
+    }
+
+    /* NOTE:
+     * Each device gets its own copy of the curve, clamped to the fan speeds
+     * that the device accepts
+     */
+    std::vector<std::vector<gfc::Slope>> device_slopes;
+    device_slopes.reserve(devices.size());
+    for (std::size_t i = 0; i < devices.size(); ++i) {
+        auto const& device = devices[i];
+        auto const& curve_slopes =
+            selected_slopes.size() ? selected_slopes[i] : slopes;
+        device_slopes.push_back(gfc::clamp_curve(
+            std::span<gfc::Slope const> { curve_slopes.data(),
+                                          curve_slopes.size() },
+            device.capabilities));
+
+        auto const slowdown_temperature =
+            device.capabilities.slowdown_temperature;
+        if (slowdown_temperature && curve_slopes.size() &&
+            curve_slopes.back().end().temperature >= slowdown_temperature) {
+            gfc::log(gfc::LogLevel::warn,
+                     "GPU %u slows down at %uC, before the end of the fan "
+                     "curve at %uC",
+                     device.index,
+                     slowdown_temperature,
+                     curve_slopes.back().end().temperature);
+        }
+    }
+
+    std::vector<gfc::Curve> curves;
+    curves.reserve(devices.size());
+    for (std::size_t i = 0; i < devices.size(); ++i) {
+        curves.push_back(
+            gfc::curve(devices[i],
+                       std::span<gfc::Slope const> { device_slopes[i].data(),
+                                                     device_slopes[i].size() },
+                       params.output_metrics,
+                       params.closed_loop,
+                       control_sensor(params.temperature_sensor)));
+    }
+
+    set_response_times(
+        params, curves, [&](gfc::Curve const& curve, auto selector) {
+            auto const& device = *std::find_if(
+                devices.begin(), devices.end(), [&](auto const& candidate) {
+                    return candidate.index == curve.device_index;
+                });
+            return gfc::matches_device(device, selector);
+        });
+
+    run(params, std::move(curves), power_slopes, devices, [&] {
+        gfc::nvml::print_call_stats(stats_fd);
+    });
+}
+
+auto app_hwmon(gfc::Parameters const& params,
+               std::vector<gfc::Slope> const& slopes,
+               std::span<std::vector<gfc::Slope> const> power_slopes) -> void
+{
+    std::vector<std::string> paths;
+    gfc::split(params.hwmon_paths.begin(),
+               params.hwmon_paths.end(),
+               std::back_inserter(paths),
+               ',',
+               [](auto first, auto last) {
+                   return std::string { first, last };
+               });
+
+    std::vector<gfc::BasicCurve<gfc::HwmonBackend>> curves;
+    for (unsigned int i = 0; i < paths.size(); ++i) {
+        gfc::HwmonBackend backend { paths[i] };
+        std::error_code ec {};
+        if (!backend.open(ec)) {
+            gfc::log(gfc::LogLevel::warn,
+                     "Couldn't open GPU %u (%s): %s. Skipping",
+                     i,
+                     paths[i].c_str(),
+                     gfc::HwmonBackend::error_string(ec));
+            continue;
+        }
+
+        if (backend.fan_count() < 1) {
+            gfc::log(gfc::LogLevel::warn,
+                     "GPU %u (%s) has no fans. Skipping",
+                     i,
+                     paths[i].c_str());
+            continue;
+        }
+
+        gfc::log(gfc::LogLevel::info,
+                 "GPU %u (%s) has %u fan%s",
+                 i,
+                 paths[i].c_str(),
+                 backend.fan_count(),
+                 (backend.fan_count() > 1 ? "s" : ""));
+
+        curves.push_back(gfc::curve(
+            std::move(backend),
+            i,
+            gfc::DeviceCapabilities {},
+            std::span<gfc::Slope const> { slopes.data(), slopes.size() },
+            params.output_metrics,
+            params.closed_loop,
+            control_sensor(params.temperature_sensor)));
+    }
+
+    if (curves.size() < 1) {
+        throw std::runtime_error { "No devices with fans found" };
+    }
+
+    set_response_times(
+        params,
+        curves,
+        [](gfc::BasicCurve<gfc::HwmonBackend> const& curve, auto selector) {
+            return curve.backend.path == selector;
+        });
+
+    if (params.wake_on_events) {
+        gfc::log(gfc::LogLevel::warn,
+                 "hwmon devices don't report events. Updating on the "
+                 "interval only");
+    }
+
+    run(params, std::move(curves), power_slopes, {}, [] {});
+}
+
+auto app(gfc::Parameters const& params) -> void
+{
+    /* NOTE:
+     * A curve built in at compile time has already been parsed and
+     * validated, and its table is already built
+     */
+    auto const use_builtin_curve = !params.curve_points_data.size() &&
+                                   gfc::kBuiltinCurve.points.size;
+
+    auto const slopes =
+        use_builtin_curve
+            ? gfc::baked_slopes(gfc::kBuiltinCurve)
+            : gfc::parse_curve(params.curve_points_data,
+                               gfc::CommaOrWhiteSpaceDelimiter {},
+                               params.max_temperature);
+
+    if (params.mode == gfc::app::Mode::print_fan_curve) {
+        auto const curve_slopes =
+            std::span<gfc::Slope const> { slopes.data(), slopes.size() };
+        if (params.print_fan_speed_table && params.spline) {
+            auto const table = gfc::spline_fan_speed_table(
+                gfc::monotone_spline(curve_slopes));
+            print_fan_speed_table(table.speeds);
+        }
+        else if (params.print_fan_speed_table && use_builtin_curve) {
+            print_fan_speed_table(gfc::kBuiltinCurve.fan_speeds);
+        }
+        else if (params.print_fan_speed_table) {
+            auto const table = gfc::fan_speed_table(curve_slopes);
+            print_fan_speed_table(table.speeds);
+        }
+        else {
+            print_fan_curve(slopes);
+        }
+        return;
+    }
+
+    /* NOTE:
+     * The power curves are checked against the main curve here, before
+     * taking over any fans. A device with its own curve is checked again
+     * when its loop is set up.
+     */
+    std::vector<std::vector<gfc::Slope>> power_slopes;
+    power_slopes.reserve(params.power_curves.size());
+    for (auto const& power_curve_points : params.power_curves) {
+        power_slopes.push_back(
+            gfc::parse_curve(power_curve_points.curve_points_data,
+                             gfc::CommaOrWhiteSpaceDelimiter {},
+                             params.max_temperature));
+    }
+
+    if (power_slopes.size()) {
+        static_cast<void>(power_curve(
+            params,
+            speed_table(params, { slopes.data(), slopes.size() }),
+            power_slopes,
+            gfc::DeviceCapabilities {}));
+    }
+
+    if (params.use_pidfile) {
+        gfc::write_pid_file();
+    }
+    GFC_SCOPE_GUARD([&params] {
+        if (params.use_pidfile) {
+            gfc::remove_pid_file();
+        }
+    });
+
+    gfc::block_signals({ SIGINT, SIGTERM, SIGUSR1 });
+
+    if (params.hwmon_paths.size()) {
+        app_hwmon(params, slopes, power_slopes);
+    }
+    else {
+        app_nvml(params, slopes, power_slopes);
+    }
+}
+
 /*
  * Argument is a comma separated list of temp./speed pairs, in the format of
  * `<TEMP>:<SPEED>`. E.g. 35:30,60:70
@@ -253,7 +889,9 @@ auto main(int argc, char const** argv) -> int
                 "  %s [ OPTION... ] [ <FAN CURVE DEFINITION> ]\n",
                 argv[0]);
         dprintf(STDOUT_FILENO, "  %s -v | --version\n", argv[0]);
-        dprintf(STDOUT_FILENO, "  %s -p | --print-fan-curve\n", argv[0]);
+        dprintf(STDOUT_FILENO,
+                "  %s -p | --print-fan-curve [ --table [ --spline ] ]\n",
+                argv[0]);
         dprintf(STDOUT_FILENO, "\n");
         gfc::print_flag_defs(std::span { gfc::cmdline::flag_defs,
                                          std::size(gfc::cmdline::flag_defs) });
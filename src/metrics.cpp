@@ -0,0 +1,155 @@
+#include "metrics.hpp"
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <unistd.h>
+
+namespace
+{
+auto metrics_layout() noexcept -> std::atomic<gfc::MetricsLayout>&
+{
+    static std::atomic<gfc::MetricsLayout> val =
+        gfc::MetricsLayout::single_device;
+    return val;
+}
+
+struct OptionalColumns
+{
+    std::atomic<bool> fan_writes { false };
+    std::atomic<bool> raw_temperature { false };
+    std::atomic<bool> pid_terms { false };
+};
+
+auto metrics_columns() noexcept -> OptionalColumns&
+{
+    static OptionalColumns val {};
+    return val;
+}
+
+using Column = std::array<char, 16>;
+
+auto format_column(std::optional<unsigned int> const& value) noexcept -> Column
+{
+    Column column { '-' };
+    if (value) {
+        std::snprintf(column.data(), column.size(), "%u", *value);
+    }
+    return column;
+}
+
+using OptionalColumn = std::array<char, 64>;
+
+/* NOTE:
+ * Each of these is empty if its columns aren't printed, and otherwise starts
+ * with the space that separates it from the column before
+ */
+auto format_write_counts(gfc::MetricsRecord const& record) noexcept
+    -> OptionalColumn
+{
+    OptionalColumn columns {};
+    if (metrics_columns().fan_writes) {
+        std::snprintf(
+            columns.data(),
+            columns.size(),
+            " %llu %llu",
+            static_cast<unsigned long long>(record.fan_writes),
+            static_cast<unsigned long long>(record.unbanded_fan_writes));
+    }
+    return columns;
+}
+
+auto format_raw_temperature(gfc::MetricsRecord const& record) noexcept
+    -> OptionalColumn
+{
+    OptionalColumn column {};
+    if (metrics_columns().raw_temperature) {
+        std::snprintf(
+            column.data(), column.size(), " %u", record.raw_temperature);
+    }
+    return column;
+}
+
+auto format_terms(std::optional<gfc::PidTerms> const& terms) noexcept
+    -> OptionalColumn
+{
+    OptionalColumn columns {};
+    if (!metrics_columns().pid_terms) {
+        return columns;
+    }
+
+    columns = { ' ', '-', ' ', '-', ' ', '-' };
+    if (terms) {
+        std::snprintf(columns.data(),
+                      columns.size(),
+                      " %.2f %.2f %.2f",
+                      terms->proportional,
+                      terms->integral,
+                      terms->derivative);
+    }
+    return columns;
+}
+} // namespace
+
+namespace gfc
+{
+auto set_metrics_layout(MetricsLayout layout) noexcept -> void
+{
+    metrics_layout() = layout;
+}
+
+auto set_metrics_columns(MetricsColumns const& columns) noexcept -> void
+{
+    metrics_columns().fan_writes = columns.fan_writes;
+    metrics_columns().raw_temperature = columns.raw_temperature;
+    metrics_columns().pid_terms = columns.pid_terms;
+}
+
+auto print_metrics_header() noexcept -> void
+{
+    auto const& columns = metrics_columns();
+    dprintf(STDOUT_FILENO,
+            "seconds%s temperature fan_speed memory_temperature power%s%s%s\n",
+            metrics_layout() == MetricsLayout::per_device ? " device" : "",
+            columns.fan_writes ? " fan_writes unbanded_fan_writes" : "",
+            columns.raw_temperature ? " raw_temperature" : "",
+            columns.pid_terms ? " pid_p pid_i pid_d" : "");
+}
+
+auto print_metrics(MetricsRecord const& record) noexcept -> void
+{
+    auto const memory_temperature = format_column(record.memory_temperature);
+    auto const power = format_column(
+        record.power_usage
+            ? std::optional<unsigned int> { (*record.power_usage + 500) / 1000 }
+            : std::nullopt);
+    auto const write_counts = format_write_counts(record);
+    auto const raw_temperature = format_raw_temperature(record);
+    auto const terms = format_terms(record.pid_terms);
+
+    if (metrics_layout() == MetricsLayout::per_device) {
+        dprintf(STDOUT_FILENO,
+                "%lld %u %u %u %s %s%s%s%s\n",
+                static_cast<long long>(record.elapsed.count()),
+                record.device_index,
+                record.temperature,
+                record.fan_speed,
+                memory_temperature.data(),
+                power.data(),
+                write_counts.data(),
+                raw_temperature.data(),
+                terms.data());
+    }
+    else {
+        dprintf(STDOUT_FILENO,
+                "%lld %u %u %s %s%s%s%s\n",
+                static_cast<long long>(record.elapsed.count()),
+                record.temperature,
+                record.fan_speed,
+                memory_temperature.data(),
+                power.data(),
+                write_counts.data(),
+                raw_temperature.data(),
+                terms.data());
+    }
+}
+} // namespace gfc
@@ -0,0 +1,62 @@
+#ifndef GPUFANCTL_METRICS_HPP_INCLUDED
+#define GPUFANCTL_METRICS_HPP_INCLUDED
+
+#include "pid_controller.hpp"
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+namespace gfc
+{
+
+enum class MetricsLayout
+{
+    single_device,
+    per_device,
+};
+
+struct MetricsRecord
+{
+    std::chrono::seconds elapsed;
+    unsigned int device_index;
+    unsigned int temperature;
+    unsigned int fan_speed;
+    std::optional<unsigned int> memory_temperature {};
+    std::optional<unsigned int> power_usage {};
+    std::uint64_t fan_writes { 0 };
+    std::uint64_t unbanded_fan_writes { 0 };
+    unsigned int raw_temperature { 0 };
+    std::optional<PidTerms> pid_terms {};
+};
+
+/* NOTE:
+ * With the `per_device` layout, each record is prefixed with the index of the
+ * device it was sampled from, so that the output of several concurrent
+ * control loops can be separated again. The memory temperature and power
+ * usage (in watts) are printed as `-` if the device doesn't report them.
+ * `temperature` is the one that drives the curve, after any filtering.
+ */
+auto set_metrics_layout(MetricsLayout layout) noexcept -> void;
+
+/* NOTE:
+ * The columns that are only printed when their feature is in use, after the
+ * fixed ones and in this order. The fan write counts are totals since
+ * startup, `raw_temperature` is the temperature as sampled, and the PID
+ * controller's proportional, integral and derivative terms are in percent of
+ * fan speed.
+ */
+struct MetricsColumns
+{
+    bool fan_writes { false };
+    bool raw_temperature { false };
+    bool pid_terms { false };
+};
+
+auto set_metrics_columns(MetricsColumns const& columns) noexcept -> void;
+
+auto print_metrics_header() noexcept -> void;
+
+auto print_metrics(MetricsRecord const& record) noexcept -> void;
+
+} // namespace gfc
+#endif // GPUFANCTL_METRICS_HPP_INCLUDED
@@ -1,28 +1,422 @@
 #include "nvml.hpp"
 #include "dlfcn.h"
+#include "errors.hpp"
+#include "logging.hpp"
 #include "nvml.h"
+#include "nvml_stats.hpp"
 #include "symbol.hpp"
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <new>
 #include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
 
-#define CHECK_NVML_RESULT(op, msg)                                             \
-    do {                                                                       \
-        if (auto const result = (op); result != NVML_SUCCESS) {                \
-            throw std::runtime_error { std::string { msg } + ": " +            \
-                                       ::gfc::nvml::lib().nvmlErrorString(     \
-                                           result) };                          \
-        }                                                                      \
-    }                                                                          \
-    while (0)
+namespace
+{
+constexpr char const* kDefaultLibraryName = "libnvidia-ml.so.1";
+constexpr char const* kLibraryPathEnvVar = "GPUFANCTL_NVML_LIBRARY";
+
+/* NOTE:
+ * The upper bound on the number of threads making NVML calls. A thread
+ * that is stuck in a hung driver call stays unavailable until the call
+ * returns (if it ever does), so once this many threads are stuck every call
+ * will time out without being made.
+ */
+constexpr std::size_t kMaxCallThreads = 8;
+
+/* NOTE:
+ * The upper bound on the number of calls that are queued, running, or have
+ * been abandoned but not yet returned. Calls beyond this time out
+ * immediately.
+ */
+constexpr std::size_t kMaxPendingCalls = 32;
+
+/* NOTE:
+ * The space in each pending call for the function and its output. This is
+ * checked at compile time for each call. The largest output is the batch of
+ * field values read by `sample_device()`.
+ */
+constexpr std::size_t kCallStorageSize = 128;
+
+/* NOTE:
+ * The most fields that `sample_device()` reads in one call
+ */
+constexpr std::size_t kMaxSampleFields = 2;
+
+auto library_path_override() noexcept -> std::string&
+{
+    static std::string path {};
+    return path;
+}
+
+auto library_path() -> std::string
+{
+    if (library_path_override().size()) {
+        return library_path_override();
+    }
+
+    if (char const* path = std::getenv(kLibraryPathEnvVar); path && *path) {
+        return path;
+    }
+
+    return kDefaultLibraryName;
+}
+
+auto call_timeout() noexcept -> std::atomic<std::chrono::milliseconds::rep>&
+{
+    static std::atomic<std::chrono::milliseconds::rep> timeout {
+        gfc::nvml::kDefaultCallTimeout.count()
+    };
+    return timeout;
+}
+
+struct NvmlErrorCategory : std::error_category
+{
+    auto name() const noexcept -> char const* override
+    {
+        return "gfc::nvml::NvmlErrorCategory";
+    }
+
+    auto message(int condition) const -> std::string override
+    {
+        return gfc::nvml::error_string(
+            std::error_code { condition, gfc::nvml::nvml_category() });
+    }
+};
+
+enum class CallState : std::uint8_t
+{
+    free,
+    queued,
+    running,
+    complete,
+    abandoned,
+};
+
+struct PendingCall
+{
+    using invoke_fn = auto (*)(PendingCall&) noexcept -> void;
+
+    invoke_fn invoke { nullptr };
+    gfc::nvml::EntryPoint entry_point {};
+    nvmlReturn_t result { NVML_SUCCESS };
+    CallState state { CallState::free };
+    PendingCall* next { nullptr };
+    alignas(std::max_align_t) std::byte storage[kCallStorageSize];
+};
+
+template <typename F, typename T>
+struct CallPayload
+{
+    F fn;
+    T output;
+};
+
+struct CallThreads
+{
+    std::mutex mutex;
+    std::condition_variable work_available;
+    std::condition_variable call_complete;
+    std::array<PendingCall, kMaxPendingCalls> calls {};
+    PendingCall* head { nullptr };
+    PendingCall* tail { nullptr };
+    std::size_t queued { 0 };
+    std::size_t idle { 0 };
+    std::size_t count { 0 };
+};
+
+/* NOTE:
+ * The threads are detached, and may still be blocked in a driver call when
+ * the process exits, so this is intentionally never destroyed.
+ */
+auto call_threads() noexcept -> CallThreads&
+{
+    static CallThreads& threads = *new CallThreads {};
+    return threads;
+}
+
+template <typename T, typename F>
+auto timed_call(gfc::nvml::EntryPoint entry_point, F& fn, T& output) noexcept
+    -> nvmlReturn_t
+{
+    auto const start = std::chrono::steady_clock::now();
+    auto const result = fn(output);
+    gfc::nvml::record_call(
+        entry_point, std::chrono::steady_clock::now() - start, result);
+    return result;
+}
+
+template <typename F, typename T>
+auto payload(PendingCall& pending) noexcept -> CallPayload<F, T>&
+{
+    return *std::launder(
+        reinterpret_cast<CallPayload<F, T>*>(pending.storage));
+}
+
+template <typename F, typename T>
+auto invoke_pending(PendingCall& pending) noexcept -> void
+{
+    auto& p = payload<F, T>(pending);
+    pending.result = timed_call(pending.entry_point, p.fn, p.output);
+}
+
+auto run_call_thread(CallThreads& threads) noexcept -> void
+{
+    std::unique_lock lock { threads.mutex };
+    while (true) {
+        ++threads.idle;
+        threads.work_available.wait(lock,
+                                    [&] { return threads.head != nullptr; });
+        --threads.idle;
+
+        auto& pending = *threads.head;
+        threads.head = pending.next;
+        if (!threads.head) {
+            threads.tail = nullptr;
+        }
+        pending.next = nullptr;
+        --threads.queued;
+
+        if (pending.state == CallState::abandoned) {
+            pending.state = CallState::free;
+            continue;
+        }
+
+        pending.state = CallState::running;
+        lock.unlock();
+        pending.invoke(pending);
+        lock.lock();
+
+        /* NOTE:
+         * The slot can be reused as soon as it's free, so the entry point
+         * is copied out first. Nothing is logged with the mutex held, as
+         * that would hold up the callers waiting on their deadlines.
+         */
+        if (pending.state == CallState::abandoned) {
+            auto const entry_point = pending.entry_point;
+            pending.state = CallState::free;
+            lock.unlock();
+            gfc::log(gfc::LogLevel::warn,
+                     "%s returned after its deadline",
+                     gfc::nvml::entry_point_name(entry_point));
+            lock.lock();
+            continue;
+        }
+
+        pending.state = CallState::complete;
+        threads.call_complete.notify_all();
+    }
+}
+
+/* NOTE:
+ * Must be called with `threads.mutex` held. Fails with an empty `ec` if
+ * every thread has already been started. Either way, the call will time out
+ * unless one of the existing threads becomes available in time. The caller
+ * logs the failure once it has released the mutex.
+ */
+auto start_call_thread_if_needed(CallThreads& threads,
+                                 std::error_code& ec) noexcept -> bool
+{
+    if (threads.idle >= threads.queued) {
+        return true;
+    }
+
+    if (threads.count == kMaxCallThreads) {
+        return false;
+    }
+
+    try {
+        std::thread { run_call_thread, std::ref(threads) }.detach();
+        threads.count += 1;
+    }
+    catch (std::system_error const& e) {
+        ec = e.code();
+        return false;
+    }
+    catch (...) {
+        ec = std::make_error_code(std::errc::not_enough_memory);
+        return false;
+    }
+
+    return true;
+}
+
+auto log_call_thread_failure(std::error_code const& ec) noexcept -> void
+{
+    if (!ec) {
+        gfc::log(gfc::LogLevel::warn, "No NVML call threads available");
+        return;
+    }
+
+    gfc::log(gfc::LogLevel::warn,
+             "Couldn't start an NVML call thread: %s",
+             gfc::error_message(ec));
+}
+
+auto check_result(nvmlReturn_t result, std::error_code& ec) noexcept -> bool
+{
+    if (result != NVML_SUCCESS) {
+        ec = gfc::nvml::make_error_code(result);
+        return false;
+    }
+
+    return true;
+}
+
+auto timed_out(gfc::nvml::EntryPoint entry_point, std::error_code& ec) noexcept
+    -> bool
+{
+    gfc::nvml::record_timeout(entry_point);
+    ec = gfc::make_error_code(gfc::ErrorCodes::nvml_call_timeout);
+    return false;
+}
+
+/* NOTE:
+ * Makes an NVML call without throwing or allocating. `fn` receives a `T&` to
+ * write its output to, and returns the NVML result. The call is recorded in
+ * the stats for `entry_point`.
+ *
+ * Unless the call timeout is zero, the call is made on one of the NVML call
+ * threads, and fails with `ErrorCodes::nvml_call_timeout` if it hasn't
+ * returned by the deadline. The call may still be running after this has
+ * returned, so `fn` and `T` are copied into the pending call, and must be
+ * trivially copyable.
+ */
+template <typename T, typename F>
+auto call(gfc::nvml::EntryPoint entry_point,
+          F fn,
+          T& output,
+          std::error_code& ec) noexcept -> bool
+{
+    using Payload = CallPayload<F, T>;
+    static_assert(std::is_trivially_copyable_v<Payload>);
+    static_assert(sizeof(Payload) <= kCallStorageSize);
+    static_assert(alignof(Payload) <= alignof(std::max_align_t));
+
+    auto const timeout = std::chrono::milliseconds { call_timeout() };
+    if (timeout.count() == 0) {
+        return check_result(timed_call(entry_point, fn, output), ec);
+    }
+
+    auto const deadline = std::chrono::steady_clock::now() + timeout;
+    auto& threads = call_threads();
+    std::unique_lock lock { threads.mutex };
+
+    PendingCall* pending = nullptr;
+    for (auto& c : threads.calls) {
+        if (c.state == CallState::free) {
+            pending = &c;
+            break;
+        }
+    }
+
+    if (!pending) {
+        return timed_out(entry_point, ec);
+    }
+
+    new (pending->storage) Payload { fn, output };
+    pending->invoke = &invoke_pending<F, T>;
+    pending->entry_point = entry_point;
+    pending->state = CallState::queued;
+    if (threads.tail) {
+        threads.tail->next = pending;
+    }
+    else {
+        threads.head = pending;
+    }
+    threads.tail = pending;
+    threads.queued += 1;
+
+    std::error_code thread_ec {};
+    auto const thread_started = start_call_thread_if_needed(threads, thread_ec);
+    threads.work_available.notify_one();
+    if (!thread_started) {
+        lock.unlock();
+        log_call_thread_failure(thread_ec);
+        lock.lock();
+    }
+
+    if (!threads.call_complete.wait_until(lock, deadline, [&] {
+            return pending->state == CallState::complete;
+        })) {
+        pending->state = CallState::abandoned;
+        return timed_out(entry_point, ec);
+    }
+
+    output = payload<F, T>(*pending).output;
+    auto const result = pending->result;
+    pending->state = CallState::free;
+    lock.unlock();
+
+    return check_result(result, ec);
+}
+
+struct NoOutput
+{
+};
+
+auto is_unsupported(std::error_code const& ec) noexcept -> bool
+{
+    return ec == gfc::nvml::make_error_code(NVML_ERROR_NOT_SUPPORTED) ||
+           ec == gfc::nvml::make_error_code(NVML_ERROR_FUNCTION_NOT_FOUND);
+}
+
+auto field_value(nvmlFieldValue_t const& field) noexcept -> unsigned int
+{
+    switch (field.valueType) {
+    case NVML_VALUE_TYPE_DOUBLE:
+        return static_cast<unsigned int>(field.value.dVal);
+    case NVML_VALUE_TYPE_UNSIGNED_LONG:
+        return static_cast<unsigned int>(field.value.ulVal);
+    case NVML_VALUE_TYPE_UNSIGNED_LONG_LONG:
+        return static_cast<unsigned int>(field.value.ullVal);
+    case NVML_VALUE_TYPE_SIGNED_LONG_LONG:
+        return static_cast<unsigned int>(field.value.sllVal);
+    case NVML_VALUE_TYPE_SIGNED_INT:
+        return static_cast<unsigned int>(field.value.siVal);
+    default:
+        break;
+    }
+
+    return field.value.uiVal;
+}
+
+template <typename T, typename F>
+auto call_or_throw(gfc::nvml::EntryPoint entry_point, F fn) -> T
+{
+    T output {};
+    std::error_code ec {};
+    if (!call(entry_point, fn, output, ec)) {
+        throw std::system_error { ec,
+                                  gfc::nvml::entry_point_name(entry_point) };
+    }
+
+    return output;
+}
+} // namespace
 
 namespace gfc::nvml
 {
+auto set_library_path(std::string_view path) -> void
+{
+    library_path_override() = std::string { path };
+}
+
 auto load_nvml() -> NVML
 {
-    auto lib = dlopen("libnvidia-ml.so.1", RTLD_LAZY);
+    auto const path = library_path();
+    auto lib = dlopen(path.c_str(), RTLD_LAZY);
     if (!lib) {
-        throw std::runtime_error {
-            std::string { "Couldn't load libnvidia-ml.so.1: " } + dlerror()
-        };
+        throw std::runtime_error { "Couldn't load " + path + ": " + dlerror() };
     }
     NVML nvml {};
     TRY_ATTACH_SYMBOL(&nvml.nvmlInit_v2, "nvmlInit_v2", lib);
@@ -44,6 +438,44 @@ auto load_nvml() -> NVML
     TRY_ATTACH_SYMBOL(&nvml.nvmlDeviceSetPersistenceMode,
                       "nvmlDeviceSetPersistenceMode",
                       lib);
+    TRY_ATTACH_SYMBOL(&nvml.nvmlDeviceGetTemperatureThreshold,
+                      "nvmlDeviceGetTemperatureThreshold",
+                      lib);
+    ATTACH_OPTIONAL_SYMBOL(
+        &nvml.nvmlDeviceGetFanSpeed_v2, "nvmlDeviceGetFanSpeed_v2", lib);
+    ATTACH_OPTIONAL_SYMBOL(
+        &nvml.nvmlDeviceGetTargetFanSpeed, "nvmlDeviceGetTargetFanSpeed", lib);
+    ATTACH_OPTIONAL_SYMBOL(
+        &nvml.nvmlDeviceGetMinMaxFanSpeed, "nvmlDeviceGetMinMaxFanSpeed", lib);
+    ATTACH_OPTIONAL_SYMBOL(
+        &nvml.nvmlDeviceGetFieldValues, "nvmlDeviceGetFieldValues", lib);
+    ATTACH_OPTIONAL_SYMBOL(&nvml.nvmlDeviceGetCurrentClocksThrottleReasons,
+                           "nvmlDeviceGetCurrentClocksThrottleReasons",
+                           lib);
+    ATTACH_OPTIONAL_SYMBOL(
+        &nvml.nvmlEventSetCreate, "nvmlEventSetCreate", lib);
+    ATTACH_OPTIONAL_SYMBOL(&nvml.nvmlDeviceGetSupportedEventTypes,
+                           "nvmlDeviceGetSupportedEventTypes",
+                           lib);
+    ATTACH_OPTIONAL_SYMBOL(
+        &nvml.nvmlDeviceRegisterEvents, "nvmlDeviceRegisterEvents", lib);
+    ATTACH_OPTIONAL_SYMBOL(
+        &nvml.nvmlEventSetWait_v2, "nvmlEventSetWait_v2", lib);
+    ATTACH_OPTIONAL_SYMBOL(&nvml.nvmlEventSetFree, "nvmlEventSetFree", lib);
+    ATTACH_OPTIONAL_SYMBOL(&nvml.nvmlDeviceGetPowerManagementLimitConstraints,
+                           "nvmlDeviceGetPowerManagementLimitConstraints",
+                           lib);
+    ATTACH_OPTIONAL_SYMBOL(&nvml.nvmlDeviceGetPowerManagementLimit,
+                           "nvmlDeviceGetPowerManagementLimit",
+                           lib);
+    ATTACH_OPTIONAL_SYMBOL(&nvml.nvmlDeviceSetPowerManagementLimit,
+                           "nvmlDeviceSetPowerManagementLimit",
+                           lib);
+    ATTACH_OPTIONAL_SYMBOL(
+        &nvml.nvmlDeviceGetHandleByUUID, "nvmlDeviceGetHandleByUUID", lib);
+    ATTACH_OPTIONAL_SYMBOL(&nvml.nvmlDeviceGetUUID, "nvmlDeviceGetUUID", lib);
+    ATTACH_OPTIONAL_SYMBOL(
+        &nvml.nvmlDeviceGetPciInfo_v3, "nvmlDeviceGetPciInfo_v3", lib);
 
     return nvml;
 }
@@ -55,71 +487,571 @@ auto lib() -> NVML const&
     return lib;
 }
 
-auto init() -> void
+auto nvml_category() noexcept -> std::error_category const&
 {
-    CHECK_NVML_RESULT(lib().nvmlInit_v2(), "init");
+    static NvmlErrorCategory category {};
+    return category;
 }
 
-auto shutdown() noexcept -> void
+auto make_error_code(nvmlReturn_t result) noexcept -> std::error_code
+{
+    return std::error_code { static_cast<int>(result), nvml_category() };
+}
+
+auto error_string(std::error_code const& ec) noexcept -> char const*
 {
+    if (ec.category() != nvml_category()) {
+        if (ec == ErrorCodes::nvml_call_timeout) {
+            return "NVML call timed out";
+        }
+        return error_message(ec);
+    }
+
     try {
-        lib().nvmlShutdown();
+        return lib().nvmlErrorString(static_cast<nvmlReturn_t>(ec.value()));
     }
     catch (...) {
+        return "Unknown NVML error";
     }
 }
 
+auto set_call_timeout(std::chrono::milliseconds timeout) noexcept -> void
+{
+    call_timeout() = timeout.count();
+}
+
+auto init() -> void
+{
+    /* NOTE:
+     * Load the library first, so that a failure to load it is thrown from
+     * here. The other calls assume it has been loaded.
+     */
+    static_cast<void>(lib());
+    call_or_throw<NoOutput>(EntryPoint::init,
+                            [](NoOutput&) { return lib().nvmlInit_v2(); });
+}
+
+auto init(std::error_code& ec) noexcept -> bool
+{
+    NoOutput output;
+    return call(
+        EntryPoint::init,
+        [](NoOutput&) { return lib().nvmlInit_v2(); },
+        output,
+        ec);
+}
+
+auto shutdown() noexcept -> void
+{
+    NoOutput output;
+    std::error_code ec {};
+    static_cast<void>(call(
+        EntryPoint::shutdown,
+        [](NoOutput&) { return lib().nvmlShutdown(); },
+        output,
+        ec));
+}
+
 auto get_device_count() -> std::size_t
 {
-    unsigned int count;
-    CHECK_NVML_RESULT(lib().nvmlDeviceGetCount_v2(&count), "get_device_count");
-    return count;
+    return call_or_throw<unsigned int>(
+        EntryPoint::get_device_count, [](unsigned int& count) {
+            return lib().nvmlDeviceGetCount_v2(&count);
+        });
 }
 
 auto get_device_handle_by_index(unsigned int index) -> nvmlDevice_t
 {
-    nvmlDevice_t device;
-    CHECK_NVML_RESULT(lib().nvmlDeviceGetHandleByIndex_v2(index, &device),
-                      "get_device_handle_by_index");
-    return device;
+    return call_or_throw<nvmlDevice_t>(
+        EntryPoint::get_device_handle_by_index, [=](nvmlDevice_t& device) {
+            return lib().nvmlDeviceGetHandleByIndex_v2(index, &device);
+        });
+}
+
+auto get_device_handle_by_index(unsigned int index,
+                                nvmlDevice_t& device,
+                                std::error_code& ec) noexcept -> bool
+{
+    return call(
+        EntryPoint::get_device_handle_by_index,
+        [=](nvmlDevice_t& output) {
+            return lib().nvmlDeviceGetHandleByIndex_v2(index, &output);
+        },
+        device,
+        ec);
 }
+
+auto get_device_handle_by_uuid(Uuid const& uuid,
+                               nvmlDevice_t& device,
+                               std::error_code& ec) noexcept -> bool
+{
+    return call(
+        EntryPoint::get_device_handle_by_uuid,
+        [=](nvmlDevice_t& output) {
+            if (!lib().nvmlDeviceGetHandleByUUID) {
+                return NVML_ERROR_FUNCTION_NOT_FOUND;
+            }
+            return lib().nvmlDeviceGetHandleByUUID(uuid.value, &output);
+        },
+        device,
+        ec);
+}
+
+auto get_device_uuid(nvmlDevice_t device,
+                     Uuid& uuid,
+                     std::error_code& ec) noexcept -> bool
+{
+    return call(
+        EntryPoint::get_device_uuid,
+        [=](Uuid& output) {
+            if (!lib().nvmlDeviceGetUUID) {
+                return NVML_ERROR_FUNCTION_NOT_FOUND;
+            }
+            return lib().nvmlDeviceGetUUID(
+                device, output.value, sizeof(output.value));
+        },
+        uuid,
+        ec);
+}
+
+auto get_device_pci_info(nvmlDevice_t device,
+                         nvmlPciInfo_t& pci,
+                         std::error_code& ec) noexcept -> bool
+{
+    return call(
+        EntryPoint::get_device_pci_info,
+        [=](nvmlPciInfo_t& output) {
+            if (!lib().nvmlDeviceGetPciInfo_v3) {
+                return NVML_ERROR_FUNCTION_NOT_FOUND;
+            }
+            return lib().nvmlDeviceGetPciInfo_v3(device, &output);
+        },
+        pci,
+        ec);
+}
+
 auto get_device_temperature(nvmlDevice_t device,
                             nvmlTemperatureSensors_t sensor_type) -> std::size_t
 {
     unsigned int temperature;
-    CHECK_NVML_RESULT(
-        lib().nvmlDeviceGetTemperature(device, sensor_type, &temperature),
-        "get_device_temperature");
+    std::error_code ec {};
+    if (!get_device_temperature(device, sensor_type, temperature, ec)) {
+        throw std::system_error {
+            ec, entry_point_name(EntryPoint::get_device_temperature)
+        };
+    }
+
     return temperature;
 }
 
+auto get_device_temperature(nvmlDevice_t device,
+                            nvmlTemperatureSensors_t sensor_type,
+                            unsigned int& temperature,
+                            std::error_code& ec) noexcept -> bool
+{
+    return call(
+        EntryPoint::get_device_temperature,
+        [=](unsigned int& output) {
+            return lib().nvmlDeviceGetTemperature(device, sensor_type, &output);
+        },
+        temperature,
+        ec);
+}
+
 auto set_device_fan_speed(nvmlDevice_t device,
                           unsigned int fan_index,
                           unsigned int pc) -> void
 {
-    CHECK_NVML_RESULT(lib().nvmlDeviceSetFanSpeed_v2(device, fan_index, pc),
-                      "set_device_fan_speed");
+    std::error_code ec {};
+    if (!set_device_fan_speed(device, fan_index, pc, ec)) {
+        throw std::system_error {
+            ec, entry_point_name(EntryPoint::set_device_fan_speed)
+        };
+    }
+}
+
+auto set_device_fan_speed(nvmlDevice_t device,
+                          unsigned int fan_index,
+                          unsigned int pc,
+                          std::error_code& ec) noexcept -> bool
+{
+    NoOutput output;
+    return call(
+        EntryPoint::set_device_fan_speed,
+        [=](NoOutput&) {
+            return lib().nvmlDeviceSetFanSpeed_v2(device, fan_index, pc);
+        },
+        output,
+        ec);
 }
 
 auto set_device_default_fan_speed(nvmlDevice_t device, unsigned int fan_index)
     -> void
 {
-    CHECK_NVML_RESULT(lib().nvmlDeviceSetDefaultFanSpeed_v2(device, fan_index),
-                      "set_device_default_fan_speed");
+    std::error_code ec {};
+    if (!set_device_default_fan_speed(device, fan_index, ec)) {
+        throw std::system_error {
+            ec, entry_point_name(EntryPoint::set_device_default_fan_speed)
+        };
+    }
+}
+
+auto set_device_default_fan_speed(nvmlDevice_t device,
+                                  unsigned int fan_index,
+                                  std::error_code& ec) noexcept -> bool
+{
+    NoOutput output;
+    return call(
+        EntryPoint::set_device_default_fan_speed,
+        [=](NoOutput&) {
+            return lib().nvmlDeviceSetDefaultFanSpeed_v2(device, fan_index);
+        },
+        output,
+        ec);
 }
 
 auto get_device_fan_count(nvmlDevice_t device) -> unsigned int
 {
-    unsigned int count;
-    CHECK_NVML_RESULT(lib().nvmlDeviceGetNumFans(device, &count),
-                      "get_device_fan_count");
-    return count;
+    return call_or_throw<unsigned int>(
+        EntryPoint::get_device_fan_count, [=](unsigned int& count) {
+            return lib().nvmlDeviceGetNumFans(device, &count);
+        });
 }
 
 auto set_device_persistence_mode(nvmlDevice_t device, nvmlEnableState_t state)
     -> void
 {
-    CHECK_NVML_RESULT(lib().nvmlDeviceSetPersistenceMode(device, state),
-                      "set_device_persistence_mode");
+    call_or_throw<NoOutput>(EntryPoint::set_device_persistence_mode,
+                            [=](NoOutput&) {
+                                return lib().nvmlDeviceSetPersistenceMode(
+                                    device, state);
+                            });
+}
+auto get_device_fan_speed(nvmlDevice_t device,
+                          unsigned int fan_index,
+                          unsigned int& speed,
+                          std::error_code& ec) noexcept -> bool
+{
+    return call(
+        EntryPoint::get_device_fan_speed,
+        [=](unsigned int& output) {
+            if (!lib().nvmlDeviceGetFanSpeed_v2) {
+                return NVML_ERROR_FUNCTION_NOT_FOUND;
+            }
+            return lib().nvmlDeviceGetFanSpeed_v2(device, fan_index, &output);
+        },
+        speed,
+        ec);
+}
+
+auto get_device_target_fan_speed(nvmlDevice_t device,
+                                 unsigned int fan_index,
+                                 unsigned int& speed,
+                                 std::error_code& ec) noexcept -> bool
+{
+    return call(
+        EntryPoint::get_device_target_fan_speed,
+        [=](unsigned int& output) {
+            if (!lib().nvmlDeviceGetTargetFanSpeed) {
+                return NVML_ERROR_FUNCTION_NOT_FOUND;
+            }
+            return lib().nvmlDeviceGetTargetFanSpeed(
+                device, fan_index, &output);
+        },
+        speed,
+        ec);
+}
+
+auto get_device_min_max_fan_speed(nvmlDevice_t device,
+                                  unsigned int& min_speed,
+                                  unsigned int& max_speed,
+                                  std::error_code& ec) noexcept -> bool
+{
+    struct FanSpeedRange
+    {
+        unsigned int min;
+        unsigned int max;
+    };
+
+    FanSpeedRange range {};
+    if (!call(
+            EntryPoint::get_device_min_max_fan_speed,
+            [=](FanSpeedRange& output) {
+                if (!lib().nvmlDeviceGetMinMaxFanSpeed) {
+                    return NVML_ERROR_FUNCTION_NOT_FOUND;
+                }
+                return lib().nvmlDeviceGetMinMaxFanSpeed(
+                    device, &output.min, &output.max);
+            },
+            range,
+            ec)) {
+        return false;
+    }
+
+    min_speed = range.min;
+    max_speed = range.max;
+    return true;
+}
+
+auto get_device_temperature_threshold(nvmlDevice_t device,
+                                      nvmlTemperatureThresholds_t threshold,
+                                      unsigned int& temperature,
+                                      std::error_code& ec) noexcept -> bool
+{
+    return call(
+        EntryPoint::get_device_temperature_threshold,
+        [=](unsigned int& output) {
+            return lib().nvmlDeviceGetTemperatureThreshold(
+                device, threshold, &output);
+        },
+        temperature,
+        ec);
+}
+
+auto get_device_throttle_reasons(nvmlDevice_t device,
+                                 unsigned long long& reasons,
+                                 std::error_code& ec) noexcept -> bool
+{
+    return call(
+        EntryPoint::get_device_throttle_reasons,
+        [=](unsigned long long& output) {
+            if (!lib().nvmlDeviceGetCurrentClocksThrottleReasons) {
+                return NVML_ERROR_FUNCTION_NOT_FOUND;
+            }
+            return lib().nvmlDeviceGetCurrentClocksThrottleReasons(device,
+                                                                   &output);
+        },
+        reasons,
+        ec);
+}
+
+auto get_device_power_limit_constraints(nvmlDevice_t device,
+                                        unsigned int& min_limit,
+                                        unsigned int& max_limit,
+                                        std::error_code& ec) noexcept -> bool
+{
+    struct PowerLimitRange
+    {
+        unsigned int min;
+        unsigned int max;
+    };
+
+    PowerLimitRange range {};
+    if (!call(
+            EntryPoint::get_device_power_limit_constraints,
+            [=](PowerLimitRange& output) {
+                if (!lib().nvmlDeviceGetPowerManagementLimitConstraints) {
+                    return NVML_ERROR_FUNCTION_NOT_FOUND;
+                }
+                return lib().nvmlDeviceGetPowerManagementLimitConstraints(
+                    device, &output.min, &output.max);
+            },
+            range,
+            ec)) {
+        return false;
+    }
+
+    min_limit = range.min;
+    max_limit = range.max;
+    return true;
+}
+
+auto get_device_power_limit(nvmlDevice_t device,
+                            unsigned int& limit,
+                            std::error_code& ec) noexcept -> bool
+{
+    return call(
+        EntryPoint::get_device_power_limit,
+        [=](unsigned int& output) {
+            if (!lib().nvmlDeviceGetPowerManagementLimit) {
+                return NVML_ERROR_FUNCTION_NOT_FOUND;
+            }
+            return lib().nvmlDeviceGetPowerManagementLimit(device, &output);
+        },
+        limit,
+        ec);
+}
+
+auto set_device_power_limit(nvmlDevice_t device,
+                            unsigned int limit,
+                            std::error_code& ec) noexcept -> bool
+{
+    NoOutput output;
+    return call(
+        EntryPoint::set_device_power_limit,
+        [=](NoOutput&) {
+            if (!lib().nvmlDeviceSetPowerManagementLimit) {
+                return NVML_ERROR_FUNCTION_NOT_FOUND;
+            }
+            return lib().nvmlDeviceSetPowerManagementLimit(device, limit);
+        },
+        output,
+        ec);
+}
+
+auto create_event_set(nvmlEventSet_t& set, std::error_code& ec) noexcept
+    -> bool
+{
+    return call(
+        EntryPoint::create_event_set,
+        [](nvmlEventSet_t& output) {
+            if (!lib().nvmlEventSetCreate) {
+                return NVML_ERROR_FUNCTION_NOT_FOUND;
+            }
+            return lib().nvmlEventSetCreate(&output);
+        },
+        set,
+        ec);
+}
+
+auto free_event_set(nvmlEventSet_t set) noexcept -> void
+{
+    std::error_code ec {};
+    NoOutput output;
+    if (!call(
+            EntryPoint::free_event_set,
+            [=](NoOutput&) {
+                if (!lib().nvmlEventSetFree) {
+                    return NVML_ERROR_FUNCTION_NOT_FOUND;
+                }
+                return lib().nvmlEventSetFree(set);
+            },
+            output,
+            ec)) {
+        gfc::log(gfc::LogLevel::warn,
+                 "Couldn't free NVML event set: %s",
+                 error_string(ec));
+    }
+}
+
+auto get_device_supported_event_types(nvmlDevice_t device,
+                                      unsigned long long& event_types,
+                                      std::error_code& ec) noexcept -> bool
+{
+    return call(
+        EntryPoint::get_device_supported_event_types,
+        [=](unsigned long long& output) {
+            if (!lib().nvmlDeviceGetSupportedEventTypes) {
+                return NVML_ERROR_FUNCTION_NOT_FOUND;
+            }
+            return lib().nvmlDeviceGetSupportedEventTypes(device, &output);
+        },
+        event_types,
+        ec);
+}
+
+auto register_device_events(nvmlDevice_t device,
+                            unsigned long long event_types,
+                            nvmlEventSet_t set,
+                            std::error_code& ec) noexcept -> bool
+{
+    NoOutput output;
+    return call(
+        EntryPoint::register_device_events,
+        [=](NoOutput&) {
+            if (!lib().nvmlDeviceRegisterEvents) {
+                return NVML_ERROR_FUNCTION_NOT_FOUND;
+            }
+            return lib().nvmlDeviceRegisterEvents(device, event_types, set);
+        },
+        output,
+        ec);
+}
+
+auto wait_for_event(nvmlEventSet_t set,
+                    nvmlEventData_t& event,
+                    std::chrono::milliseconds timeout,
+                    std::error_code& ec) noexcept -> bool
+{
+    auto const timeout_ms = static_cast<unsigned int>(timeout.count());
+    auto wait = [=](nvmlEventData_t& output) {
+        if (!lib().nvmlEventSetWait_v2) {
+            return NVML_ERROR_FUNCTION_NOT_FOUND;
+        }
+        return lib().nvmlEventSetWait_v2(set, &output, timeout_ms);
+    };
+
+    return check_result(timed_call(EntryPoint::wait_for_event, wait, event),
+                        ec);
+}
+
+auto sample_device(nvmlDevice_t device,
+                   SampleSensors const& sensors,
+                   Sample& sample,
+                   std::error_code& ec) noexcept -> bool
+{
+    sample = Sample {};
+    if (!get_device_temperature(
+            device, NVML_TEMPERATURE_GPU, sample.gpu_temperature, ec)) {
+        return false;
+    }
+
+    /* NOTE:
+     * The other sensors are optional, so only a failure that isn't specific
+     * to the sensor is reported
+     */
+    std::error_code sensor_ec {};
+    if (sensors.thermal_slowdown) {
+        unsigned long long reasons;
+        if (get_device_throttle_reasons(device, reasons, sensor_ec)) {
+            sample.thermal_slowdown = (reasons & kThermalThrottleReasons) != 0;
+        }
+        else if (!is_unsupported(sensor_ec)) {
+            ec = sensor_ec;
+            return false;
+        }
+    }
+
+    using FieldValues = std::array<nvmlFieldValue_t, kMaxSampleFields>;
+
+    FieldValues values {};
+    int count = 0;
+    if (sensors.memory_temperature) {
+        values[count++].fieldId = NVML_FI_DEV_MEMORY_TEMP;
+    }
+    if (sensors.power_usage) {
+        values[count++].fieldId = NVML_FI_DEV_POWER_INSTANT;
+    }
+
+    if (!count) {
+        return true;
+    }
+
+    sensor_ec.clear();
+    if (!call(
+            EntryPoint::get_device_field_values,
+            [=](FieldValues& output) {
+                if (!lib().nvmlDeviceGetFieldValues) {
+                    return NVML_ERROR_FUNCTION_NOT_FOUND;
+                }
+                return lib().nvmlDeviceGetFieldValues(
+                    device, count, output.data());
+            },
+            values,
+            sensor_ec)) {
+        if (is_unsupported(sensor_ec)) {
+            return true;
+        }
+
+        ec = sensor_ec;
+        return false;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        auto const& value = values[i];
+        if (value.nvmlReturn != NVML_SUCCESS) {
+            continue;
+        }
+
+        auto const reading = field_value(value);
+        if (value.fieldId == NVML_FI_DEV_MEMORY_TEMP) {
+            sample.memory_temperature = reading;
+        }
+        else if (value.fieldId == NVML_FI_DEV_POWER_INSTANT) {
+            sample.power_usage = reading;
+        }
+    }
+
+    return true;
 }
 } // namespace gfc::nvml
@@ -160,9 +160,201 @@ typedef enum nvmlTemperatureSensors_enum
     NVML_TEMPERATURE_COUNT
 } nvmlTemperatureSensors_t;
 
+/**
+ * Temperature thresholds.
+ */
+typedef enum nvmlTemperatureThresholds_enum
+{
+    NVML_TEMPERATURE_THRESHOLD_SHUTDOWN = 0, //!< Temperature at which the GPU
+                                             //!< will shut down for HW
+                                             //!< protection
+    NVML_TEMPERATURE_THRESHOLD_SLOWDOWN = 1, //!< Temperature at which the GPU
+                                             //!< will begin HW slowdown
+    NVML_TEMPERATURE_THRESHOLD_MEM_MAX = 2,  //!< Memory temperature at which
+                                             //!< the GPU will begin SW slowdown
+    NVML_TEMPERATURE_THRESHOLD_GPU_MAX = 3,  //!< GPU temperature at which the
+                                             //!< GPU can be throttled below
+                                             //!< base clock
+
+    // Keep this last
+    NVML_TEMPERATURE_THRESHOLD_COUNT
+} nvmlTemperatureThresholds_t;
+
 typedef struct nvmlUnit_st* nvmlUnit_t;
 typedef struct nvmlDevice_st* nvmlDevice_t;
 
+/**
+ * Buffer size guaranteed to be large enough for \ref nvmlDeviceGetUUID
+ */
+#define NVML_DEVICE_UUID_V2_BUFFER_SIZE 96
+
+/**
+ * Buffer size guaranteed to be large enough for pci bus id
+ */
+#define NVML_DEVICE_PCI_BUS_ID_BUFFER_SIZE 32
+
+/**
+ * Buffer size guaranteed to be large enough for pci bus id for ::busIdLegacy
+ */
+#define NVML_DEVICE_PCI_BUS_ID_BUFFER_V2_SIZE 16
+
+/**
+ * PCI information about a GPU device.
+ */
+typedef struct nvmlPciInfo_st
+{
+    //! The legacy tuple domain:bus:device.function PCI identifier
+    char busIdLegacy[NVML_DEVICE_PCI_BUS_ID_BUFFER_V2_SIZE];
+    unsigned int domain; //!< The PCI domain on which the device's bus resides,
+                         //!< 0 to 0xffffffff
+    unsigned int bus;    //!< The bus on which the device resides, 0 to 0xff
+    unsigned int device; //!< The device's id on the bus, 0 to 31
+    unsigned int pciDeviceId; //!< The combined 16-bit device id and 16-bit
+                              //!< vendor id
+    unsigned int pciSubSystemId; //!< The 32-bit Sub System Device ID
+    //! The tuple domain:bus:device.function PCI identifier
+    char busId[NVML_DEVICE_PCI_BUS_ID_BUFFER_SIZE];
+} nvmlPciInfo_t;
+
+/**
+ * Represents the type for sample value returned
+ */
+typedef enum nvmlValueType_enum
+{
+    NVML_VALUE_TYPE_DOUBLE = 0,
+    NVML_VALUE_TYPE_UNSIGNED_INT = 1,
+    NVML_VALUE_TYPE_UNSIGNED_LONG = 2,
+    NVML_VALUE_TYPE_UNSIGNED_LONG_LONG = 3,
+    NVML_VALUE_TYPE_SIGNED_LONG_LONG = 4,
+    NVML_VALUE_TYPE_SIGNED_INT = 5,
+
+    // Keep this last
+    NVML_VALUE_TYPE_COUNT
+} nvmlValueType_t;
+
+/**
+ * Union to represent different types of Value
+ */
+typedef union nvmlValue_st
+{
+    double dVal;             //!< If the value is double
+    int siVal;               //!< If the value is signed int
+    unsigned int uiVal;      //!< If the value is unsigned int
+    unsigned long ulVal;     //!< If the value is unsigned long
+    unsigned long long ullVal; //!< If the value is unsigned long long
+    signed long long sllVal; //!< If the value is signed long long
+} nvmlValue_t;
+
+/**
+ * Memory temperature for the device, in degrees C.
+ */
+#define NVML_FI_DEV_MEMORY_TEMP 82
+
+/**
+ * Current (instantaneous) power usage of the device, in milliwatts.
+ */
+#define NVML_FI_DEV_POWER_INSTANT 186
+
+/**
+ * HW Slowdown (reducing the core clocks by a factor of 2 or more) is engaged.
+ * This is an indicator of one or more of: temperature too high, external power
+ * brake assertion or power draw too high.
+ */
+#define nvmlClocksThrottleReasonHwSlowdown 0x0000000000000008LL
+
+/**
+ * SW Thermal Slowdown. This is an indicator of one or more of: current GPU
+ * temperature above the GPU max operating temperature, or current memory
+ * temperature above the memory max operating temperature.
+ */
+#define nvmlClocksThrottleReasonSwThermalSlowdown 0x0000000000000020LL
+
+/**
+ * HW Thermal Slowdown (reducing the core clocks by a factor of 2 or more) is
+ * engaged. This is an indicator of temperature being too high.
+ */
+#define nvmlClocksThrottleReasonHwThermalSlowdown 0x0000000000000040LL
+
+/**
+ * HW Power Brake Slowdown (reducing the core clocks by a factor of 2 or more)
+ * is engaged. This is an indicator of an external power brake assertion being
+ * triggered (e.g. by the system power supply).
+ */
+#define nvmlClocksThrottleReasonHwPowerBrakeSlowdown 0x0000000000000080LL
+
+/**
+ * Handle to an event set
+ */
+typedef struct nvmlEventSet_st* nvmlEventSet_t;
+
+/**
+ * Event about PState changes
+ *
+ * \note On Fermi architecture PState changes are also an indicator that GPU
+ * is throttling down due to no work being executed on the GPU, power capping
+ * or thermal capping. In a typical situation, Fermi-based GPU should stay in
+ * P0 for the duration of the execution of the compute process.
+ */
+#define nvmlEventTypePState 0x0000000000000004LL
+
+/**
+ * Event about clock changes
+ *
+ * Kepler only
+ */
+#define nvmlEventTypeClock 0x0000000000000010LL
+
+/**
+ * Event about AC/Battery power source changes
+ */
+#define nvmlEventTypePowerSourceChange 0x0000000000000080LL
+
+/**
+ * Information about occurred event
+ */
+typedef struct nvmlEventData_st
+{
+    nvmlDevice_t device; //!< Specific device where the event occurred
+    unsigned long long eventType; //!< Information about what specific event
+                                  //!< occurred
+    unsigned long long eventData; //!< Stores XID error for the device in the
+                                  //!< event of nvmlEventTypeXidCriticalError,
+                                  //!< eventData is 0 for any other event
+    unsigned int gpuInstanceId;     //!< If MIG is enabled and
+                                    //!< nvmlEventTypeXidCriticalError event is
+                                    //!< attributable to a GPU instance, stores
+                                    //!< a valid GPU instance ID
+    unsigned int computeInstanceId; //!< If MIG is enabled and
+                                    //!< nvmlEventTypeXidCriticalError event is
+                                    //!< attributable to a compute instance,
+                                    //!< stores a valid compute instance ID
+} nvmlEventData_t;
+
+/**
+ * Information for a Field Value Sample
+ */
+typedef struct nvmlFieldValue_st
+{
+    unsigned int fieldId; //!< ID of the NVML field to retrieve. This must be
+                          //!< set before any call that uses this struct. See
+                          //!< the constants starting with NVML_FI_ above.
+    unsigned int scopeId; //!< Scope ID can represent data used by NVML
+                          //!< depending on fieldId's context.
+    long long timestamp;  //!< CPU Timestamp of this value in microseconds
+                          //!< since 1970
+    long long latencyUsec; //!< How long this field value took to update (in
+                           //!< usec) within NVML. This may be averaged across
+                           //!< several fields that are serviced by the same
+                           //!< driver call.
+    nvmlValueType_t valueType; //!< Type of the value stored in value
+    nvmlReturn_t nvmlReturn;   //!< Return code for retrieving this value. This
+                               //!< must be checked before looking at value,
+                               //!< as value is undefined if nvmlReturn !=
+                               //!< NVML_SUCCESS
+    nvmlValue_t value;         //!< Value for this field. This is only valid
+                               //!< if nvmlReturn == NVML_SUCCESS
+} nvmlFieldValue_t;
+
 /**
  * Initialize NVML, but don't initialize any GPUs yet.
  *
@@ -363,6 +555,101 @@ typedef nvmlReturn_t (*PFN_nvmlDeviceGetCount_v2)(unsigned int* deviceCount);
 typedef nvmlReturn_t (*PFN_nvmlDeviceGetHandleByIndex_v2)(unsigned int index,
                                                           nvmlDevice_t* device);
 
+/**
+ * Acquire the handle for a particular device, based on its globally unique
+ * immutable UUID associated with each device.
+ *
+ * For all products.
+ *
+ * @param uuid                                 The UUID of the target GPU or
+ * MIG instance
+ * @param device                               Reference in which to return the
+ * device handle or MIG device handle
+ *
+ * Starting from NVML 5, this API causes NVML to initialize the target GPU
+ * NVML may initialize additional GPUs as it searches for the target GPU
+ *
+ * @return
+ *         - \ref NVML_SUCCESS                  if \a device has been set
+ *         - \ref NVML_ERROR_UNINITIALIZED      if the library has not been
+ * successfully initialized
+ *         - \ref NVML_ERROR_INVALID_ARGUMENT   if \a uuid is invalid or \a
+ * device is null
+ *         - \ref NVML_ERROR_NOT_FOUND          if \a uuid does not match a
+ * valid device on the system
+ *         - \ref NVML_ERROR_INSUFFICIENT_POWER if any attached devices have
+ * improperly attached external power cables
+ *         - \ref NVML_ERROR_IRQ_ISSUE          if NVIDIA kernel detected an
+ * interrupt issue with the attached GPUs
+ *         - \ref NVML_ERROR_GPU_IS_LOST        if any GPU has fallen off the
+ * bus or is otherwise inaccessible
+ *         - \ref NVML_ERROR_UNKNOWN            on any unexpected error
+ */
+typedef nvmlReturn_t (*PFN_nvmlDeviceGetHandleByUUID)(char const* uuid,
+                                                      nvmlDevice_t* device);
+
+/**
+ * Retrieves the globally unique immutable UUID associated with this device,
+ * as a 5 part hexadecimal string, that augments the immutable, board serial
+ * identifier.
+ *
+ * For all products.
+ *
+ * The UUID is a globally unique identifier. It is the only available
+ * identifier for pre-Fermi-architecture products. It does NOT correspond to
+ * any identifier printed on the board. It will not exceed 96 characters in
+ * length (including the NULL terminator). See \ref
+ * nvmlConstants::NVML_DEVICE_UUID_V2_BUFFER_SIZE.
+ *
+ * @param device                               The identifier of the target
+ * device
+ * @param uuid                                 Reference in which to return
+ * the GPU UUID
+ * @param length                               The maximum allowed length of
+ * the string returned in \a uuid
+ *
+ * @return
+ *         - \ref NVML_SUCCESS                 if \a uuid has been set
+ *         - \ref NVML_ERROR_UNINITIALIZED     if the library has not been
+ * successfully initialized
+ *         - \ref NVML_ERROR_INVALID_ARGUMENT  if \a device is invalid, or \a
+ * uuid is NULL
+ *         - \ref NVML_ERROR_INSUFFICIENT_SIZE if \a length is too small
+ *         - \ref NVML_ERROR_NOT_SUPPORTED     if the device doesn't support
+ * this feature
+ *         - \ref NVML_ERROR_GPU_IS_LOST       if the target GPU has fallen off
+ * the bus or is otherwise inaccessible
+ *         - \ref NVML_ERROR_UNKNOWN           on any unexpected error
+ */
+typedef nvmlReturn_t (*PFN_nvmlDeviceGetUUID)(nvmlDevice_t device,
+                                              char* uuid,
+                                              unsigned int length);
+
+/**
+ * Retrieves the PCI attributes of this device.
+ *
+ * For all products.
+ *
+ * See \ref nvmlPciInfo_t for details on the available PCI info.
+ *
+ * @param device                               The identifier of the target
+ * device
+ * @param pci                                  Reference in which to return
+ * the PCI info
+ *
+ * @return
+ *         - \ref NVML_SUCCESS                 if \a pci has been populated
+ *         - \ref NVML_ERROR_UNINITIALIZED     if the library has not been
+ * successfully initialized
+ *         - \ref NVML_ERROR_INVALID_ARGUMENT  if \a device is invalid or \a
+ * pci is NULL
+ *         - \ref NVML_ERROR_GPU_IS_LOST       if the target GPU has fallen off
+ * the bus or is otherwise inaccessible
+ *         - \ref NVML_ERROR_UNKNOWN           on any unexpected error
+ */
+typedef nvmlReturn_t (*PFN_nvmlDeviceGetPciInfo_v3)(nvmlDevice_t device,
+                                                    nvmlPciInfo_t* pci);
+
 /**
  * Retrieves the current temperature readings for the device, in degrees C.
  *
@@ -466,6 +753,404 @@ typedef nvmlReturn_t (*PFN_nvmlDeviceSetDefaultFanSpeed_v2)(nvmlDevice_t device,
 typedef nvmlReturn_t (*PFN_nvmlDeviceGetNumFans)(nvmlDevice_t device,
                                                  unsigned int* numFans);
 
+/**
+ * Retrieves the intended operating speed of the device's specified fan.
+ *
+ * Note: The reported speed is the intended fan speed. If the fan is physically
+ * blocked and unable to spin, the output will not match the actual fan speed.
+ *
+ * For all discrete products with dedicated fans.
+ *
+ * The fan speed is expressed as a percentage of the product's maximum noise
+ * tolerance fan speed. This value may exceed 100% in certain cases.
+ *
+ * @param device                               The identifier of the target
+ * device
+ * @param fan                                  The index of the target fan, zero
+ * indexed.
+ * @param speed                                Reference in which to return the
+ * fan speed percentage
+ *
+ * @return
+ *         - \ref NVML_SUCCESS                 if \a speed has been set
+ *         - \ref NVML_ERROR_UNINITIALIZED     if the library has not been
+ * successfully initialized
+ *         - \ref NVML_ERROR_INVALID_ARGUMENT  if \a device is invalid, \a fan
+ * is not an acceptable index, or \a speed is NULL
+ *         - \ref NVML_ERROR_NOT_SUPPORTED     if the device does not have a fan
+ * or is newer than Maxwell
+ *         - \ref NVML_ERROR_GPU_IS_LOST       if the target GPU has fallen off
+ * the bus or is otherwise inaccessible
+ *         - \ref NVML_ERROR_UNKNOWN           on any unexpected error
+ */
+typedef nvmlReturn_t (*PFN_nvmlDeviceGetFanSpeed_v2)(nvmlDevice_t device,
+                                                     unsigned int fan,
+                                                     unsigned int* speed);
+
+/**
+ * Retrieves the intended target speed of the device's specified fan.
+ *
+ * Normally, the driver dynamically adjusts the fan based on
+ * the needs of the GPU.  But when user set fan speed using
+ * nvmlDeviceSetFanSpeed_v2, the driver will attempt to make the fan achieve the
+ * setting in nvmlDeviceSetFanSpeed_v2. The actual current speed of the fan is
+ * reported in nvmlDeviceGetFanSpeed_v2.
+ *
+ * For all discrete products with dedicated fans.
+ *
+ * The fan speed is expressed as a percentage of the product's maximum noise
+ * tolerance fan speed. This value may exceed 100% in certain cases.
+ *
+ * @param device                               The identifier of the target
+ * device
+ * @param fan                                  The index of the target fan, zero
+ * indexed.
+ * @param targetSpeed                          Reference in which to return the
+ * fan speed percentage
+ *
+ * @return
+ *         - \ref NVML_SUCCESS                 if \a speed has been set
+ *         - \ref NVML_ERROR_UNINITIALIZED     if the library has not been
+ * successfully initialized
+ *         - \ref NVML_ERROR_INVALID_ARGUMENT  if \a device is invalid, \a fan
+ * is not an acceptable index, or \a speed is NULL
+ *         - \ref NVML_ERROR_NOT_SUPPORTED     if the device does not have a fan
+ * or is newer than Maxwell
+ *         - \ref NVML_ERROR_GPU_IS_LOST       if the target GPU has fallen off
+ * the bus or is otherwise inaccessible
+ *         - \ref NVML_ERROR_UNKNOWN           on any unexpected error
+ */
+typedef nvmlReturn_t (*PFN_nvmlDeviceGetTargetFanSpeed)(
+    nvmlDevice_t device, unsigned int fan, unsigned int* targetSpeed);
+
+/**
+ * Retrieves the temperature threshold for the GPU with the specified threshold
+ * type in degrees C.
+ *
+ * For Kepler &tm; or newer fully supported devices.
+ *
+ * See \ref nvmlTemperatureThresholds_t for details on available temperature
+ * thresholds.
+ *
+ * @param device                               The identifier of the target
+ * device
+ * @param thresholdType                        The type of threshold value
+ * queried
+ * @param temp                                 Reference in which to return the
+ * temperature reading
+ * @return
+ *         - \ref NVML_SUCCESS                 if \a temp has been set
+ *         - \ref NVML_ERROR_UNINITIALIZED     if the library has not been
+ * successfully initialized
+ *         - \ref NVML_ERROR_INVALID_ARGUMENT  if \a device is invalid, \a
+ * thresholdType is invalid or \a temp is NULL
+ *         - \ref NVML_ERROR_NOT_SUPPORTED     if the device does not have a
+ * temperature sensor or is unsupported
+ *         - \ref NVML_ERROR_GPU_IS_LOST       if the target GPU has fallen off
+ * the bus or is otherwise inaccessible
+ *         - \ref NVML_ERROR_UNKNOWN           on any unexpected error
+ */
+typedef nvmlReturn_t (*PFN_nvmlDeviceGetTemperatureThreshold)(
+    nvmlDevice_t device,
+    nvmlTemperatureThresholds_t thresholdType,
+    unsigned int* temp);
+
+/**
+ * Retrieves the min and max fan speed that user can set for the GPU fan.
+ *
+ * For all cuda-capable discrete products with fans
+ *
+ * @param device                        The identifier of the target device
+ * @param minSpeed                      The minimum speed allowed to set
+ * @param maxSpeed                      The maximum speed allowed to set
+ *
+ * return
+ *         NVML_SUCCESS                 if speed has been adjusted
+ *         NVML_ERROR_INVALID_ARGUMENT  if device is invalid
+ *         NVML_ERROR_NOT_SUPPORTED     if the device does not support this
+ *                                      (doesn't have fans)
+ *         NVML_ERROR_UNKNOWN           on any unexpected error
+ */
+typedef nvmlReturn_t (*PFN_nvmlDeviceGetMinMaxFanSpeed)(nvmlDevice_t device,
+                                                        unsigned int* minSpeed,
+                                                        unsigned int* maxSpeed);
+
+/**
+ * Request values for a list of fields for a device. This API allows multiple
+ * fields to be queried at once. If any of the underlying fieldIds are
+ * populated by the same driver call, the results for those field IDs will be
+ * populated from a single call rather than making a driver call for each
+ * fieldId.
+ *
+ * @param device                               The device handle of the GPU to
+ * request field values for
+ * @param valuesCount                          Number of entries in values that
+ * should be retrieved
+ * @param values                               Array of \a valuesCount
+ * structures to hold field values. Each value's fieldId must be populated
+ * prior to this call
+ *
+ * @return
+ *         - \ref NVML_SUCCESS                 if any values in \a values were
+ * populated. Note that you must check the nvmlReturn field of each value for
+ * each individual status
+ *         - \ref NVML_ERROR_INVALID_ARGUMENT  if \a device is invalid or \a
+ * values is NULL
+ */
+typedef nvmlReturn_t (*PFN_nvmlDeviceGetFieldValues)(nvmlDevice_t device,
+                                                     int valuesCount,
+                                                     nvmlFieldValue_t* values);
+
+/**
+ * Retrieves current clocks throttling reasons.
+ *
+ * For all fully supported products.
+ *
+ * \note More than one bit can be enabled at the same time. Multiple reasons
+ * can be affecting clocks at once.
+ *
+ * @param device                                The identifier of the target
+ * device
+ * @param clocksThrottleReasons                 Reference in which to return
+ * bitmask of active clocks throttle reasons
+ *
+ * @return
+ *         - \ref NVML_SUCCESS                 if \a clocksThrottleReasons has
+ * been set
+ *         - \ref NVML_ERROR_UNINITIALIZED     if the library has not been
+ * successfully initialized
+ *         - \ref NVML_ERROR_INVALID_ARGUMENT  if \a device is invalid or \a
+ * clocksThrottleReasons is NULL
+ *         - \ref NVML_ERROR_NOT_SUPPORTED     if the device does not support
+ * this feature
+ *         - \ref NVML_ERROR_GPU_IS_LOST       if the target GPU has fallen off
+ * the bus or is otherwise inaccessible
+ *         - \ref NVML_ERROR_UNKNOWN           on any unexpected error
+ */
+typedef nvmlReturn_t (*PFN_nvmlDeviceGetCurrentClocksThrottleReasons)(
+    nvmlDevice_t device, unsigned long long* clocksThrottleReasons);
+
+/**
+ * Retrieves information about possible values of power management limits on
+ * this device.
+ *
+ * For Kepler &tm; or newer fully supported devices.
+ *
+ * @param device                               The identifier of the target
+ * device
+ * @param minLimit                             Reference in which to return
+ * the minimum power management limit in milliwatts
+ * @param maxLimit                             Reference in which to return
+ * the maximum power management limit in milliwatts
+ *
+ * @return
+ *         - \ref NVML_SUCCESS                 if \a minLimit and \a maxLimit
+ * have been set
+ *         - \ref NVML_ERROR_UNINITIALIZED     if the library has not been
+ * successfully initialized
+ *         - \ref NVML_ERROR_INVALID_ARGUMENT  if \a device is invalid or \a
+ * minLimit or \a maxLimit is NULL
+ *         - \ref NVML_ERROR_NOT_SUPPORTED     if the device does not support
+ * this feature
+ *         - \ref NVML_ERROR_GPU_IS_LOST       if the target GPU has fallen off
+ * the bus or is otherwise inaccessible
+ *         - \ref NVML_ERROR_UNKNOWN           on any unexpected error
+ */
+typedef nvmlReturn_t (*PFN_nvmlDeviceGetPowerManagementLimitConstraints)(
+    nvmlDevice_t device, unsigned int* minLimit, unsigned int* maxLimit);
+
+/**
+ * Retrieves the power management limit associated with this device.
+ *
+ * For Fermi &tm; or newer fully supported devices.
+ *
+ * The power limit defines the upper boundary for the card's power draw. If
+ * the card's total power draw reaches this limit the power management
+ * algorithm kicks in.
+ *
+ * @param device                               The identifier of the target
+ * device
+ * @param limit                                Reference in which to return
+ * the power management limit in milliwatts
+ *
+ * @return
+ *         - \ref NVML_SUCCESS                 if \a limit has been set
+ *         - \ref NVML_ERROR_UNINITIALIZED     if the library has not been
+ * successfully initialized
+ *         - \ref NVML_ERROR_INVALID_ARGUMENT  if \a device is invalid or \a
+ * limit is NULL
+ *         - \ref NVML_ERROR_NOT_SUPPORTED     if the device does not support
+ * this feature
+ *         - \ref NVML_ERROR_GPU_IS_LOST       if the target GPU has fallen off
+ * the bus or is otherwise inaccessible
+ *         - \ref NVML_ERROR_UNKNOWN           on any unexpected error
+ */
+typedef nvmlReturn_t (*PFN_nvmlDeviceGetPowerManagementLimit)(
+    nvmlDevice_t device, unsigned int* limit);
+
+/**
+ * Set new power limit of this device.
+ *
+ * For Kepler &tm; or newer fully supported devices.
+ * Requires root/admin permissions.
+ *
+ * \note Limit is not persistent across reboots or driver unloads.
+ * Enable persistent mode to prevent driver from unloading when no application
+ * is using the device.
+ *
+ * @param device                               The identifier of the target
+ * device
+ * @param limit                                Power management limit in
+ * milliwatts to set
+ *
+ * @return
+ *         - \ref NVML_SUCCESS                 if \a limit has been set
+ *         - \ref NVML_ERROR_UNINITIALIZED     if the library has not been
+ * successfully initialized
+ *         - \ref NVML_ERROR_INVALID_ARGUMENT  if \a device is invalid or \a
+ * defaultLimit is out of range
+ *         - \ref NVML_ERROR_NOT_SUPPORTED     if the device does not support
+ * this feature
+ *         - \ref NVML_ERROR_NO_PERMISSION     if the user doesn't have
+ * permission to perform this operation
+ *         - \ref NVML_ERROR_GPU_IS_LOST       if the target GPU has fallen off
+ * the bus or is otherwise inaccessible
+ *         - \ref NVML_ERROR_UNKNOWN           on any unexpected error
+ */
+typedef nvmlReturn_t (*PFN_nvmlDeviceSetPowerManagementLimit)(
+    nvmlDevice_t device, unsigned int limit);
+
+/**
+ * Create an empty set of events.
+ * Event set should be freed by \ref nvmlEventSetFree
+ *
+ * For Fermi &tm; or newer fully supported devices.
+ * @param set                                  Reference in which to return
+ * the event handle
+ *
+ * @return
+ *         - \ref NVML_SUCCESS                 if the event has been set
+ *         - \ref NVML_ERROR_UNINITIALIZED     if the library has not been
+ * successfully initialized
+ *         - \ref NVML_ERROR_INVALID_ARGUMENT  if \a set is NULL
+ *         - \ref NVML_ERROR_UNKNOWN           on any unexpected error
+ */
+typedef nvmlReturn_t (*PFN_nvmlEventSetCreate)(nvmlEventSet_t* set);
+
+/**
+ * Starts recording of events on a specified devices and add the events to
+ * specified \ref nvmlEventSet_t
+ *
+ * For Fermi &tm; or newer fully supported devices.
+ * Ecc events are available only on ECC enabled devices (see \ref
+ * nvmlDeviceGetTotalEccErrors) Power capping events are available only on
+ * Power Management enabled devices (see \ref nvmlDeviceGetPowerManagementMode)
+ *
+ * For Linux only.
+ *
+ * \note All events that occurred before this call are not recorded.
+ *       Checking if some event occurred can be done with \ref
+ * nvmlEventSetWait_v2
+ *
+ * \note If function reports NVML_ERROR_UNKNOWN, event set is in undefined
+ * state and should be freed.
+ *
+ * @param device                               The identifier of the target
+ * device
+ * @param eventTypes                           Bitmask of \ref nvmlEventType
+ * to record
+ * @param set                                  Set to which add new event types
+ *
+ * @return
+ *         - \ref NVML_SUCCESS                 if the event has been set
+ *         - \ref NVML_ERROR_UNINITIALIZED     if the library has not been
+ * successfully initialized
+ *         - \ref NVML_ERROR_INVALID_ARGUMENT  if \a eventTypes is invalid or
+ * \a set is NULL
+ *         - \ref NVML_ERROR_NOT_SUPPORTED     if the platform does not support
+ * this feature or some of requested event types
+ *         - \ref NVML_ERROR_GPU_IS_LOST       if the target GPU has fallen off
+ * the bus or is otherwise inaccessible
+ *         - \ref NVML_ERROR_UNKNOWN           on any unexpected error
+ */
+typedef nvmlReturn_t (*PFN_nvmlDeviceRegisterEvents)(
+    nvmlDevice_t device, unsigned long long eventTypes, nvmlEventSet_t set);
+
+/**
+ * Returns information about events supported on device
+ *
+ * For Fermi &tm; or newer fully supported devices.
+ *
+ * Events are not supported on Windows. So this function returns an empty
+ * mask in \a eventTypes on Windows.
+ *
+ * @param device                               The identifier of the target
+ * device
+ * @param eventTypes                           Reference in which to return
+ * bitmask of supported events
+ *
+ * @return
+ *         - \ref NVML_SUCCESS                 if the eventTypes has been set
+ *         - \ref NVML_ERROR_UNINITIALIZED     if the library has not been
+ * successfully initialized
+ *         - \ref NVML_ERROR_INVALID_ARGUMENT  if \a eventType is NULL
+ *         - \ref NVML_ERROR_GPU_IS_LOST       if the target GPU has fallen off
+ * the bus or is otherwise inaccessible
+ *         - \ref NVML_ERROR_UNKNOWN           on any unexpected error
+ */
+typedef nvmlReturn_t (*PFN_nvmlDeviceGetSupportedEventTypes)(
+    nvmlDevice_t device, unsigned long long* eventTypes);
+
+/**
+ * Waits on events and delivers events
+ *
+ * For Fermi &tm; or newer fully supported devices.
+ *
+ * If some events are ready to be delivered at the time of the call, function
+ * returns immediately. If there are no events ready to be delivered, function
+ * sleeps till event arrives but not longer than specified timeout. This
+ * function in certain conditions can return before specified timeout passes
+ * (e.g. when interrupt arrives)
+ *
+ * @param set                                  Reference to set of events to
+ * wait on
+ * @param data                                 Reference in which to return
+ * event data
+ * @param timeoutms                            Maximum amount of wait time in
+ * milliseconds for registered event
+ *
+ * @return
+ *         - \ref NVML_SUCCESS                 if the data has been set
+ *         - \ref NVML_ERROR_UNINITIALIZED     if the library has not been
+ * successfully initialized
+ *         - \ref NVML_ERROR_INVALID_ARGUMENT  if \a data is NULL
+ *         - \ref NVML_ERROR_TIMEOUT           if no event arrived in
+ * specified timeout or interrupt arrived
+ *         - \ref NVML_ERROR_GPU_IS_LOST       if a GPU has fallen off the bus
+ * or is otherwise inaccessible
+ *         - \ref NVML_ERROR_UNKNOWN           on any unexpected error
+ */
+typedef nvmlReturn_t (*PFN_nvmlEventSetWait_v2)(nvmlEventSet_t set,
+                                                nvmlEventData_t* data,
+                                                unsigned int timeoutms);
+
+/**
+ * Releases events in the set
+ *
+ * For Fermi &tm; or newer fully supported devices.
+ *
+ * @param set                                  Reference to events to be
+ * released
+ *
+ * @return
+ *         - \ref NVML_SUCCESS                 if the event has been
+ * successfully released
+ *         - \ref NVML_ERROR_UNINITIALIZED     if the library has not been
+ * successfully initialized
+ *         - \ref NVML_ERROR_UNKNOWN           on any unexpected error
+ */
+typedef nvmlReturn_t (*PFN_nvmlEventSetFree)(nvmlEventSet_t set);
+
 /**
  * Set the persistence mode for the device.
  *
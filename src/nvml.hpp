@@ -1,8 +1,12 @@
 #ifndef GPUFANCTL_NVML_HPP_INCLUDED
 #define GPUFANCTL_NVML_HPP_INCLUDED
 
+#include "backend.hpp"
 #include "nvml.h"
+#include <chrono>
 #include <cstddef>
+#include <string_view>
+#include <system_error>
 
 namespace gfc::nvml
 {
@@ -19,25 +23,210 @@ struct NVML
     PFN_nvmlDeviceSetDefaultFanSpeed_v2 nvmlDeviceSetDefaultFanSpeed_v2;
     PFN_nvmlDeviceGetNumFans nvmlDeviceGetNumFans;
     PFN_nvmlDeviceSetPersistenceMode nvmlDeviceSetPersistenceMode;
+    PFN_nvmlDeviceGetTemperatureThreshold nvmlDeviceGetTemperatureThreshold;
+
+    /* NOTE:
+     * Optional. These are null if the driver doesn't export them.
+     */
+    PFN_nvmlDeviceGetFanSpeed_v2 nvmlDeviceGetFanSpeed_v2;
+    PFN_nvmlDeviceGetTargetFanSpeed nvmlDeviceGetTargetFanSpeed;
+    PFN_nvmlDeviceGetMinMaxFanSpeed nvmlDeviceGetMinMaxFanSpeed;
+    PFN_nvmlDeviceGetFieldValues nvmlDeviceGetFieldValues;
+    PFN_nvmlDeviceGetCurrentClocksThrottleReasons
+        nvmlDeviceGetCurrentClocksThrottleReasons;
+    PFN_nvmlEventSetCreate nvmlEventSetCreate;
+    PFN_nvmlDeviceGetSupportedEventTypes nvmlDeviceGetSupportedEventTypes;
+    PFN_nvmlDeviceRegisterEvents nvmlDeviceRegisterEvents;
+    PFN_nvmlEventSetWait_v2 nvmlEventSetWait_v2;
+    PFN_nvmlEventSetFree nvmlEventSetFree;
+    PFN_nvmlDeviceGetPowerManagementLimitConstraints
+        nvmlDeviceGetPowerManagementLimitConstraints;
+    PFN_nvmlDeviceGetPowerManagementLimit nvmlDeviceGetPowerManagementLimit;
+    PFN_nvmlDeviceSetPowerManagementLimit nvmlDeviceSetPowerManagementLimit;
+    PFN_nvmlDeviceGetHandleByUUID nvmlDeviceGetHandleByUUID;
+    PFN_nvmlDeviceGetUUID nvmlDeviceGetUUID;
+    PFN_nvmlDeviceGetPciInfo_v3 nvmlDeviceGetPciInfo_v3;
 };
 
+/* NOTE:
+ * Overrides the library that `lib()` loads. Takes precedence over the
+ * `GPUFANCTL_NVML_LIBRARY` environment variable, which in turn takes
+ * precedence over the default `libnvidia-ml.so.1`. This has no effect once
+ * the library has been loaded.
+ */
+auto set_library_path(std::string_view path) -> void;
+
 auto lib() -> NVML const&;
 
+constexpr std::chrono::milliseconds kDefaultCallTimeout { 2000 };
+constexpr std::chrono::milliseconds kMaxCallTimeout { 60000 };
+
+/* NOTE:
+ * Sets the deadline for each NVML call. A call that hasn't returned by its
+ * deadline fails with `ErrorCodes::nvml_call_timeout`, and is left to
+ * complete (or not) on its own thread. A timeout of zero makes
+ * every call directly on the calling thread, blocking for as long as the
+ * driver does. Default `kDefaultCallTimeout`.
+ */
+auto set_call_timeout(std::chrono::milliseconds timeout) noexcept -> void;
+
+/* NOTE:
+ * The category of errors holding an `nvmlReturn_t`
+ */
+auto nvml_category() noexcept -> std::error_category const&;
+
+auto make_error_code(nvmlReturn_t result) noexcept -> std::error_code;
+
+/* NOTE:
+ * Describes an error returned by any of the functions here. NVML's own errors
+ * are described without allocating. Any other error gets its category's
+ * message from `error_message()`, which stays valid until the calling
+ * thread's next call.
+ */
+auto error_string(std::error_code const& ec) noexcept -> char const*;
+
+/* NOTE:
+ * A device's UUID, e.g. `GPU-5fb2...`, as a null-terminated string. It's a
+ * fixed size so that it can be passed to the NVML call threads by value.
+ */
+struct Uuid
+{
+    char value[NVML_DEVICE_UUID_V2_BUFFER_SIZE];
+};
+
+/* NOTE:
+ * The throwing functions throw a `std::system_error` holding either an error
+ * in `nvml_category()`, or `ErrorCodes::nvml_call_timeout`.
+ *
+ * The functions taking a `std::error_code&` report the same errors through
+ * `ec` instead, and never allocate. They're for the calls made on every
+ * tick, and may only be called once `init()` has returned. `init(ec)` may be
+ * used to initialize NVML again after it has been lost.
+ */
 auto init() -> void;
+auto init(std::error_code& ec) noexcept -> bool;
 auto shutdown() noexcept -> void;
 auto get_device_count() -> std::size_t;
 auto get_device_handle_by_index(unsigned int index) -> nvmlDevice_t;
+auto get_device_handle_by_index(unsigned int index,
+                                nvmlDevice_t& device,
+                                std::error_code& ec) noexcept -> bool;
+auto get_device_handle_by_uuid(Uuid const& uuid,
+                               nvmlDevice_t& device,
+                               std::error_code& ec) noexcept -> bool;
+auto get_device_uuid(nvmlDevice_t device,
+                     Uuid& uuid,
+                     std::error_code& ec) noexcept -> bool;
+auto get_device_pci_info(nvmlDevice_t device,
+                         nvmlPciInfo_t& pci,
+                         std::error_code& ec) noexcept -> bool;
 auto get_device_temperature(nvmlDevice_t device,
                             nvmlTemperatureSensors_t sensor_type)
     -> std::size_t;
+auto get_device_temperature(nvmlDevice_t device,
+                            nvmlTemperatureSensors_t sensor_type,
+                            unsigned int& temperature,
+                            std::error_code& ec) noexcept -> bool;
 auto set_device_fan_speed(nvmlDevice_t device,
                           unsigned int fan_index,
                           unsigned int pc) -> void;
+auto set_device_fan_speed(nvmlDevice_t device,
+                          unsigned int fan_index,
+                          unsigned int pc,
+                          std::error_code& ec) noexcept -> bool;
 auto set_device_default_fan_speed(nvmlDevice_t device, unsigned int fan_index)
     -> void;
+auto set_device_default_fan_speed(nvmlDevice_t device,
+                                  unsigned int fan_index,
+                                  std::error_code& ec) noexcept -> bool;
 auto get_device_fan_count(nvmlDevice_t device) -> unsigned int;
 auto set_device_persistence_mode(nvmlDevice_t device, nvmlEnableState_t state)
     -> void;
+
+/* NOTE:
+ * These fail with `NVML_ERROR_FUNCTION_NOT_FOUND` if the driver doesn't
+ * support them. `get_device_fan_speed` is the speed the fan is actually
+ * running at, and `get_device_target_fan_speed` is the speed it has been
+ * told to run at, either by us or by the driver.
+ */
+auto get_device_fan_speed(nvmlDevice_t device,
+                          unsigned int fan_index,
+                          unsigned int& speed,
+                          std::error_code& ec) noexcept -> bool;
+auto get_device_target_fan_speed(nvmlDevice_t device,
+                                 unsigned int fan_index,
+                                 unsigned int& speed,
+                                 std::error_code& ec) noexcept -> bool;
+auto get_device_min_max_fan_speed(nvmlDevice_t device,
+                                  unsigned int& min_speed,
+                                  unsigned int& max_speed,
+                                  std::error_code& ec) noexcept -> bool;
+
+auto get_device_temperature_threshold(nvmlDevice_t device,
+                                      nvmlTemperatureThresholds_t threshold,
+                                      unsigned int& temperature,
+                                      std::error_code& ec) noexcept -> bool;
+
+auto get_device_throttle_reasons(nvmlDevice_t device,
+                                 unsigned long long& reasons,
+                                 std::error_code& ec) noexcept -> bool;
+
+/* NOTE:
+ * Power limits are in milliwatts. Setting the limit needs root.
+ */
+auto get_device_power_limit_constraints(nvmlDevice_t device,
+                                        unsigned int& min_limit,
+                                        unsigned int& max_limit,
+                                        std::error_code& ec) noexcept -> bool;
+
+auto get_device_power_limit(nvmlDevice_t device,
+                            unsigned int& limit,
+                            std::error_code& ec) noexcept -> bool;
+
+auto set_device_power_limit(nvmlDevice_t device,
+                            unsigned int limit,
+                            std::error_code& ec) noexcept -> bool;
+
+auto create_event_set(nvmlEventSet_t& set, std::error_code& ec) noexcept
+    -> bool;
+auto free_event_set(nvmlEventSet_t set) noexcept -> void;
+auto get_device_supported_event_types(nvmlDevice_t device,
+                                      unsigned long long& event_types,
+                                      std::error_code& ec) noexcept -> bool;
+auto register_device_events(nvmlDevice_t device,
+                            unsigned long long event_types,
+                            nvmlEventSet_t set,
+                            std::error_code& ec) noexcept -> bool;
+
+/* NOTE:
+ * Unlike every other call, this is made directly on the calling thread,
+ * without a deadline, because it's expected to block for up to `timeout`.
+ * Fails with `NVML_ERROR_TIMEOUT` if no event arrives in time.
+ */
+auto wait_for_event(nvmlEventSet_t set,
+                    nvmlEventData_t& event,
+                    std::chrono::milliseconds timeout,
+                    std::error_code& ec) noexcept -> bool;
+
+/* NOTE:
+ * The throttle reasons that mean the GPU is too hot
+ */
+constexpr unsigned long long kThermalThrottleReasons =
+    nvmlClocksThrottleReasonSwThermalSlowdown |
+    nvmlClocksThrottleReasonHwThermalSlowdown;
+
+/* NOTE:
+ * Reads the GPU temperature, and then every other requested sensor in a
+ * single batched `nvmlDeviceGetFieldValues` call. The thermal slowdown comes
+ * from the throttle reasons, which aren't available as a field, so it takes
+ * one more call. Fails only if the
+ * GPU temperature can't be read, or if the device or NVML can't be used at
+ * all.
+ */
+auto sample_device(nvmlDevice_t device,
+                   SampleSensors const& sensors,
+                   Sample& sample,
+                   std::error_code& ec) noexcept -> bool;
 } // namespace gfc::nvml
 
 #endif // GPUFANCTL_NVML_HPP_INCLUDED
@@ -0,0 +1,160 @@
+#include "nvml_backend.hpp"
+#include "nvml.hpp"
+#include <mutex>
+#include <span>
+#include <system_error>
+#include <utility>
+
+namespace
+{
+/* NOTE:
+ * NVML is only initialized again if it has become uninitialized, so that
+ * its reference count stays balanced with the single `nvml::shutdown()` on
+ * exit. Devices are re-acquired one at a time, so that two devices that
+ * are lost together don't both initialize it.
+ *
+ * A reset can change the order that NVML enumerates devices in, so a device
+ * with a UUID is found by that rather than by its index.
+ */
+auto reacquire_device(unsigned int index,
+                      gfc::nvml::Uuid const& uuid,
+                      nvmlDevice_t& device,
+                      std::error_code& ec) noexcept -> bool
+{
+    static std::mutex mutex;
+    std::unique_lock lock { mutex };
+
+    auto const get_handle = [&](std::error_code& handle_ec) {
+        return uuid.value[0]
+                   ? gfc::nvml::get_device_handle_by_uuid(
+                         uuid, device, handle_ec)
+                   : gfc::nvml::get_device_handle_by_index(
+                         index, device, handle_ec);
+    };
+
+    if (get_handle(ec)) {
+        return true;
+    }
+
+    if (ec != gfc::nvml::make_error_code(NVML_ERROR_UNINITIALIZED)) {
+        return false;
+    }
+
+    ec.clear();
+    return gfc::nvml::init(ec) && get_handle(ec);
+}
+} // namespace
+
+namespace gfc
+{
+auto NvmlBackend::sample(SampleSensors const& sensors,
+                         Sample& sample,
+                         std::error_code& ec) noexcept -> bool
+{
+    return nvml::sample_device(handle, sensors, sample, ec);
+}
+
+auto NvmlBackend::fan_count() const noexcept -> unsigned int
+{
+    return fans;
+}
+
+auto NvmlBackend::set_fan_speed(unsigned int fan,
+                                unsigned int speed,
+                                std::error_code& ec) noexcept -> bool
+{
+    return nvml::set_device_fan_speed(handle, fan, speed, ec);
+}
+
+auto NvmlBackend::set_default_fan_speed(unsigned int fan,
+                                        std::error_code& ec) noexcept -> bool
+{
+    return nvml::set_device_default_fan_speed(handle, fan, ec);
+}
+
+auto NvmlBackend::get_target_fan_speed(unsigned int fan,
+                                       unsigned int& speed,
+                                       std::error_code& ec) noexcept -> bool
+{
+    return nvml::get_device_target_fan_speed(handle, fan, speed, ec);
+}
+
+auto NvmlBackend::get_fan_speed(unsigned int fan,
+                                unsigned int& speed,
+                                std::error_code& ec) noexcept -> bool
+{
+    return nvml::get_device_fan_speed(handle, fan, speed, ec);
+}
+
+auto NvmlBackend::get_power_limit_constraints(unsigned int& min_limit,
+                                              unsigned int& max_limit,
+                                              std::error_code& ec) noexcept
+    -> bool
+{
+    return nvml::get_device_power_limit_constraints(
+        handle, min_limit, max_limit, ec);
+}
+
+auto NvmlBackend::get_power_limit(unsigned int& limit,
+                                  std::error_code& ec) noexcept -> bool
+{
+    return nvml::get_device_power_limit(handle, limit, ec);
+}
+
+auto NvmlBackend::set_power_limit(unsigned int limit,
+                                  std::error_code& ec) noexcept -> bool
+{
+    return nvml::set_device_power_limit(handle, limit, ec);
+}
+
+auto NvmlBackend::reacquire(std::error_code& ec) noexcept -> bool
+{
+    nvmlDevice_t reacquired;
+    unsigned int temperature;
+    if (!reacquire_device(index, uuid, reacquired, ec) ||
+        !nvml::get_device_temperature(
+            reacquired, NVML_TEMPERATURE_GPU, temperature, ec)) {
+        return false;
+    }
+
+    handle = reacquired;
+    return true;
+}
+
+auto NvmlBackend::is_device_lost(std::error_code const& ec) noexcept -> bool
+{
+    return ec == nvml::make_error_code(NVML_ERROR_GPU_IS_LOST) ||
+           ec == nvml::make_error_code(NVML_ERROR_UNINITIALIZED);
+}
+
+auto NvmlBackend::is_unsupported(std::error_code const& ec) noexcept -> bool
+{
+    return ec == nvml::make_error_code(NVML_ERROR_NOT_SUPPORTED) ||
+           ec == nvml::make_error_code(NVML_ERROR_FUNCTION_NOT_FOUND);
+}
+
+auto NvmlBackend::error_string(std::error_code const& ec) noexcept
+    -> char const*
+{
+    return nvml::error_string(ec);
+}
+
+auto curve(Device const& device,
+           std::span<Slope const> slopes,
+           bool print_metrics_to_stdout,
+           bool closed_loop,
+           ControlSensor control_sensor) -> Curve
+{
+    NvmlBackend backend { device.index, device.handle, device.fan_count };
+    device.uuid.copy(backend.uuid.value, sizeof(backend.uuid.value) - 1);
+
+    return curve(std::move(backend),
+                 device.index,
+                 device.capabilities,
+                 slopes,
+                 print_metrics_to_stdout,
+                 closed_loop,
+                 control_sensor);
+}
+
+} // namespace gfc
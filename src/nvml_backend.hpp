@@ -0,0 +1,85 @@
+#ifndef GPUFANCTL_NVML_BACKEND_HPP_INCLUDED
+#define GPUFANCTL_NVML_BACKEND_HPP_INCLUDED
+
+#include "backend.hpp"
+#include "curve.hpp"
+#include "device.hpp"
+#include "nvml.h"
+#include "nvml.hpp"
+#include <span>
+#include <system_error>
+
+namespace gfc
+{
+
+/* NOTE:
+ * Controls an NVIDIA GPU's fans through NVML. `handle` changes when the
+ * device is re-acquired after it has been lost. The device is re-acquired by
+ * `uuid`, or by `index` if the UUID is empty.
+ */
+struct NvmlBackend
+{
+    auto sample(SampleSensors const& sensors,
+                Sample& sample,
+                std::error_code& ec) noexcept -> bool;
+
+    auto fan_count() const noexcept -> unsigned int;
+
+    auto set_fan_speed(unsigned int fan,
+                       unsigned int speed,
+                       std::error_code& ec) noexcept -> bool;
+
+    auto set_default_fan_speed(unsigned int fan, std::error_code& ec) noexcept
+        -> bool;
+
+    auto get_target_fan_speed(unsigned int fan,
+                              unsigned int& speed,
+                              std::error_code& ec) noexcept -> bool;
+
+    auto get_fan_speed(unsigned int fan,
+                       unsigned int& speed,
+                       std::error_code& ec) noexcept -> bool;
+
+    auto get_power_limit_constraints(unsigned int& min_limit,
+                                     unsigned int& max_limit,
+                                     std::error_code& ec) noexcept -> bool;
+
+    auto get_power_limit(unsigned int& limit, std::error_code& ec) noexcept
+        -> bool;
+
+    auto set_power_limit(unsigned int limit, std::error_code& ec) noexcept
+        -> bool;
+
+    /* NOTE:
+     * A handle isn't enough to show that the device is usable again, so it
+     * must also respond to a temperature query
+     */
+    auto reacquire(std::error_code& ec) noexcept -> bool;
+
+    static auto is_device_lost(std::error_code const& ec) noexcept -> bool;
+
+    static auto is_unsupported(std::error_code const& ec) noexcept -> bool;
+
+    static auto error_string(std::error_code const& ec) noexcept
+        -> char const*;
+
+    unsigned int index;
+    nvmlDevice_t handle;
+    unsigned int fans;
+    nvml::Uuid uuid {};
+};
+
+static_assert(RecoverableBackend<NvmlBackend>);
+static_assert(FanReadBackBackend<NvmlBackend>);
+static_assert(PowerLimitBackend<NvmlBackend>);
+
+using Curve = BasicCurve<NvmlBackend>;
+
+auto curve(Device const& device,
+           std::span<Slope const> slopes,
+           bool print_metrics_to_stdout = false,
+           bool closed_loop = false,
+           ControlSensor control_sensor = ControlSensor::gpu) -> Curve;
+
+} // namespace gfc
+#endif // GPUFANCTL_NVML_BACKEND_HPP_INCLUDED
@@ -0,0 +1,190 @@
+#include "nvml_stats.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdio>
+
+namespace
+{
+struct AtomicCallStats
+{
+    std::atomic_uint64_t calls;
+    std::atomic_uint64_t timeouts;
+    std::array<std::atomic_uint64_t, gfc::nvml::kLatencyBucketCount> latency;
+    std::array<std::atomic_uint64_t, gfc::nvml::kResultBucketCount> results;
+};
+
+auto call_stats() noexcept
+    -> std::array<AtomicCallStats, gfc::nvml::kEntryPointCount>&
+{
+    static std::array<AtomicCallStats, gfc::nvml::kEntryPointCount> stats {};
+    return stats;
+}
+
+auto call_stats(gfc::nvml::EntryPoint entry_point) noexcept -> AtomicCallStats&
+{
+    return call_stats()[static_cast<std::size_t>(entry_point)];
+}
+} // namespace
+
+namespace gfc::nvml
+{
+auto entry_point_name(EntryPoint entry_point) noexcept -> char const*
+{
+    switch (entry_point) {
+    case EntryPoint::init:
+        return "nvmlInit_v2";
+    case EntryPoint::shutdown:
+        return "nvmlShutdown";
+    case EntryPoint::get_device_count:
+        return "nvmlDeviceGetCount_v2";
+    case EntryPoint::get_device_handle_by_index:
+        return "nvmlDeviceGetHandleByIndex_v2";
+    case EntryPoint::get_device_temperature:
+        return "nvmlDeviceGetTemperature";
+    case EntryPoint::set_device_fan_speed:
+        return "nvmlDeviceSetFanSpeed_v2";
+    case EntryPoint::set_device_default_fan_speed:
+        return "nvmlDeviceSetDefaultFanSpeed_v2";
+    case EntryPoint::get_device_fan_count:
+        return "nvmlDeviceGetNumFans";
+    case EntryPoint::set_device_persistence_mode:
+        return "nvmlDeviceSetPersistenceMode";
+    case EntryPoint::get_device_fan_speed:
+        return "nvmlDeviceGetFanSpeed_v2";
+    case EntryPoint::get_device_target_fan_speed:
+        return "nvmlDeviceGetTargetFanSpeed";
+    case EntryPoint::get_device_min_max_fan_speed:
+        return "nvmlDeviceGetMinMaxFanSpeed";
+    case EntryPoint::get_device_temperature_threshold:
+        return "nvmlDeviceGetTemperatureThreshold";
+    case EntryPoint::get_device_field_values:
+        return "nvmlDeviceGetFieldValues";
+    case EntryPoint::get_device_throttle_reasons:
+        return "nvmlDeviceGetCurrentClocksThrottleReasons";
+    case EntryPoint::create_event_set:
+        return "nvmlEventSetCreate";
+    case EntryPoint::free_event_set:
+        return "nvmlEventSetFree";
+    case EntryPoint::get_device_supported_event_types:
+        return "nvmlDeviceGetSupportedEventTypes";
+    case EntryPoint::register_device_events:
+        return "nvmlDeviceRegisterEvents";
+    case EntryPoint::wait_for_event:
+        return "nvmlEventSetWait_v2";
+    case EntryPoint::get_device_power_limit_constraints:
+        return "nvmlDeviceGetPowerManagementLimitConstraints";
+    case EntryPoint::get_device_power_limit:
+        return "nvmlDeviceGetPowerManagementLimit";
+    case EntryPoint::set_device_power_limit:
+        return "nvmlDeviceSetPowerManagementLimit";
+    case EntryPoint::get_device_handle_by_uuid:
+        return "nvmlDeviceGetHandleByUUID";
+    case EntryPoint::get_device_uuid:
+        return "nvmlDeviceGetUUID";
+    case EntryPoint::get_device_pci_info:
+        return "nvmlDeviceGetPciInfo_v3";
+    }
+
+    return "Unknown";
+}
+
+auto latency_bucket(std::chrono::nanoseconds latency) noexcept -> std::size_t
+{
+    auto const ns = latency.count() > 0
+                        ? static_cast<std::uint64_t>(latency.count())
+                        : std::uint64_t { 0 };
+    return std::min(static_cast<std::size_t>(std::bit_width(ns)),
+                    kLatencyBucketCount - 1);
+}
+
+auto result_bucket(nvmlReturn_t result) noexcept -> std::size_t
+{
+    return std::min(static_cast<std::size_t>(result), kResultBucketCount - 1);
+}
+
+auto record_call(EntryPoint entry_point,
+                 std::chrono::nanoseconds latency,
+                 nvmlReturn_t result) noexcept -> void
+{
+    auto& stats = call_stats(entry_point);
+    stats.calls.fetch_add(1, std::memory_order_relaxed);
+    stats.latency[latency_bucket(latency)].fetch_add(
+        1, std::memory_order_relaxed);
+    stats.results[result_bucket(result)].fetch_add(1,
+                                                   std::memory_order_relaxed);
+}
+
+auto record_timeout(EntryPoint entry_point) noexcept -> void
+{
+    call_stats(entry_point).timeouts.fetch_add(1, std::memory_order_relaxed);
+}
+
+auto get_call_stats(EntryPoint entry_point) noexcept -> CallStats
+{
+    auto const& stats = call_stats(entry_point);
+    CallStats snapshot {};
+    snapshot.calls = stats.calls.load(std::memory_order_relaxed);
+    snapshot.timeouts = stats.timeouts.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < kLatencyBucketCount; ++i) {
+        snapshot.latency[i] = stats.latency[i].load(std::memory_order_relaxed);
+    }
+    for (std::size_t i = 0; i < kResultBucketCount; ++i) {
+        snapshot.results[i] = stats.results[i].load(std::memory_order_relaxed);
+    }
+
+    return snapshot;
+}
+
+auto print_call_stats(int fd) noexcept -> void
+{
+    dprintf(fd, "# nvml_call entry_point calls timeouts\n");
+    dprintf(fd, "# nvml_latency_ns entry_point less_than calls\n");
+    dprintf(fd, "# nvml_result entry_point result calls\n");
+
+    for (std::size_t i = 0; i < kEntryPointCount; ++i) {
+        auto const entry_point = static_cast<EntryPoint>(i);
+        auto const stats = get_call_stats(entry_point);
+        if (!stats.calls && !stats.timeouts) {
+            continue;
+        }
+
+        auto const* name = entry_point_name(entry_point);
+        dprintf(fd,
+                "# nvml_call %s %llu %llu\n",
+                name,
+                static_cast<unsigned long long>(stats.calls),
+                static_cast<unsigned long long>(stats.timeouts));
+
+        for (std::size_t bucket = 0; bucket < kLatencyBucketCount; ++bucket) {
+            if (!stats.latency[bucket]) {
+                continue;
+            }
+            dprintf(fd,
+                    "# nvml_latency_ns %s %llu %llu\n",
+                    name,
+                    1ull << bucket,
+                    static_cast<unsigned long long>(stats.latency[bucket]));
+        }
+
+        for (std::size_t bucket = 0; bucket < kResultBucketCount; ++bucket) {
+            if (!stats.results[bucket]) {
+                continue;
+            }
+            if (bucket == kResultBucketCount - 1) {
+                dprintf(fd,
+                        "# nvml_result %s other %llu\n",
+                        name,
+                        static_cast<unsigned long long>(stats.results[bucket]));
+            }
+            else {
+                dprintf(fd,
+                        "# nvml_result %s %zu %llu\n",
+                        name,
+                        bucket,
+                        static_cast<unsigned long long>(stats.results[bucket]));
+            }
+        }
+    }
+}
+} // namespace gfc::nvml
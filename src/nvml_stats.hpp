@@ -0,0 +1,97 @@
+#ifndef GPUFANCTL_NVML_STATS_HPP_INCLUDED
+#define GPUFANCTL_NVML_STATS_HPP_INCLUDED
+
+#include "nvml.h"
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace gfc::nvml
+{
+
+enum class EntryPoint : std::uint8_t
+{
+    init,
+    shutdown,
+    get_device_count,
+    get_device_handle_by_index,
+    get_device_temperature,
+    set_device_fan_speed,
+    set_device_default_fan_speed,
+    get_device_fan_count,
+    set_device_persistence_mode,
+    get_device_fan_speed,
+    get_device_target_fan_speed,
+    get_device_min_max_fan_speed,
+    get_device_temperature_threshold,
+    get_device_field_values,
+    get_device_throttle_reasons,
+    create_event_set,
+    free_event_set,
+    get_device_supported_event_types,
+    register_device_events,
+    wait_for_event,
+    get_device_power_limit_constraints,
+    get_device_power_limit,
+    set_device_power_limit,
+    get_device_handle_by_uuid,
+    get_device_uuid,
+    get_device_pci_info,
+};
+
+constexpr std::size_t kEntryPointCount =
+    static_cast<std::size_t>(EntryPoint::get_device_pci_info) + 1;
+
+/* NOTE:
+ * Latencies are counted in power-of-two buckets of nanoseconds. Bucket `N`
+ * counts calls that took less than `2^N` ns (and at least `2^(N-1)` ns). The
+ * last bucket also counts everything longer.
+ */
+constexpr std::size_t kLatencyBucketCount = 40;
+
+/* NOTE:
+ * Results are counted by their `nvmlReturn_t` value. The last bucket counts
+ * every result that doesn't fit in the others (e.g. `NVML_ERROR_UNKNOWN`).
+ */
+constexpr std::size_t kResultBucketCount = 32;
+
+struct CallStats
+{
+    std::uint64_t calls;
+    std::uint64_t timeouts;
+    std::array<std::uint64_t, kLatencyBucketCount> latency;
+    std::array<std::uint64_t, kResultBucketCount> results;
+};
+
+auto entry_point_name(EntryPoint entry_point) noexcept -> char const*;
+
+auto latency_bucket(std::chrono::nanoseconds latency) noexcept -> std::size_t;
+
+auto result_bucket(nvmlReturn_t result) noexcept -> std::size_t;
+
+/* NOTE:
+ * Records a call that has returned. This is lock-free, and cheap enough to
+ * be made on every call.
+ */
+auto record_call(EntryPoint entry_point,
+                 std::chrono::nanoseconds latency,
+                 nvmlReturn_t result) noexcept -> void;
+
+/* NOTE:
+ * Records a call that didn't return before its deadline. The call is still
+ * recorded with `record_call()` if and when it returns.
+ */
+auto record_timeout(EntryPoint entry_point) noexcept -> void;
+
+auto get_call_stats(EntryPoint entry_point) noexcept -> CallStats;
+
+/* NOTE:
+ * Prints the stats for every entry point that has been called to `fd`. Each
+ * line is prefixed with `#`, so that they can be mixed with the metrics
+ * output without confusing tools that read it.
+ */
+auto print_call_stats(int fd) noexcept -> void;
+
+} // namespace gfc::nvml
+#endif // GPUFANCTL_NVML_STATS_HPP_INCLUDED
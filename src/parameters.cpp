@@ -32,6 +32,81 @@ auto get_flag_description(Flags flag) noexcept -> char const*
         return R"#(Required when setting the --max-temperature above the default value)#";
     case Flags::persistence_mode:
         return R"#(Enable persistence mode)#";
+    case Flags::nvml_library:
+        return R"#(Load the NVML library from ARG instead of libnvidia-ml.so.1.
+            This can also be set with the GPUFANCTL_NVML_LIBRARY environment
+            variable)#";
+    case Flags::nvml_timeout:
+        return R"#(The deadline for each NVML call in milliseconds. If a call
+            doesn't return in time, the fans are set to 100% where possible.
+            0 waits on each call for as long as the driver takes. Default
+            2000.)#";
+    case Flags::closed_loop:
+        return R"#(Read back each fan's speed on every update, and only write
+            to fans that aren't set to the target speed. Fans that don't run
+            at the speed they're set to are reported.)#";
+    case Flags::temperature_sensor:
+        return R"#(The temperature that drives the fan curve. One of "gpu",
+            "memory" or "hottest" (the higher of the two). Default "gpu".)#";
+    case Flags::hwmon:
+        return R"#(Control the fans of the devices at the given hwmon paths,
+            separated by commas, rather than NVIDIA GPUs through NVML. E.g.
+            /sys/class/drm/card0/device/hwmon/hwmon2)#";
+    case Flags::power_governor:
+        return R"#(Lower a GPU's power limit in steps while its fans are at
+            the top of the curve and it's still getting hotter, and raise it
+            again as it cools. Needs root.)#";
+    case Flags::device:
+        return R"#(Only control the GPU with the given UUID or PCI bus ID, e.g.
+            GPU-5fb2c8e4-... or 01:00.0, optionally with a fan curve of its
+            own after an '='. May be given more than once.)#";
+    case Flags::fan_speed_table:
+        return R"#(With --print-fan-curve, prints the fan speed for every
+            degree up to the end of the curve, as used by the control loop,
+            instead of the curve points.)#";
+    case Flags::hysteresis:
+        return R"#(Hold the fan speed until the temperature has risen UP
+            degrees, or fallen DOWN degrees, from where it was last changed.
+            Given as UP[:DOWN], each at most 20. DOWN defaults to UP.)#";
+    case Flags::dwell_time:
+        return R"#(The shortest time in seconds between a change of fan
+            speed and slowing the fans down, at most 600. Speeding them up
+            isn't held back.)#";
+    case Flags::slew_rate:
+        return R"#(Ramp the fans to a new speed at ARG percent per second, in
+            small steps between updates, rather than in one step. Between 1
+            and 100. A thermal slowdown isn't ramped.)#";
+    case Flags::response_time:
+        return R"#(Smooth the fan speed with time constants in seconds for
+            when it's rising and when it's falling, given as ATTACK:RELEASE,
+            each at most 600. Prefix with SELECTOR= for a single device, as
+            with --device (or its path with --hwmon). May be given more than
+            once.)#";
+    case Flags::temperature_filter:
+        return R"#(Filter the sampled temperature before it drives the fan
+            curve. Either "ema:N", an exponential moving average over about
+            N samples (2 to 60), or "median:N", the median of the last N
+            samples (2 to 15).)#";
+    case Flags::target_temperature:
+        return R"#(Hold the temperature at ARG with a PID controller, rather
+            than following the fan curve, which is used as the controller's
+            starting point. Between 30 and --max-temperature.)#";
+    case Flags::pid_gains:
+        return R"#(The PID controller's gains, as KP:KI:KD, in percent of fan
+            speed per degree, per degree-second, and per degree per second.
+            Default 4:0.2:0.)#";
+    case Flags::spline:
+        return R"#(Join the fan curve points with a smooth curve that never
+            overshoots them, rather than straight lines. Also applies to
+            --print-fan-curve --table.)#";
+    case Flags::power_curve:
+        return R"#(WATTS=CURVE. The fan curve to use once the GPU draws WATTS
+            of power, in the same format as the main curve, which applies
+            from 0 W. Fan speeds are interpolated between curves by power
+            draw. Can be repeated.)#";
+    case Flags::wake_on_events:
+        return R"#(Update a GPU's fans as soon as it reports a clock or power
+            state change, as well as on every interval.)#";
     }
 
     return "";
@@ -3,16 +3,27 @@
 
 #include "cmdline.hpp"
 #include "cmdline_validation.hpp"
+#include "config.hpp"
 #include "errors.hpp"
+#include "nvml.hpp"
+#include "temperature_filter.hpp"
 #include <algorithm>
 #include <charconv>
+#include <chrono>
 #include <optional>
 #include <string_view>
 #include <system_error>
+#include <vector>
 namespace gfc
 {
 constexpr std::size_t const kDefaultIntervalSeconds = 5;
 constexpr std::size_t const kDefaultMaxTemperature = 80;
+constexpr unsigned int const kMaxHysteresis = 20;
+constexpr std::size_t const kMaxDwellTimeSeconds = 600;
+constexpr unsigned int const kMaxSlewRate = 100;
+constexpr std::size_t const kMaxResponseTimeSeconds = 600;
+constexpr unsigned int const kMinTargetTemperature = 30;
+constexpr unsigned int const kMaxPowerCurveWatts = 2000;
 
 namespace cmdline
 {
@@ -31,6 +42,24 @@ enum class Flags
     max_temperature,
     force,
     persistence_mode,
+    nvml_library,
+    nvml_timeout,
+    closed_loop,
+    temperature_sensor,
+    wake_on_events,
+    hwmon,
+    power_governor,
+    device,
+    fan_speed_table,
+    hysteresis,
+    dwell_time,
+    slew_rate,
+    response_time,
+    temperature_filter,
+    target_temperature,
+    pid_gains,
+    spline,
+    power_curve,
 };
 
 FlagDefinition<Flags> const flag_defs[] = {
@@ -72,6 +101,90 @@ FlagDefinition<Flags> const flag_defs[] = {
       "persistence-mode",
       FlagArgument::none,
       { Flags::print_fan_curve } },
+    { Flags::nvml_library, 0, "nvml-library", FlagArgument::required },
+    { Flags::nvml_timeout,
+      0,
+      "nvml-timeout",
+      FlagArgument::required,
+      {},
+      validation::in_integer_range<Flags, std::chrono::milliseconds::rep>(
+          0, nvml::kMaxCallTimeout.count()) },
+    { Flags::closed_loop,
+      0,
+      "closed-loop",
+      FlagArgument::none,
+      { Flags::print_fan_curve } },
+    { Flags::temperature_sensor,
+      0,
+      "temperature-sensor",
+      FlagArgument::required,
+      { Flags::print_fan_curve } },
+    { Flags::wake_on_events,
+      0,
+      "wake-on-events",
+      FlagArgument::none,
+      { Flags::print_fan_curve } },
+    { Flags::hwmon,
+      0,
+      "hwmon",
+      FlagArgument::required,
+      { Flags::print_fan_curve, Flags::persistence_mode } },
+    { Flags::power_governor,
+      0,
+      "power-governor",
+      FlagArgument::none,
+      { Flags::print_fan_curve } },
+    { Flags::device,
+      'd',
+      "device",
+      FlagArgument::required,
+      { Flags::print_fan_curve, Flags::hwmon } },
+    { Flags::fan_speed_table, 0, "table", FlagArgument::none },
+    { Flags::hysteresis,
+      0,
+      "hysteresis",
+      FlagArgument::required,
+      { Flags::print_fan_curve } },
+    { Flags::dwell_time,
+      0,
+      "dwell-time",
+      FlagArgument::required,
+      { Flags::print_fan_curve },
+      validation::in_integer_range<Flags, std::size_t>(
+          0, kMaxDwellTimeSeconds) },
+    { Flags::slew_rate,
+      0,
+      "slew-rate",
+      FlagArgument::required,
+      { Flags::print_fan_curve },
+      validation::in_integer_range<Flags, unsigned int>(1, kMaxSlewRate) },
+    { Flags::response_time,
+      0,
+      "response-time",
+      FlagArgument::required,
+      { Flags::print_fan_curve } },
+    { Flags::temperature_filter,
+      0,
+      "temperature-filter",
+      FlagArgument::required,
+      { Flags::print_fan_curve } },
+    { Flags::target_temperature,
+      0,
+      "target-temperature",
+      FlagArgument::required,
+      { Flags::print_fan_curve },
+      validation::is_integer<Flags>() },
+    { Flags::pid_gains,
+      0,
+      "pid-gains",
+      FlagArgument::required,
+      { Flags::print_fan_curve } },
+    { Flags::spline, 0, "spline", FlagArgument::none },
+    { Flags::power_curve,
+      0,
+      "power-curve",
+      FlagArgument::required,
+      { Flags::print_fan_curve } },
 };
 
 auto get_flag_description(Flags flag) noexcept -> char const*;
@@ -97,8 +210,43 @@ enum class DiagnosticLevel
     silent,
 };
 
+enum class TemperatureSensor
+{
+    gpu,
+    memory,
+    hottest,
+};
+
+enum class TemperatureFilter
+{
+    none,
+    ema,
+    median,
+};
+
 } // namespace app
 
+/* NOTE:
+ * From `--response-time [<SELECTOR>=]<ATTACK>:<RELEASE>`, in seconds. One
+ * without a selector applies to every device.
+ */
+struct ResponseTime
+{
+    std::string_view selector {};
+    std::size_t attack { 0 };
+    std::size_t release { 0 };
+};
+
+/* NOTE:
+ * From `--power-curve <WATTS>=<CURVE>`. The curve is parsed later, as the
+ * main curve is.
+ */
+struct PowerCurvePoints
+{
+    unsigned int power { 0 };
+    std::string_view curve_points_data {};
+};
+
 struct Parameters
 {
     app::Mode mode { app::Mode::temperature_control };
@@ -109,6 +257,50 @@ struct Parameters
     bool use_pidfile { true };
     std::size_t max_temperature { kDefaultMaxTemperature };
     bool enable_persistence_mode { false };
+    std::string_view nvml_library {};
+    std::optional<std::size_t> nvml_timeout {};
+    bool closed_loop { false };
+    app::TemperatureSensor temperature_sensor { app::TemperatureSensor::gpu };
+    bool wake_on_events { false };
+    std::string_view hwmon_paths {};
+    bool power_governor { false };
+
+    /* NOTE:
+     * Each is `<SELECTOR>[=<CURVE>]`, as given to `--device`
+     */
+    std::vector<std::string_view> devices {};
+    bool print_fan_speed_table { false };
+
+    /* NOTE:
+     * In degrees, from `--hysteresis <UP>[:<DOWN>]`. `DOWN` defaults to
+     * `UP`.
+     */
+    unsigned int hysteresis_up { 0 };
+    unsigned int hysteresis_down { 0 };
+    std::size_t dwell_time { 0 };
+
+    /* NOTE:
+     * In percent per second. 0 changes the fan speed in one step.
+     */
+    unsigned int slew_rate { 0 };
+    std::vector<ResponseTime> response_times {};
+
+    /* NOTE:
+     * The EMA's span, or the median's window, in samples
+     */
+    app::TemperatureFilter temperature_filter { app::TemperatureFilter::none };
+    unsigned int temperature_filter_size { 0 };
+
+    /* NOTE:
+     * From `--pid-gains <KP>:<KI>:<KD>`, which is only used along with
+     * `--target-temperature`
+     */
+    std::optional<unsigned int> target_temperature {};
+    double pid_proportional_gain { 4.0 };
+    double pid_integral_gain { 0.2 };
+    double pid_derivative_gain { 0.0 };
+    bool spline { false };
+    std::vector<PowerCurvePoints> power_curves {};
 };
 
 template <typename T>
@@ -145,6 +337,27 @@ set_parameters(CmdLine<cmdline::Flags, Allocator> const& cmdline,
         params.curve_points_data = cmdline.args()[0];
     }
 
+    /* NOTE:
+     * The built-in curve was validated against its own maximum temperature
+     * at build time, which can't be changed here
+     */
+    auto const use_builtin_curve =
+        !params.curve_points_data.size() && config::kBuiltinCurve.size();
+    if (use_builtin_curve) {
+        params.max_temperature = config::kBuiltinMaxTemperature;
+    }
+
+    /* NOTE:
+     * `--table` only changes what `--print-fan-curve` prints
+     */
+    if (cmdline.has_flag(cmdline::Flags::fan_speed_table)) {
+        if (params.mode != app::Mode::print_fan_curve) {
+            ec = make_error_code(ErrorCodes::invalid_flag_value);
+            return false;
+        }
+        params.print_fan_speed_table = true;
+    }
+
     auto const diag_flags = cmdline.get_flags(
         cmdline::Flags::silent, cmdline::Flags::quiet, cmdline::Flags::verbose);
 
@@ -183,6 +396,10 @@ set_parameters(CmdLine<cmdline::Flags, Allocator> const& cmdline,
 
     if (auto const& flag = cmdline.get_flag(cmdline::Flags::max_temperature);
         flag) {
+        if (use_builtin_curve) {
+            ec = make_error_code(ErrorCodes::builtin_curve_max_temperature);
+            return false;
+        }
         if (!convert_to_number(std::get<1>(*flag), params.max_temperature)) {
             ec = make_error_code(ErrorCodes::invalid_flag_value);
             return false;
@@ -198,6 +415,218 @@ set_parameters(CmdLine<cmdline::Flags, Allocator> const& cmdline,
         params.enable_persistence_mode = true;
     }
 
+    if (auto const& flag = cmdline.get_flag(cmdline::Flags::nvml_library);
+        flag) {
+        if (!std::get<1>(*flag) || !std::get<1>(*flag)->size()) {
+            ec = make_error_code(ErrorCodes::invalid_flag_value);
+            return false;
+        }
+        params.nvml_library = *std::get<1>(*flag);
+    }
+
+    if (auto const& flag = cmdline.get_flag(cmdline::Flags::hwmon); flag) {
+        if (!std::get<1>(*flag) || !std::get<1>(*flag)->size()) {
+            ec = make_error_code(ErrorCodes::invalid_flag_value);
+            return false;
+        }
+        params.hwmon_paths = *std::get<1>(*flag);
+    }
+
+    for (auto const& [id, value] : cmdline.flags()) {
+        if (id != cmdline::Flags::device) {
+            continue;
+        }
+
+        if (!value || !value->size() || value->front() == '=') {
+            ec = make_error_code(ErrorCodes::invalid_flag_value);
+            return false;
+        }
+        params.devices.push_back(*value);
+    }
+
+    if (auto const& flag = cmdline.get_flag(cmdline::Flags::nvml_timeout);
+        flag) {
+        std::size_t timeout;
+        if (!convert_to_number(std::get<1>(*flag), timeout)) {
+            ec = make_error_code(ErrorCodes::invalid_flag_value);
+            return false;
+        }
+        params.nvml_timeout = timeout;
+    }
+
+    if (auto const& flag = cmdline.get_flag(cmdline::Flags::hysteresis);
+        flag) {
+        auto const value = std::get<1>(*flag).value_or(std::string_view {});
+        auto const separator = value.find(':');
+        auto const up = value.substr(0, separator);
+        auto const down = separator == std::string_view::npos
+                              ? up
+                              : value.substr(separator + 1);
+        if (!convert_to_number(up, params.hysteresis_up) ||
+            !convert_to_number(down, params.hysteresis_down) ||
+            params.hysteresis_up > kMaxHysteresis ||
+            params.hysteresis_down > kMaxHysteresis) {
+            ec = make_error_code(ErrorCodes::invalid_flag_value);
+            return false;
+        }
+    }
+
+    if (auto const& flag = cmdline.get_flag(cmdline::Flags::dwell_time);
+        flag) {
+        if (!convert_to_number(std::get<1>(*flag), params.dwell_time)) {
+            ec = make_error_code(ErrorCodes::invalid_flag_value);
+            return false;
+        }
+    }
+
+    if (auto const& flag = cmdline.get_flag(cmdline::Flags::slew_rate);
+        flag) {
+        if (!convert_to_number(std::get<1>(*flag), params.slew_rate)) {
+            ec = make_error_code(ErrorCodes::invalid_flag_value);
+            return false;
+        }
+    }
+
+    for (auto const& [id, value] : cmdline.flags()) {
+        if (id != cmdline::Flags::response_time) {
+            continue;
+        }
+
+        auto const text = value.value_or(std::string_view {});
+        auto const equals = text.find('=');
+        auto const times =
+            equals == std::string_view::npos ? text : text.substr(equals + 1);
+        auto const colon = times.find(':');
+
+        ResponseTime response_time {};
+        if (equals != std::string_view::npos) {
+            response_time.selector = text.substr(0, equals);
+        }
+
+        if ((equals != std::string_view::npos &&
+             !response_time.selector.size()) ||
+            colon == std::string_view::npos ||
+            !convert_to_number(times.substr(0, colon),
+                               response_time.attack) ||
+            !convert_to_number(times.substr(colon + 1),
+                               response_time.release) ||
+            response_time.attack > kMaxResponseTimeSeconds ||
+            response_time.release > kMaxResponseTimeSeconds) {
+            ec = make_error_code(ErrorCodes::invalid_flag_value);
+            return false;
+        }
+        params.response_times.push_back(response_time);
+    }
+
+    if (auto const& flag =
+            cmdline.get_flag(cmdline::Flags::temperature_filter);
+        flag) {
+        auto const value = std::get<1>(*flag).value_or(std::string_view {});
+        auto const colon = value.find(':');
+        auto const kind = value.substr(0, colon);
+        std::size_t max_size = 0;
+        if (kind == "ema") {
+            params.temperature_filter = app::TemperatureFilter::ema;
+            max_size = EmaTemperatureFilter::kMaxSpan;
+        }
+        else if (kind == "median") {
+            params.temperature_filter = app::TemperatureFilter::median;
+            max_size = MedianTemperatureFilter::kMaxWindow;
+        }
+
+        if (!max_size || colon == std::string_view::npos ||
+            !convert_to_number(value.substr(colon + 1),
+                               params.temperature_filter_size) ||
+            params.temperature_filter_size < 2 ||
+            params.temperature_filter_size > max_size) {
+            ec = make_error_code(ErrorCodes::invalid_flag_value);
+            return false;
+        }
+    }
+
+    /* NOTE:
+     * The target can't be above the maximum temperature, which is parsed
+     * before this
+     */
+    if (auto const& flag =
+            cmdline.get_flag(cmdline::Flags::target_temperature);
+        flag) {
+        unsigned int target;
+        if (!convert_to_number(std::get<1>(*flag), target) ||
+            target < kMinTargetTemperature ||
+            target > params.max_temperature) {
+            ec = make_error_code(ErrorCodes::invalid_flag_value);
+            return false;
+        }
+        params.target_temperature = target;
+    }
+
+    if (auto const& flag = cmdline.get_flag(cmdline::Flags::pid_gains);
+        flag) {
+        auto const value = std::get<1>(*flag).value_or(std::string_view {});
+        auto const first = value.find(':');
+        auto const second = first == std::string_view::npos
+                                ? std::string_view::npos
+                                : value.find(':', first + 1);
+        if (!params.target_temperature ||
+            second == std::string_view::npos ||
+            !convert_to_number(value.substr(0, first),
+                               params.pid_proportional_gain) ||
+            !convert_to_number(value.substr(first + 1, second - first - 1),
+                               params.pid_integral_gain) ||
+            !convert_to_number(value.substr(second + 1),
+                               params.pid_derivative_gain) ||
+            params.pid_proportional_gain < 0 ||
+            params.pid_integral_gain < 0 || params.pid_derivative_gain < 0) {
+            ec = make_error_code(ErrorCodes::invalid_flag_value);
+            return false;
+        }
+    }
+
+    for (auto const& [id, value] : cmdline.flags()) {
+        if (id != cmdline::Flags::power_curve) {
+            continue;
+        }
+
+        auto const text = value.value_or(std::string_view {});
+        auto const equals = text.find('=');
+
+        PowerCurvePoints power_curve {};
+        if (equals == std::string_view::npos ||
+            !convert_to_number(text.substr(0, equals), power_curve.power) ||
+            power_curve.power < 1 || power_curve.power > kMaxPowerCurveWatts ||
+            equals + 1 == text.size()) {
+            ec = make_error_code(ErrorCodes::invalid_flag_value);
+            return false;
+        }
+        power_curve.curve_points_data = text.substr(equals + 1);
+        params.power_curves.push_back(power_curve);
+    }
+
+    params.closed_loop = cmdline.has_flag(cmdline::Flags::closed_loop);
+    params.spline = cmdline.has_flag(cmdline::Flags::spline);
+    params.wake_on_events = cmdline.has_flag(cmdline::Flags::wake_on_events);
+    params.power_governor = cmdline.has_flag(cmdline::Flags::power_governor);
+
+    if (auto const& flag =
+            cmdline.get_flag(cmdline::Flags::temperature_sensor);
+        flag) {
+        auto const& val = std::get<1>(*flag);
+        if (val == "gpu") {
+            params.temperature_sensor = app::TemperatureSensor::gpu;
+        }
+        else if (val == "memory") {
+            params.temperature_sensor = app::TemperatureSensor::memory;
+        }
+        else if (val == "hottest") {
+            params.temperature_sensor = app::TemperatureSensor::hottest;
+        }
+        else {
+            ec = make_error_code(ErrorCodes::invalid_flag_value);
+            return false;
+        }
+    }
+
     return true;
 }
 
@@ -1,10 +1,16 @@
 #ifndef GPUFANCTL_PARSING_HPP_INCLUDED
 #define GPUFANCTL_PARSING_HPP_INCLUDED
 
+#include "errors.hpp"
 #include "slope.hpp"
 #include "utils.hpp"
 #include "validation.hpp"
+#include <array>
+#include <cstddef>
+#include <limits>
 #include <memory>
+#include <optional>
+#include <span>
 #include <string_view>
 #include <system_error>
 #include <vector>
@@ -12,10 +18,132 @@
 namespace gfc
 {
 
+namespace detail
+{
+constexpr auto parse_number(std::string_view input,
+                            unsigned int& output) noexcept -> bool
+{
+    if (!input.size()) {
+        return false;
+    }
+
+    unsigned long long value = 0;
+    for (auto const c : input) {
+        if (c < '0' || c > '9') {
+            return false;
+        }
+
+        value = value * 10 + static_cast<unsigned int>(c - '0');
+        if (value > std::numeric_limits<unsigned int>::max()) {
+            return false;
+        }
+    }
+
+    output = static_cast<unsigned int>(value);
+    return true;
+}
+} // namespace detail
+
+/* NOTE:
+ * Parses a `<TEMP>:<SPEED>` pair, which may be surrounded by spaces. It's
+ * constexpr, so that a curve can be parsed at compile time, and returns the
+ * error rather than setting a `std::error_code`.
+ */
+constexpr auto parse_curve_point(std::string_view input,
+                                 CurvePoint& output) noexcept
+    -> std::optional<ErrorCodes>
+{
+    while (input.size() && input.front() == ' ') {
+        input.remove_prefix(1);
+    }
+    while (input.size() && input.back() == ' ') {
+        input.remove_suffix(1);
+    }
+
+    auto const sep = input.find(':');
+    if (sep == std::string_view::npos ||
+        !detail::parse_number(input.substr(0, sep), output.temperature) ||
+        !detail::parse_number(input.substr(sep + 1), output.fan_speed)) {
+        return ErrorCodes::invalid_curve_point;
+    }
+
+    return std::nullopt;
+}
+
 auto parse_curve_point(std::string_view input,
                        CurvePoint& output,
                        std::error_code& ec) noexcept -> bool;
 
+/* NOTE:
+ * A curve's points, held without allocating
+ */
+template <std::size_t Capacity>
+struct FixedCurvePoints
+{
+    constexpr auto view() const noexcept -> std::span<CurvePoint const>
+    {
+        return { points.data(), size };
+    }
+
+    std::array<CurvePoint, Capacity> points {};
+    std::size_t size { 0 };
+};
+
+/* NOTE:
+ * The constexpr counterpart of `parse_curve()`, for curves that are parsed
+ * at compile time. The points are validated, and completed with a point at
+ * `max_temperature` in the same way.
+ */
+template <std::size_t Capacity, typename PointDelimiter>
+constexpr auto parse_fixed_curve(std::string_view input,
+                                 PointDelimiter const& delimiter,
+                                 std::size_t max_temperature,
+                                 FixedCurvePoints<Capacity>& output) noexcept
+    -> std::optional<ErrorCodes>
+{
+    output = FixedCurvePoints<Capacity> {};
+
+    while (input.size()) {
+        std::size_t length = 0;
+        while (length < input.size() && input[length] != delimiter) {
+            ++length;
+        }
+
+        if (length) {
+            if (output.size == Capacity) {
+                return ErrorCodes::too_many_curve_points;
+            }
+
+            if (auto const error = parse_curve_point(
+                    input.substr(0, length), output.points[output.size]);
+                error) {
+                return error;
+            }
+            output.size += 1;
+        }
+
+        input.remove_prefix(length < input.size() ? length + 1 : length);
+    }
+
+    if (auto const error = find_curve_error(output.view(), max_temperature);
+        error) {
+        return error;
+    }
+
+    if (output.size &&
+        output.points[output.size - 1].temperature < max_temperature) {
+        if (output.size == Capacity) {
+            return ErrorCodes::too_many_curve_points;
+        }
+
+        output.points[output.size] =
+            CurvePoint { static_cast<unsigned int>(max_temperature), 100u };
+        output.size += 1;
+    }
+
+    return std::nullopt;
+}
+
 template <typename OutputIterator, typename PointDelimiter>
 auto parse_curve_points(std::string_view input,
                         OutputIterator output,
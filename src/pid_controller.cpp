@@ -0,0 +1,56 @@
+#include "pid_controller.hpp"
+#include <algorithm>
+
+namespace gfc
+{
+auto PidController::operator()(unsigned int temperature,
+                               double feed_forward,
+                               double seconds) noexcept -> double
+{
+    auto const measured = static_cast<double>(temperature);
+    auto const error = measured - static_cast<double>(setpoint);
+
+    /* NOTE:
+     * Without a previous temperature, or any time since it, there's no rate
+     * of change and nothing to integrate over
+     */
+    auto const has_history = previous_temperature >= 0 && seconds > 0;
+    auto const derivative =
+        has_history ? gains.derivative * (measured - previous_temperature) /
+                          seconds
+                    : 0.0;
+    previous_temperature = measured;
+
+    /* NOTE:
+     * The integral only grows as far as it takes to saturate the output,
+     * so it unwinds as soon as the error changes sign
+     */
+    auto const proportional = gains.proportional * error;
+    auto const base = feed_forward + proportional + derivative;
+    auto const candidate =
+        integral + (has_history ? gains.integral * error * seconds : 0.0);
+    if (error > 0) {
+        integral = std::max(integral, std::min(candidate, max_output - base));
+    }
+    else if (error < 0) {
+        integral = std::min(integral, std::max(candidate, min_output - base));
+    }
+
+    auto const range = max_output - min_output;
+    integral = std::clamp(integral, -range, range);
+
+    auto const output =
+        std::clamp(base + integral, min_output, max_output);
+
+    terms = PidTerms { proportional, integral, derivative, output };
+    return output;
+}
+
+auto PidController::reset() noexcept -> void
+{
+    integral = 0;
+    previous_temperature = -1;
+    terms = PidTerms {};
+}
+
+} // namespace gfc
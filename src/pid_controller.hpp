@@ -0,0 +1,63 @@
+#ifndef GPUFANCTL_PID_CONTROLLER_HPP_INCLUDED
+#define GPUFANCTL_PID_CONTROLLER_HPP_INCLUDED
+
+namespace gfc
+{
+
+/* NOTE:
+ * `proportional` is in percent of fan speed per degree above the setpoint,
+ * `integral` in percent per degree-second, and `derivative` in percent per
+ * degree per second of change
+ */
+struct PidGains
+{
+    double proportional { 4.0 };
+    double integral { 0.2 };
+    double derivative { 0.0 };
+};
+
+/* NOTE:
+ * The parts of the last output, for the metrics. `integral` is the
+ * accumulated term, after anti-windup.
+ */
+struct PidTerms
+{
+    double proportional { 0 };
+    double integral { 0 };
+    double derivative { 0 };
+    double output { 0 };
+};
+
+/* NOTE:
+ * Drives a temperature towards `setpoint` by adjusting the fan speed. The
+ * output is a feed-forward fan speed (e.g. from the fan curve) plus the
+ * PID terms, clamped to `[min_output, max_output]`.
+ *
+ * The derivative is of the temperature rather than the error, so a change
+ * of setpoint doesn't kick the output. The integral doesn't accumulate
+ * beyond what saturates the output, and is bounded by the output range, so
+ * it doesn't wind up while the fans are at their limit.
+ */
+struct PidController
+{
+    auto operator()(unsigned int temperature,
+                    double feed_forward,
+                    double seconds) noexcept -> double;
+
+    /* NOTE:
+     * Forgets the accumulated integral and the previous temperature, e.g.
+     * after the device has been re-acquired
+     */
+    auto reset() noexcept -> void;
+
+    unsigned int setpoint { 0 };
+    PidGains gains {};
+    double min_output { 0 };
+    double max_output { 100 };
+    double integral { 0 };
+    double previous_temperature { -1 };
+    PidTerms terms {};
+};
+
+} // namespace gfc
+#endif // GPUFANCTL_PID_CONTROLLER_HPP_INCLUDED
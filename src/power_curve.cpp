@@ -0,0 +1,81 @@
+#include "power_curve.hpp"
+#include "errors.hpp"
+#include <algorithm>
+#include <system_error>
+
+namespace
+{
+constexpr unsigned int kMilliwattsPerWatt = 1000;
+} // namespace
+
+namespace gfc
+{
+auto PowerCurve::operator()(unsigned int temperature,
+                            unsigned int power_usage) const noexcept
+    -> unsigned int
+{
+    if (!powers.size() || !width) {
+        return 0;
+    }
+
+    auto const column = std::min<std::size_t>(temperature, width - 1);
+    auto const upper =
+        std::upper_bound(powers.begin(), powers.end(), power_usage);
+    auto const row = static_cast<std::size_t>(
+        upper == powers.begin() ? 0 : upper - powers.begin() - 1);
+    auto const low = speeds[row * width + column];
+    if (upper == powers.begin() || upper == powers.end() || !low) {
+        return low;
+    }
+
+    auto const high = speeds[(row + 1) * width + column];
+    auto const range = *upper - powers[row];
+    auto const offset = power_usage - powers[row];
+    return low + static_cast<unsigned int>(
+                     (static_cast<unsigned long long>(high - low) * offset +
+                      range / 2) /
+                     range);
+}
+
+auto power_curve(std::span<PowerCurveRow const> rows) -> PowerCurve
+{
+    PowerCurve curve {};
+
+    std::vector<PowerCurveRow const*> sorted;
+    sorted.reserve(rows.size());
+    for (auto const& row : rows) {
+        sorted.push_back(&row);
+        curve.width = std::max(curve.width, row.table.speeds.size());
+    }
+    std::sort(sorted.begin(), sorted.end(), [](auto const* a, auto const* b) {
+        return a->power < b->power;
+    });
+
+    /* NOTE:
+     * Every row is as wide as the widest, with shorter rows extended by
+     * their last fan speed, as their tables would give
+     */
+    curve.powers.reserve(sorted.size());
+    curve.speeds.reserve(sorted.size() * curve.width);
+    for (auto const* row : sorted) {
+        if (curve.powers.size() &&
+            curve.powers.back() == row->power * kMilliwattsPerWatt) {
+            throw std::system_error { ErrorCodes::duplicate_power };
+        }
+        curve.powers.push_back(row->power * kMilliwattsPerWatt);
+
+        auto const offset = curve.speeds.size();
+        for (std::size_t t = 0; t < curve.width; ++t) {
+            auto const speed = static_cast<std::uint8_t>(
+                row->table(static_cast<unsigned int>(t)));
+            if (offset && speed < curve.speeds[offset - curve.width + t]) {
+                throw std::system_error { ErrorCodes::power_curve_order };
+            }
+            curve.speeds.push_back(speed);
+        }
+    }
+
+    return curve;
+}
+
+} // namespace gfc
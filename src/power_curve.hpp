@@ -0,0 +1,51 @@
+#ifndef GPUFANCTL_POWER_CURVE_HPP_INCLUDED
+#define GPUFANCTL_POWER_CURVE_HPP_INCLUDED
+
+#include "slope.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace gfc
+{
+
+/* NOTE:
+ * A fan curve that applies from `power` watts of power draw
+ */
+struct PowerCurveRow
+{
+    unsigned int power;
+    FanSpeedTable table;
+};
+
+/* NOTE:
+ * A fan curve over both temperature and power draw, so the fans can start
+ * rising as the power does, before the temperature catches up. It's a grid
+ * with one row per power, in milliwatts, of fan speeds at every whole
+ * degree. Between two rows, the fan speed is interpolated along the power
+ * draw, so with whole degrees this is a bilinear interpolation of the grid.
+ * A fan speed of 0 (the driver's default fan profile) isn't interpolated:
+ * the row below is used until the power reaches the row above. Power draw
+ * beyond the last row gets the last row, and an empty curve gives 0.
+ */
+struct PowerCurve
+{
+    auto operator()(unsigned int temperature,
+                    unsigned int power_usage) const noexcept -> unsigned int;
+
+    std::vector<unsigned int> powers {};
+    std::size_t width { 0 };
+    std::vector<std::uint8_t> speeds {};
+};
+
+/* NOTE:
+ * The rows can be in any order, but each must be for a different power,
+ * and none may give a lower fan speed than a row for a lower power at any
+ * temperature. Each row's table must already be monotonic, as any table
+ * built from a parsed curve is. Throws `std::system_error` if not.
+ */
+auto power_curve(std::span<PowerCurveRow const> rows) -> PowerCurve;
+
+} // namespace gfc
+#endif // GPUFANCTL_POWER_CURVE_HPP_INCLUDED
@@ -1,30 +1,132 @@
 #include "slope.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+#include <vector>
 
 namespace gfc
 {
-Slope::Slope(CurvePoint const& start, CurvePoint const& end) noexcept
-    : start_ { start }
-    , end_ { end }
-    , slope_value_ { static_cast<float>(end.fan_speed - start.fan_speed) /
-                     static_cast<float>(end.temperature - start.temperature) }
-    , y_intersect_ { static_cast<float>(end.fan_speed) -
-                     (slope_value_ * end.temperature) }
+auto FanSpeedTable::operator()(unsigned int temperature) const noexcept
+    -> unsigned int
 {
+    if (!speeds.size()) {
+        return 0;
+    }
+
+    return speeds[std::min<std::size_t>(temperature, speeds.size() - 1)];
 }
 
-auto Slope::start() const noexcept -> CurvePoint const& { return start_; }
+auto slope_arrays(std::span<Slope const> slopes) -> SlopeArrays
+{
+    SlopeArrays arrays {};
+    arrays.start_temperatures.reserve(slopes.size());
+    arrays.end_temperatures.reserve(slopes.size());
+    arrays.start_fan_speeds.reserve(slopes.size());
+    arrays.rates.reserve(slopes.size());
 
-auto Slope::end() const noexcept -> CurvePoint const& { return end_; }
+    for (auto const& slope : slopes) {
+        arrays.start_temperatures.push_back(slope.start().temperature);
+        arrays.end_temperatures.push_back(slope.end().temperature);
+        arrays.start_fan_speeds.push_back(slope.start().fan_speed);
+        arrays.rates.push_back(slope.rate());
+    }
 
-auto Slope::slope_value() const noexcept -> float { return slope_value_; }
+    if (slopes.size()) {
+        arrays.last_fan_speed = slopes.back().end().fan_speed;
+    }
 
-auto Slope::y_intersect() const noexcept -> float { return y_intersect_; }
+    return arrays;
+}
 
-auto Slope::operator()(unsigned int input_temperature) const noexcept
-    -> unsigned int
+/* NOTE:
+ * `evaluate_curve()` picks the first slope that ends at or beyond the
+ * temperature. Going through the slopes in order, a temperature past the
+ * end of the previous slope takes this slope's value, so the last slope to
+ * be applied is the one it would have picked. A temperature before the
+ * start of that slope gets 0, and one past the end of the curve gets the
+ * last fan speed.
+ */
+auto evaluate_curve(SlopeArrays const& curve,
+                    std::span<unsigned int const> temperatures,
+                    std::span<unsigned int> fan_speeds) noexcept -> void
 {
-    return static_cast<unsigned int>(slope_value_ * input_temperature +
-                                     y_intersect_);
+    auto const count = std::min(temperatures.size(), fan_speeds.size());
+    auto* const out = fan_speeds.data();
+    auto const* const in = temperatures.data();
+
+    if (!curve.size()) {
+        std::fill_n(out, count, 0u);
+        return;
+    }
+
+    for (std::size_t i = 0; i < curve.size(); ++i) {
+        auto const start = curve.start_temperatures[i];
+        auto const start_fan_speed = curve.start_fan_speeds[i];
+        auto const rate = static_cast<std::uint64_t>(curve.rates[i]);
+        auto const previous_end = i ? curve.end_temperatures[i - 1] : 0u;
+        auto const first = i == 0;
+
+        for (std::size_t j = 0; j < count; ++j) {
+            auto const t = in[j];
+            auto const delta =
+                static_cast<std::uint64_t>(t > start ? t - start : 0u);
+            auto const value =
+                start_fan_speed +
+                static_cast<unsigned int>((delta * rate) >>
+                                          Slope::kFractionBits);
+            auto const in_slope = first || t > previous_end;
+            out[j] = in_slope ? (t < start ? 0u : value) : out[j];
+        }
+    }
+
+    auto const end = curve.end_temperatures.back();
+    for (std::size_t j = 0; j < count; ++j) {
+        out[j] = in[j] > end ? curve.last_fan_speed : out[j];
+    }
+}
+
+auto evaluate_curves(std::span<SlopeArrays const> curves,
+                     std::span<unsigned int const> temperatures,
+                     std::span<unsigned int> fan_speeds) noexcept -> void
+{
+    for (std::size_t i = 0; i < curves.size(); ++i) {
+        auto const offset = i * temperatures.size();
+        if (offset >= fan_speeds.size()) {
+            return;
+        }
+
+        evaluate_curve(curves[i], temperatures, fan_speeds.subspan(offset));
+    }
+}
+
+/* NOTE:
+ * The entries come from evaluating the curve's slope arrays, so a lookup
+ * gives exactly what `evaluate_curve()` would. Fan speeds are validated to
+ * be no more than 100%, so they fit in a byte.
+ */
+auto fan_speed_table(std::span<Slope const> slopes) -> FanSpeedTable
+{
+    FanSpeedTable table {};
+    if (!slopes.size()) {
+        return table;
+    }
+
+    auto const size =
+        static_cast<std::size_t>(slopes.back().end().temperature) + 1;
+    std::vector<unsigned int> temperatures(size);
+    std::iota(temperatures.begin(), temperatures.end(), 0u);
+    std::vector<unsigned int> fan_speeds(size);
+    evaluate_curve(slope_arrays(slopes), temperatures, fan_speeds);
+
+    table.speeds.resize(size);
+    std::transform(fan_speeds.begin(),
+                   fan_speeds.end(),
+                   table.speeds.begin(),
+                   [](unsigned int speed) {
+                       return static_cast<std::uint8_t>(std::min(speed, 255u));
+                   });
+
+    return table;
 }
 
 } // namespace gfc
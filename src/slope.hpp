@@ -1,8 +1,13 @@
 #ifndef GPUFANCTL_SLOPE_HPP_INCLUDED
 #define GPUFANCTL_SLOPE_HPP_INCLUDED
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
 #include <string_view>
 #include <system_error>
+#include <vector>
 
 namespace gfc
 {
@@ -13,26 +18,176 @@ struct CurvePoint
     unsigned int fan_speed;
 };
 
+/* NOTE:
+ * A straight line between two points of a fan curve. It's evaluated in
+ * 16.16 fixed-point, with the rate rounded up, which gives the same result
+ * as exact division for any slope spanning fewer than 256 degrees.
+ * Everything here is constexpr, so that curves can be built at compile time.
+ */
 struct Slope
 {
-    Slope(CurvePoint const& start, CurvePoint const& end) noexcept;
-    auto start() const noexcept -> CurvePoint const&;
+    static constexpr unsigned int kFractionBits = 16;
 
-    auto end() const noexcept -> CurvePoint const&;
+    constexpr Slope(CurvePoint const& start, CurvePoint const& end) noexcept
+        : start_ { start }
+        , end_ { end }
+        , rate_ { fixed_point_rate(start, end) }
+    {
+    }
 
-    auto slope_value() const noexcept -> float;
+    constexpr auto start() const noexcept -> CurvePoint const&
+    {
+        return start_;
+    }
 
-    auto y_intersect() const noexcept -> float;
+    constexpr auto end() const noexcept -> CurvePoint const& { return end_; }
 
-    auto operator()(unsigned int input_temperature) const noexcept
-        -> unsigned int;
+    /* NOTE:
+     * The fan speed gained per degree, in 16.16 fixed-point
+     */
+    constexpr auto rate() const noexcept -> std::uint32_t { return rate_; }
+
+    /* NOTE:
+     * The exact line through the two points, as fan speed per degree and
+     * the fan speed it would give at 0C. Evaluating the slope doesn't use
+     * these.
+     */
+    constexpr auto slope_value() const noexcept -> float
+    {
+        return static_cast<float>(static_cast<int>(end_.fan_speed) -
+                                  static_cast<int>(start_.fan_speed)) /
+               static_cast<float>(static_cast<int>(end_.temperature) -
+                                  static_cast<int>(start_.temperature));
+    }
+
+    constexpr auto y_intersect() const noexcept -> float
+    {
+        return static_cast<float>(end_.fan_speed) -
+               slope_value() * static_cast<float>(end_.temperature);
+    }
+
+    constexpr auto operator()(unsigned int input_temperature) const noexcept
+        -> unsigned int
+    {
+        if (input_temperature <= start_.temperature) {
+            return start_.fan_speed;
+        }
+
+        auto const delta = static_cast<std::uint64_t>(input_temperature -
+                                                      start_.temperature);
+        return start_.fan_speed +
+               static_cast<unsigned int>((delta * rate_) >> kFractionBits);
+    }
 
 private:
+    static constexpr auto fixed_point_rate(CurvePoint const& start,
+                                           CurvePoint const& end) noexcept
+        -> std::uint32_t
+    {
+        if (end.temperature <= start.temperature ||
+            end.fan_speed <= start.fan_speed) {
+            return 0;
+        }
+
+        auto const rise = static_cast<std::uint64_t>(end.fan_speed -
+                                                     start.fan_speed)
+                          << kFractionBits;
+        auto const run = end.temperature - start.temperature;
+        return static_cast<std::uint32_t>((rise + run - 1) / run);
+    }
+
     CurvePoint start_;
     CurvePoint end_;
-    float slope_value_;
-    float y_intersect_;
+    std::uint32_t rate_;
 };
 
+/* NOTE:
+ * The fan speed for `temperature` on the curve made of `slopes`. 0 (the
+ * driver's default fan profile) below the start of the curve, and the last
+ * fan speed beyond its end.
+ */
+constexpr auto evaluate_curve(std::span<Slope const> slopes,
+                              unsigned int temperature) noexcept
+    -> unsigned int
+{
+    if (!slopes.size()) {
+        return 0;
+    }
+
+    auto const slope_pos = std::lower_bound(
+        slopes.begin(),
+        slopes.end(),
+        temperature,
+        [&](auto const& a, auto const& b) { return a.end().temperature < b; });
+
+    if (slope_pos == slopes.end()) {
+        return slopes.back().end().fan_speed;
+    }
+
+    auto const& slope = *slope_pos;
+
+    if (temperature < slope.start().temperature) {
+        return 0;
+    }
+
+    return slope(temperature);
+}
+
+/* NOTE:
+ * A curve's slopes laid out as one array per field, for evaluating it at
+ * many temperatures in one pass. Built by `slope_arrays()`, so the slopes
+ * are in curve order.
+ */
+struct SlopeArrays
+{
+    auto size() const noexcept -> std::size_t
+    {
+        return start_temperatures.size();
+    }
+
+    std::vector<unsigned int> start_temperatures {};
+    std::vector<unsigned int> end_temperatures {};
+    std::vector<unsigned int> start_fan_speeds {};
+    std::vector<std::uint32_t> rates {};
+    unsigned int last_fan_speed { 0 };
+};
+
+auto slope_arrays(std::span<Slope const> slopes) -> SlopeArrays;
+
+/* NOTE:
+ * Evaluates the curve at each of `temperatures`, writing to the same index
+ * of `fan_speeds`, which must be at least as long. Gives exactly what
+ * `evaluate_curve()` gives for each temperature. Each slope is applied to
+ * every temperature in turn, without branching, so the inner loop can be
+ * vectorised.
+ */
+auto evaluate_curve(SlopeArrays const& curve,
+                    std::span<unsigned int const> temperatures,
+                    std::span<unsigned int> fan_speeds) noexcept -> void;
+
+/* NOTE:
+ * Evaluates each of `curves` against the same `temperatures`. The results
+ * are written one curve after another, so `fan_speeds` must hold
+ * `curves.size() * temperatures.size()` entries.
+ */
+auto evaluate_curves(std::span<SlopeArrays const> curves,
+                     std::span<unsigned int const> temperatures,
+                     std::span<unsigned int> fan_speeds) noexcept -> void;
+
+/* NOTE:
+ * A curve evaluated at every whole degree from 0 to its end, one byte per
+ * degree, so that looking up a fan speed is a single load. Temperatures
+ * beyond the end of the curve get the last entry, and an empty table gives
+ * 0.
+ */
+struct FanSpeedTable
+{
+    auto operator()(unsigned int temperature) const noexcept -> unsigned int;
+
+    std::vector<std::uint8_t> speeds {};
+};
+
+auto fan_speed_table(std::span<Slope const> slopes) -> FanSpeedTable;
+
 } // namespace gfc
 #endif // GPUFANCTL_SLOPE_HPP_INCLUDED
@@ -0,0 +1,119 @@
+#include "spline.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace gfc
+{
+auto MonotoneSpline::operator()(unsigned int temperature) const noexcept
+    -> unsigned int
+{
+    if (!segments.size() ||
+        temperature < segments.front().start_temperature) {
+        return 0;
+    }
+
+    if (temperature > segments.back().end_temperature) {
+        return last_fan_speed;
+    }
+
+    auto const segment = std::lower_bound(
+        segments.begin(),
+        segments.end(),
+        temperature,
+        [](auto const& a, auto const& b) { return a.end_temperature < b; });
+
+    auto const s =
+        static_cast<double>(temperature - segment->start_temperature);
+    auto const value =
+        segment->c0 + s * (segment->c1 + s * (segment->c2 + s * segment->c3));
+    return static_cast<unsigned int>(std::lround(std::max(value, 0.0)));
+}
+
+auto monotone_spline(std::span<Slope const> slopes) -> MonotoneSpline
+{
+    MonotoneSpline spline {};
+    if (!slopes.size()) {
+        return spline;
+    }
+
+    auto const count = slopes.size();
+    std::vector<double> secants(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        auto const& slope = slopes[i];
+        secants[i] = (static_cast<double>(slope.end().fan_speed) -
+                      static_cast<double>(slope.start().fan_speed)) /
+                     static_cast<double>(slope.end().temperature -
+                                         slope.start().temperature);
+    }
+
+    /* NOTE:
+     * The tangent at each point starts as the average of the secants on
+     * either side of it, or 0 where the curve is flat on either side. It's
+     * then scaled down wherever it would overshoot the next point.
+     */
+    std::vector<double> tangents(count + 1);
+    tangents.front() = secants.front();
+    tangents.back() = secants.back();
+    for (std::size_t i = 1; i < count; ++i) {
+        tangents[i] = secants[i - 1] > 0 && secants[i] > 0
+                          ? (secants[i - 1] + secants[i]) / 2
+                          : 0.0;
+    }
+
+    for (std::size_t i = 0; i < count; ++i) {
+        if (secants[i] <= 0) {
+            tangents[i] = 0;
+            tangents[i + 1] = 0;
+            continue;
+        }
+
+        auto const alpha = tangents[i] / secants[i];
+        auto const beta = tangents[i + 1] / secants[i];
+        auto const magnitude = alpha * alpha + beta * beta;
+        if (magnitude > 9) {
+            auto const tau = 3 / std::sqrt(magnitude);
+            tangents[i] = tau * alpha * secants[i];
+            tangents[i + 1] = tau * beta * secants[i];
+        }
+    }
+
+    spline.segments.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        auto const& slope = slopes[i];
+        auto const width = static_cast<double>(slope.end().temperature -
+                                               slope.start().temperature);
+        spline.segments.push_back(SplineSegment {
+            slope.start().temperature,
+            slope.end().temperature,
+            static_cast<double>(slope.start().fan_speed),
+            tangents[i],
+            (3 * secants[i] - 2 * tangents[i] - tangents[i + 1]) / width,
+            (tangents[i] + tangents[i + 1] - 2 * secants[i]) /
+                (width * width) });
+    }
+
+    spline.last_fan_speed = slopes.back().end().fan_speed;
+    return spline;
+}
+
+auto spline_fan_speed_table(MonotoneSpline const& spline)
+    -> FanSpeedTable
+{
+    FanSpeedTable table {};
+    if (!spline.segments.size()) {
+        return table;
+    }
+
+    auto const last_temperature = spline.segments.back().end_temperature;
+    table.speeds.resize(static_cast<std::size_t>(last_temperature) + 1);
+    for (unsigned int t = 0; t <= last_temperature; ++t) {
+        table.speeds[t] =
+            static_cast<std::uint8_t>(std::min(spline(t), 255u));
+    }
+
+    return table;
+}
+
+} // namespace gfc
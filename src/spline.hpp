@@ -0,0 +1,51 @@
+#ifndef GPUFANCTL_SPLINE_HPP_INCLUDED
+#define GPUFANCTL_SPLINE_HPP_INCLUDED
+
+#include "slope.hpp"
+#include <span>
+#include <vector>
+
+namespace gfc
+{
+
+/* NOTE:
+ * One piece of a spline, between two points of the curve. The fan speed at
+ * `start_temperature + s` is `c0 + c1 s + c2 s^2 + c3 s^3`.
+ */
+struct SplineSegment
+{
+    unsigned int start_temperature;
+    unsigned int end_temperature;
+    double c0;
+    double c1;
+    double c2;
+    double c3;
+};
+
+/* NOTE:
+ * A curve through the same points as the slopes, but with a continuous
+ * rate of change, so it has no corners at the points. The tangents are
+ * limited as by Fritsch and Carlson, so each piece stays between the fan
+ * speeds at its ends, and a curve that never drops never drops between its
+ * points either. Like `evaluate_curve()`, it gives 0 below the start of the
+ * curve and the last fan speed beyond its end.
+ */
+struct MonotoneSpline
+{
+    auto operator()(unsigned int temperature) const noexcept -> unsigned int;
+
+    std::vector<SplineSegment> segments {};
+    unsigned int last_fan_speed { 0 };
+};
+
+/* NOTE:
+ * The coefficients are worked out here, once, so evaluating the spline
+ * is a polynomial per lookup, and its table is built from that
+ */
+auto monotone_spline(std::span<Slope const> slopes) -> MonotoneSpline;
+
+auto spline_fan_speed_table(MonotoneSpline const& spline)
+    -> FanSpeedTable;
+
+} // namespace gfc
+#endif // GPUFANCTL_SPLINE_HPP_INCLUDED
@@ -7,6 +7,9 @@
 #define TRY_ATTACH_SYMBOL(target, name, lib)                                   \
     ::gfc::attach_symbol(target, name, lib)
 
+#define ATTACH_OPTIONAL_SYMBOL(target, name, lib)                              \
+    ::gfc::attach_optional_symbol(target, name, lib)
+
 namespace gfc
 {
 template <typename F>
@@ -18,6 +21,18 @@ auto attach_symbol(F** fn, char const* name, void* lib) -> void
                                    name };
 }
 
+/* NOTE:
+ * As `attach_symbol()`, but leaves `*fn` null rather than throwing, for
+ * symbols that older drivers don't export
+ */
+template <typename F>
+auto attach_optional_symbol(F** fn, char const* name, void* lib) noexcept
+    -> bool
+{
+    *fn = reinterpret_cast<F*>(dlsym(lib, name));
+    return *fn != nullptr;
+}
+
 } // namespace gfc
 
 #endif // SHADOW_CAST_UTILS_SYMBOL_HPP_INCLUDED
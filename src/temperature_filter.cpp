@@ -0,0 +1,66 @@
+#include "temperature_filter.hpp"
+#include <algorithm>
+
+namespace gfc
+{
+auto NoTemperatureFilter::operator()(unsigned int temperature) noexcept
+    -> unsigned int
+{
+    return temperature;
+}
+
+EmaTemperatureFilter::EmaTemperatureFilter(unsigned int span_) noexcept
+    : span { std::clamp(span_, 1u, kMaxSpan) }
+{
+}
+
+auto EmaTemperatureFilter::operator()(unsigned int temperature) noexcept
+    -> unsigned int
+{
+    auto const sample = static_cast<std::int64_t>(temperature)
+                        << kFractionBits;
+    if (average < 0) {
+        average = sample;
+    }
+    else {
+        average += (sample - average) * 2 / (span + 1);
+    }
+
+    return static_cast<unsigned int>(
+        (average + (std::int64_t { 1 } << (kFractionBits - 1))) >>
+        kFractionBits);
+}
+
+MedianTemperatureFilter::MedianTemperatureFilter(unsigned int window_) noexcept
+    : window { std::clamp<std::size_t>(window_, 1, kMaxWindow) }
+{
+}
+
+auto MedianTemperatureFilter::operator()(unsigned int temperature) noexcept
+    -> unsigned int
+{
+    if (!filled) {
+        std::fill_n(samples.begin(), window, temperature);
+        filled = true;
+    }
+
+    samples[next] = temperature;
+    next = (next + 1) % window;
+
+    auto sorted = samples;
+    auto const middle =
+        sorted.begin() + static_cast<std::ptrdiff_t>(window / 2);
+    std::nth_element(sorted.begin(),
+                     middle,
+                     sorted.begin() + static_cast<std::ptrdiff_t>(window));
+    return *middle;
+}
+
+auto filter_temperature(TemperatureFilter& filter,
+                        unsigned int temperature) noexcept -> unsigned int
+{
+    return std::visit([&](auto& stage) { return stage(temperature); },
+                      filter);
+}
+
+} // namespace gfc
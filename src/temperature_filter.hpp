@@ -0,0 +1,79 @@
+#ifndef GPUFANCTL_TEMPERATURE_FILTER_HPP_INCLUDED
+#define GPUFANCTL_TEMPERATURE_FILTER_HPP_INCLUDED
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <variant>
+
+namespace gfc
+{
+
+/* NOTE:
+ * A stage between sampling the device and looking up the curve, which
+ * takes each raw temperature and gives the one to control by. Filters keep
+ * their state in fixed-size members, so filtering never allocates.
+ */
+template <typename T>
+concept TemperatureFilterStage =
+    requires(T& filter, unsigned int temperature) {
+        { filter(temperature) } noexcept -> std::same_as<unsigned int>;
+    };
+
+struct NoTemperatureFilter
+{
+    auto operator()(unsigned int temperature) noexcept -> unsigned int;
+};
+
+/* NOTE:
+ * An exponential moving average over about `span` samples, i.e. each sample
+ * is weighted by `2 / (span + 1)`. The average is kept in fixed-point, with
+ * `kFractionBits` bits of a degree, and starts at the first sample.
+ */
+struct EmaTemperatureFilter
+{
+    static constexpr unsigned int kMaxSpan = 60;
+    static constexpr unsigned int kFractionBits = 8;
+
+    explicit EmaTemperatureFilter(unsigned int span) noexcept;
+
+    auto operator()(unsigned int temperature) noexcept -> unsigned int;
+
+    unsigned int span;
+    std::int64_t average { -1 };
+};
+
+/* NOTE:
+ * The median of the last `window` samples. The window starts out filled
+ * with the first sample, so a spike while it fills is held back as it is
+ * later. With an even window, the higher of the two middle samples is
+ * used.
+ */
+struct MedianTemperatureFilter
+{
+    static constexpr std::size_t kMaxWindow = 15;
+
+    explicit MedianTemperatureFilter(unsigned int window) noexcept;
+
+    auto operator()(unsigned int temperature) noexcept -> unsigned int;
+
+    std::array<unsigned int, kMaxWindow> samples {};
+    std::size_t window;
+    bool filled { false };
+    std::size_t next { 0 };
+};
+
+static_assert(TemperatureFilterStage<NoTemperatureFilter>);
+static_assert(TemperatureFilterStage<EmaTemperatureFilter>);
+static_assert(TemperatureFilterStage<MedianTemperatureFilter>);
+
+using TemperatureFilter = std::variant<NoTemperatureFilter,
+                                       EmaTemperatureFilter,
+                                       MedianTemperatureFilter>;
+
+auto filter_temperature(TemperatureFilter& filter,
+                        unsigned int temperature) noexcept -> unsigned int;
+
+} // namespace gfc
+#endif // GPUFANCTL_TEMPERATURE_FILTER_HPP_INCLUDED
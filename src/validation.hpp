@@ -1,15 +1,59 @@
 #ifndef GPUFANCTL_VALIDATION_HPP_INCLUDED
 #define GPUFANCTL_VALIDATION_HPP_INCLUDED
 
+#include "errors.hpp"
 #include "slope.hpp"
+#include <cstddef>
+#include <optional>
 #include <span>
 #include <system_error>
 
 namespace gfc
 {
+/* NOTE:
+ * Returns the first problem with the curve points, if there is one. It's
+ * constexpr so that a curve built into the binary is checked by the
+ * compiler. An empty curve is valid.
+ */
+constexpr auto find_curve_error(std::span<CurvePoint const> points,
+                                std::size_t max_temperature) noexcept
+    -> std::optional<ErrorCodes>
+{
+    if (!points.size()) {
+        return std::nullopt;
+    }
+
+    if (points.size() < 2) {
+        return ErrorCodes::too_few_curve_points;
+    }
+
+    for (std::size_t i = 1; i < points.size(); ++i) {
+        auto const& first = points[i - 1];
+        auto const& second = points[i];
+
+        if (first.fan_speed > 100 || second.fan_speed > 100) {
+            return ErrorCodes::invalid_fan_speed;
+        }
+        if (second.temperature > max_temperature) {
+            return ErrorCodes::max_temperature_exceeded;
+        }
+        if (first.fan_speed > second.fan_speed) {
+            return ErrorCodes::negative_fan_curve;
+        }
+        if (first.temperature == second.temperature) {
+            return ErrorCodes::duplicate_temperature;
+        }
+        if (first.temperature > second.temperature) {
+            return ErrorCodes::temperature_order;
+        }
+    }
+
+    return std::nullopt;
+}
+
 auto validate_curve_points(std::span<CurvePoint const> points,
                            std::size_t max_temperature,
                            std::error_code& ec) noexcept -> bool;
-}
+} // namespace gfc
 
 #endif // GPUFANCTL_VALIDATION_HPP_INCLUDED
@@ -66,9 +66,29 @@ auto should_parse_cmdline_with_no_flag_defs() -> void
     EXPECT(cmdline.flags().size() == 0);
 }
 
+auto should_reject_flag_values_out_of_range() -> void
+{
+    std::span<gfc::FlagDefinition<gfc::cmdline::Flags> const> defs {
+        gfc::cmdline::flag_defs
+    };
+    auto const parse = [&](char const* flag, char const* value) {
+        char const* argv[] { flag, value };
+        return gfc::parse_cmdline({ argv, std::size(argv) }, defs);
+    };
+
+    EXPECT(parse("--dwell-time", "600").flags().size() == 1);
+    EXPECT_THROWS(parse("--dwell-time", "601"));
+    EXPECT(parse("--slew-rate", "100").flags().size() == 1);
+    EXPECT_THROWS(parse("--slew-rate", "0"));
+    EXPECT_THROWS(parse("--slew-rate", "101"));
+    EXPECT(parse("--nvml-timeout", "60000").flags().size() == 1);
+    EXPECT_THROWS(parse("--nvml-timeout", "60001"));
+}
+
 auto main() -> int
 {
     return testing::run({ TEST(should_parse_cmdline_with_no_args),
                           TEST(should_parse_cmdline),
-                          TEST(should_parse_cmdline_with_no_flag_defs) });
+                          TEST(should_parse_cmdline_with_no_flag_defs),
+                          TEST(should_reject_flag_values_out_of_range) });
 }
@@ -1,4 +1,6 @@
+#include "builtin_curve.hpp"
 #include "delimiter.hpp"
+#include "errors.hpp"
 #include "parsing.hpp"
 #include "slope.hpp"
 #include "testing.hpp"
@@ -7,6 +9,7 @@
 #include <iostream>
 #include <iterator>
 #include <system_error>
+#include <vector>
 
 auto should_split_string() -> void
 {
@@ -68,10 +71,70 @@ auto should_parse_empty_curve_spec() -> void
     EXPECT(curve.size() == 0);
 }
 
+/* NOTE:
+ * Checked by the compiler, as a built-in curve is
+ */
+static_assert([] {
+    gfc::CurvePoint point {};
+    return !gfc::parse_curve_point(" 35:30 ", point) &&
+           point.temperature == 35 && point.fan_speed == 30;
+}());
+
+static_assert([] {
+    gfc::CurvePoint point {};
+    return gfc::parse_curve_point("35x:30", point) ==
+               gfc::ErrorCodes::invalid_curve_point &&
+           gfc::parse_curve_point("35:30:20", point) ==
+               gfc::ErrorCodes::invalid_curve_point &&
+           gfc::parse_curve_point(":30", point) ==
+               gfc::ErrorCodes::invalid_curve_point;
+}());
+
+static_assert([] {
+    gfc::FixedCurvePoints<4> points {};
+    return gfc::parse_fixed_curve("40:30", ',', 80, points) ==
+               gfc::ErrorCodes::too_few_curve_points &&
+           gfc::parse_fixed_curve("40:30,30:50", ',', 80, points) ==
+               gfc::ErrorCodes::temperature_order &&
+           gfc::parse_fixed_curve("40:30,90:50", ',', 80, points) ==
+               gfc::ErrorCodes::max_temperature_exceeded &&
+           gfc::parse_fixed_curve("1:1,2:2,3:3,4:4,5:5", ',', 80, points) ==
+               gfc::ErrorCodes::too_many_curve_points;
+}());
+
+auto should_bake_curve_at_compile_time() -> void
+{
+    std::string_view constexpr definition = " 35:30,\n60:50\t70:80 ";
+    constexpr auto baked = gfc::bake_curve<80>(definition);
+
+    static_assert(baked.points.size == 4);
+    static_assert(baked.points.points[3].temperature == 80);
+    static_assert(baked.points.points[3].fan_speed == 100);
+    static_assert(baked.fan_speeds[34] == 0);
+    static_assert(baked.fan_speeds[35] == 30);
+    static_assert(baked.fan_speeds[65] == 65);
+    static_assert(baked.fan_speeds[80] == 100);
+
+    auto const slopes =
+        gfc::parse_curve(definition, gfc::CommaOrWhiteSpaceDelimiter {}, 80lu);
+    auto const table = gfc::fan_speed_table(slopes);
+    EXPECT(table.speeds == std::vector<std::uint8_t>(baked.fan_speeds.begin(),
+                                                     baked.fan_speeds.end()));
+
+    auto const baked_slopes = gfc::baked_slopes(baked);
+    EXPECT(baked_slopes.size() == slopes.size());
+    EXPECT(baked_slopes[1].start().temperature == 60);
+    EXPECT(baked_slopes[1].end().fan_speed == 80);
+
+    constexpr auto empty = gfc::bake_curve<80>("");
+    static_assert(!empty.points.size && !empty.fan_speeds[80]);
+}
+
 auto main() -> int
 {
     return testing::run({ TEST(should_parse_curve_point_pairs),
                           TEST(should_split_string),
                           TEST(should_parse_curve_spec),
-                          TEST(should_parse_empty_curve_spec) });
+                          TEST(should_parse_empty_curve_spec),
+                          TEST(should_bake_curve_at_compile_time) });
 }
@@ -5,12 +5,14 @@
 #include <atomic>
 #include <chrono>
 #include <exception>
+#include <functional>
 #include <iostream>
 #include <poll.h>
 #include <signal.h>
 #include <sys/poll.h>
 #include <thread>
 #include <utility>
+#include <vector>
 
 using namespace std::chrono_literals;
 
@@ -203,11 +205,190 @@ auto should_receive_signal()
     }
 }
 
+auto should_complete_timers_in_deadline_order()
+{
+    namespace ch = std::chrono;
+    using clock_type = ch::steady_clock;
+
+    ex::timer_context timers;
+    timers.run();
+    GFC_SCOPE_GUARD([&] { timers.stop(); });
+
+    std::atomic_int order = 0;
+    int first = -1;
+    int second = -1;
+
+    auto const start = clock_type::now();
+    std::vector<decltype(ex::then(
+        ex::schedule_at(get_scheduler(timers), start),
+        ex::just_from(std::function<void()> {})))>
+        work;
+    work.push_back(
+        ex::then(ex::schedule_at(get_scheduler(timers), start + 300ms),
+                 ex::just_from(std::function<void()> {
+                     [&] { second = order++; } })));
+    work.push_back(
+        ex::then(ex::schedule_at(get_scheduler(timers), start + 100ms),
+                 ex::just_from(std::function<void()> {
+                     [&] { first = order++; } })));
+
+    ex::sync_wait(ex::when_all(std::move(work)));
+
+    EXPECT(first == 0);
+    EXPECT(second == 1);
+    EXPECT(clock_type::now() - start >= 300ms);
+}
+
+auto should_not_delay_timers_behind_blocked_work()
+{
+    namespace ch = std::chrono;
+    using clock_type = ch::steady_clock;
+
+    ex::timer_context timers;
+    ex::static_thread_pool pool;
+    timers.run();
+    pool.run(2);
+    GFC_SCOPE_GUARD([&] {
+        pool.stop();
+        timers.stop();
+    });
+
+    auto const start = clock_type::now();
+    clock_type::duration fast_completed_after {};
+
+    std::vector<decltype(ex::then(
+        ex::schedule_after(get_scheduler(timers), 0ms),
+        ex::then(ex::schedule(get_scheduler(pool)),
+                 ex::just_from(std::function<void()> {}))))>
+        work;
+    work.push_back(ex::then(
+        ex::schedule_after(get_scheduler(timers), 0ms),
+        ex::then(ex::schedule(get_scheduler(pool)),
+                 ex::just_from(std::function<void()> {
+                     [] { std::this_thread::sleep_for(1s); } }))));
+    work.push_back(ex::then(
+        ex::schedule_after(get_scheduler(timers), 100ms),
+        ex::then(ex::schedule(get_scheduler(pool)),
+                 ex::just_from(std::function<void()> { [&] {
+                     fast_completed_after = clock_type::now() - start;
+                 } }))));
+
+    ex::sync_wait(ex::when_all(std::move(work)));
+
+    EXPECT(fast_completed_after < 500ms);
+}
+
+auto should_wake_timers_early()
+{
+    namespace ch = std::chrono;
+    using clock_type = ch::steady_clock;
+
+    ex::timer_context timers;
+    timers.run();
+    GFC_SCOPE_GUARD([&] { timers.stop(); });
+
+    std::atomic_bool wake = false;
+    bool completed = false;
+    auto const start = clock_type::now();
+
+    std::thread waker { [&] {
+        std::this_thread::sleep_for(100ms);
+        timers.wake(wake);
+    } };
+    GFC_SCOPE_GUARD([&] { waker.join(); });
+
+    ex::sync_wait(
+        ex::then(ex::schedule_at(get_scheduler(timers), start + 1h, wake),
+                 ex::just_from([&] { completed = true; })));
+
+    EXPECT(completed);
+    EXPECT(clock_type::now() - start < 1s);
+    EXPECT(!wake);
+
+    /* NOTE:
+     * A wake-up that arrives before the timer is scheduled isn't lost
+     */
+    completed = false;
+    timers.wake(wake);
+    ex::sync_wait(ex::then(
+        ex::schedule_at(get_scheduler(timers), clock_type::now() + 1h, wake),
+        ex::just_from([&] { completed = true; })));
+
+    EXPECT(completed);
+}
+
+auto should_stop_pending_timers()
+{
+    ex::timer_context timers;
+    ex::single_thread_context stop_thread;
+    timers.run();
+    stop_thread.run();
+    GFC_SCOPE_GUARD([&] {
+        stop_thread.stop();
+        timers.stop();
+    });
+
+    bool completed = false;
+
+    auto work = ex::stop_when(
+        ex::then(ex::schedule_after(get_scheduler(timers), 1h),
+                 ex::just_from([&] { completed = true; })),
+        ex::then(ex::schedule(get_scheduler(stop_thread)),
+                 ex::schedule_after(ex::inline_delay_scheduler {}, 100ms)));
+
+    ex::sync_wait(std::move(work));
+
+    EXPECT(!completed);
+}
+
+auto should_forward_stop_through_stop_when()
+{
+    ex::single_thread_context first_thread;
+    ex::single_thread_context second_thread;
+    ex::single_thread_context stop_thread;
+    first_thread.run();
+    second_thread.run();
+    stop_thread.run();
+
+    GFC_SCOPE_GUARD([&] {
+        first_thread.stop();
+        second_thread.stop();
+        stop_thread.stop();
+    });
+
+    auto work = ex::stop_when(
+        /* SEQUENCE...
+         * - An inner `stop_when` that would take an hour to complete by
+         *   itself
+         */
+        ex::stop_when(
+            ex::then(ex::schedule(get_scheduler(first_thread)),
+                     ex::schedule_after(ex::inline_delay_scheduler {}, 1h)),
+            ex::then(ex::schedule(get_scheduler(second_thread)),
+                     ex::schedule_after(ex::inline_delay_scheduler {}, 1h))),
+        /* SEQUENCE...
+         * - Schedule an operation on the stop thread
+         * - Wait for 100ms
+         * - Complete
+         */
+        ex::then(ex::schedule(get_scheduler(stop_thread)),
+                 ex::schedule_after(ex::inline_delay_scheduler {}, 100ms)));
+
+    auto const start = std::chrono::steady_clock::now();
+    ex::sync_wait(std::move(work));
+    EXPECT(std::chrono::steady_clock::now() - start < 1s);
+}
+
 auto main() -> int
 {
     return testing::run({ TEST(should_execute),
                           TEST(should_defer),
                           TEST(should_repeat),
                           TEST(should_run_interval_loop),
-                          TEST(should_stop) });
+                          TEST(should_stop),
+                          TEST(should_complete_timers_in_deadline_order),
+                          TEST(should_not_delay_timers_behind_blocked_work),
+                          TEST(should_wake_timers_early),
+                          TEST(should_stop_pending_timers),
+                          TEST(should_forward_stop_through_stop_when) });
 }
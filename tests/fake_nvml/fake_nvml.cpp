@@ -0,0 +1,1420 @@
+#include "fake_nvml.h"
+#include "nvml.h"
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#define FAKE_NVML_EXPORT extern "C" __attribute__((visibility("default")))
+
+namespace
+{
+enum class Symbol : std::size_t
+{
+    nvmlInit_v2,
+    nvmlShutdown,
+    nvmlDeviceGetCount_v2,
+    nvmlDeviceGetHandleByIndex_v2,
+    nvmlDeviceGetTemperature,
+    nvmlDeviceSetFanSpeed_v2,
+    nvmlDeviceSetDefaultFanSpeed_v2,
+    nvmlDeviceGetNumFans,
+    nvmlDeviceSetPersistenceMode,
+    nvmlDeviceGetFanSpeed_v2,
+    nvmlDeviceGetTargetFanSpeed,
+    nvmlDeviceGetMinMaxFanSpeed,
+    nvmlDeviceGetTemperatureThreshold,
+    nvmlDeviceGetFieldValues,
+    nvmlDeviceGetCurrentClocksThrottleReasons,
+    nvmlEventSetCreate,
+    nvmlDeviceRegisterEvents,
+    nvmlDeviceGetSupportedEventTypes,
+    nvmlEventSetWait_v2,
+    nvmlEventSetFree,
+    nvmlDeviceGetPowerManagementLimitConstraints,
+    nvmlDeviceGetPowerManagementLimit,
+    nvmlDeviceSetPowerManagementLimit,
+    nvmlDeviceGetHandleByUUID,
+    nvmlDeviceGetUUID,
+    nvmlDeviceGetPciInfo_v3,
+    count,
+};
+
+constexpr std::string_view kSymbolNames[] = {
+    "nvmlInit_v2",
+    "nvmlShutdown",
+    "nvmlDeviceGetCount_v2",
+    "nvmlDeviceGetHandleByIndex_v2",
+    "nvmlDeviceGetTemperature",
+    "nvmlDeviceSetFanSpeed_v2",
+    "nvmlDeviceSetDefaultFanSpeed_v2",
+    "nvmlDeviceGetNumFans",
+    "nvmlDeviceSetPersistenceMode",
+    "nvmlDeviceGetFanSpeed_v2",
+    "nvmlDeviceGetTargetFanSpeed",
+    "nvmlDeviceGetMinMaxFanSpeed",
+    "nvmlDeviceGetTemperatureThreshold",
+    "nvmlDeviceGetFieldValues",
+    "nvmlDeviceGetCurrentClocksThrottleReasons",
+    "nvmlEventSetCreate",
+    "nvmlDeviceRegisterEvents",
+    "nvmlDeviceGetSupportedEventTypes",
+    "nvmlEventSetWait_v2",
+    "nvmlEventSetFree",
+    "nvmlDeviceGetPowerManagementLimitConstraints",
+    "nvmlDeviceGetPowerManagementLimit",
+    "nvmlDeviceSetPowerManagementLimit",
+    "nvmlDeviceGetHandleByUUID",
+    "nvmlDeviceGetUUID",
+    "nvmlDeviceGetPciInfo_v3",
+};
+
+static_assert(std::size(kSymbolNames) ==
+              static_cast<std::size_t>(Symbol::count));
+
+constexpr unsigned int kDefaultDeviceCount = 1;
+constexpr unsigned int kDefaultFanCount = 2;
+constexpr unsigned int kDefaultTemperature = 45;
+
+/* NOTE:
+ * The speed the driver runs a fan at while it isn't under manual control
+ */
+constexpr unsigned int kDefaultFanSpeed = 30;
+
+constexpr unsigned int kDefaultSlowdownTemperature = 93;
+constexpr unsigned int kDefaultShutdownTemperature = 98;
+
+constexpr unsigned int kDefaultMemoryTemperature = 60;
+constexpr unsigned int kDefaultPowerUsage = 150'000;
+
+constexpr unsigned int kDefaultPowerLimit = 250'000;
+constexpr unsigned int kDefaultMinPowerLimit = 100'000;
+constexpr unsigned int kDefaultMaxPowerLimit = 300'000;
+
+constexpr unsigned long long kDefaultEventTypes =
+    nvmlEventTypePState | nvmlEventTypeClock;
+
+struct Fan
+{
+    bool manual { false };
+    unsigned int speed { 0 };
+    bool ignores_commands { false };
+};
+
+auto target_speed(Fan const& fan) noexcept -> unsigned int
+{
+    return fan.manual ? fan.speed : kDefaultFanSpeed;
+}
+
+struct FieldValue
+{
+    unsigned int field_id;
+    unsigned long long value;
+};
+
+struct Device
+{
+    std::vector<Fan> fans;
+    std::vector<unsigned int> temperature_trace;
+    std::size_t trace_position { 0 };
+    nvmlEnableState_t persistence_mode { NVML_FEATURE_DISABLED };
+    bool lost { false };
+    unsigned int min_fan_speed { 0 };
+    unsigned int max_fan_speed { 100 };
+    unsigned int slowdown_temperature { kDefaultSlowdownTemperature };
+    unsigned int shutdown_temperature { kDefaultShutdownTemperature };
+    std::vector<FieldValue> field_values {
+        { NVML_FI_DEV_MEMORY_TEMP, kDefaultMemoryTemperature },
+        { NVML_FI_DEV_POWER_INSTANT, kDefaultPowerUsage },
+    };
+    unsigned long long throttle_reasons { 0 };
+    unsigned long long supported_event_types { kDefaultEventTypes };
+    unsigned int power_limit { kDefaultPowerLimit };
+    unsigned int min_power_limit { kDefaultMinPowerLimit };
+    unsigned int max_power_limit { kDefaultMaxPowerLimit };
+    std::string uuid {};
+    nvmlPciInfo_t pci {};
+};
+
+struct EventRegistration
+{
+    std::size_t device_index;
+    unsigned long long event_types;
+};
+
+struct EventSet
+{
+    std::vector<EventRegistration> registrations;
+    std::deque<nvmlEventData_t> pending;
+};
+
+struct EntryPoint
+{
+    unsigned int latency_us { 0 };
+    nvmlReturn_t error { NVML_SUCCESS };
+    unsigned int error_every { 1 };
+    unsigned long long calls { 0 };
+};
+
+struct System
+{
+    std::mutex mutex;
+    bool configured { false };
+    unsigned int init_count { 0 };
+    std::vector<Device> devices;
+
+    /* NOTE:
+     * The device at each NVML index. The control functions below address
+     * devices by their position in `devices`, which this doesn't change.
+     */
+    std::vector<std::size_t> enumeration_order;
+    std::array<EntryPoint, static_cast<std::size_t>(Symbol::count)>
+        entry_points {};
+
+    /* NOTE:
+     * A list, so handles to the sets stay valid as others are created and
+     * freed
+     */
+    std::list<EventSet> event_sets;
+    std::condition_variable event_posted;
+};
+
+auto system() noexcept -> System&
+{
+    static System instance {};
+    return instance;
+}
+
+auto find_symbol(std::string_view name) noexcept -> EntryPoint*
+{
+    for (std::size_t i = 0; i < std::size(kSymbolNames); ++i) {
+        if (kSymbolNames[i] == name) {
+            return &system().entry_points[i];
+        }
+    }
+
+    return nullptr;
+}
+
+template <typename T>
+auto env_number(std::string const& name, T& output) -> bool
+{
+    char const* value = std::getenv(name.c_str());
+    if (!value) {
+        return false;
+    }
+
+    std::string_view const val { value };
+    return std::from_chars(val.data(), val.data() + val.size(), output).ec ==
+           std::errc {};
+}
+
+auto parse_trace(char const* value) -> std::vector<unsigned int>
+{
+    std::vector<unsigned int> trace;
+    std::string_view input { value };
+
+    while (input.size()) {
+        auto const sep = input.find_first_of(", \t\r\n");
+        auto const token = input.substr(0, sep);
+        unsigned int temperature;
+        if (token.size() &&
+            std::from_chars(
+                token.data(), token.data() + token.size(), temperature)
+                    .ec == std::errc {}) {
+            trace.push_back(temperature);
+        }
+
+        if (sep == std::string_view::npos) {
+            break;
+        }
+        input = input.substr(sep + 1);
+    }
+
+    return trace;
+}
+
+auto configure(System& sys) -> void
+{
+    unsigned int device_count = kDefaultDeviceCount;
+    unsigned int fan_count = kDefaultFanCount;
+    unsigned int min_fan_speed = 0;
+    unsigned int max_fan_speed = 100;
+    env_number("FAKE_NVML_DEVICE_COUNT", device_count);
+    env_number("FAKE_NVML_FAN_COUNT", fan_count);
+    env_number("FAKE_NVML_MIN_FAN_SPEED", min_fan_speed);
+    env_number("FAKE_NVML_MAX_FAN_SPEED", max_fan_speed);
+
+    std::vector<unsigned int> default_trace { kDefaultTemperature };
+    if (char const* value = std::getenv("FAKE_NVML_TEMPERATURE_TRACE");
+        value) {
+        if (auto trace = parse_trace(value); trace.size()) {
+            default_trace = std::move(trace);
+        }
+    }
+
+    sys.devices.clear();
+    sys.devices.resize(device_count);
+    for (unsigned int i = 0; i < device_count; ++i) {
+        auto& device = sys.devices[i];
+        device.fans.resize(fan_count);
+        device.temperature_trace = default_trace;
+        device.min_fan_speed = min_fan_speed;
+        device.max_fan_speed = max_fan_speed;
+
+        /* NOTE:
+         * Each device is on its own bus, as each GPU in a real system is
+         */
+        char uuid[NVML_DEVICE_UUID_V2_BUFFER_SIZE];
+        std::snprintf(uuid,
+                      sizeof(uuid),
+                      "GPU-00000000-0000-0000-0000-%012x",
+                      i + 1);
+        device.uuid = uuid;
+        device.pci = nvmlPciInfo_t {};
+        device.pci.domain = 0;
+        device.pci.bus = (i + 1) & 0xff;
+        device.pci.device = 0;
+        device.pci.pciDeviceId = 0x220410de;
+        std::snprintf(device.pci.busIdLegacy,
+                      sizeof(device.pci.busIdLegacy),
+                      "0000:%02X:00.0",
+                      static_cast<unsigned char>(device.pci.bus));
+        std::snprintf(device.pci.busId,
+                      sizeof(device.pci.busId),
+                      "00000000:%02X:00.0",
+                      static_cast<unsigned char>(device.pci.bus));
+
+        auto const name = "FAKE_NVML_TEMPERATURE_TRACE_" + std::to_string(i);
+        if (char const* value = std::getenv(name.c_str()); value) {
+            if (auto trace = parse_trace(value); trace.size()) {
+                device.temperature_trace = std::move(trace);
+            }
+        }
+    }
+
+    sys.enumeration_order.resize(device_count);
+    for (std::size_t i = 0; i < device_count; ++i) {
+        sys.enumeration_order[i] = i;
+    }
+
+    unsigned int default_latency = 0;
+    env_number("FAKE_NVML_LATENCY_US", default_latency);
+
+    for (std::size_t i = 0; i < std::size(kSymbolNames); ++i) {
+        auto& entry_point = sys.entry_points[i];
+        entry_point = EntryPoint { default_latency };
+
+        auto const symbol = std::string { kSymbolNames[i] };
+        env_number("FAKE_NVML_LATENCY_US_" + symbol, entry_point.latency_us);
+
+        char const* error = std::getenv(("FAKE_NVML_ERROR_" + symbol).c_str());
+        if (!error) {
+            continue;
+        }
+
+        std::string_view const spec { error };
+        auto const at = spec.find('@');
+        auto const code = spec.substr(0, at);
+        int code_value;
+        if (std::from_chars(code.data(), code.data() + code.size(), code_value)
+                .ec != std::errc {}) {
+            continue;
+        }
+        entry_point.error = static_cast<nvmlReturn_t>(code_value);
+
+        if (at != std::string_view::npos) {
+            auto const every = spec.substr(at + 1);
+            std::from_chars(every.data(),
+                            every.data() + every.size(),
+                            entry_point.error_every);
+            if (!entry_point.error_every) {
+                entry_point.error_every = 1;
+            }
+        }
+    }
+
+    sys.configured = true;
+}
+
+auto ensure_configured(System& sys) -> void
+{
+    if (!sys.configured) {
+        configure(sys);
+    }
+}
+
+/* NOTE:
+ * Every simulated entry point goes through `enter()`, which accounts for the
+ * call, applies the configured latency (outside of the lock, so concurrent
+ * callers don't serialize on it) and returns any injected error.
+ */
+auto enter(Symbol symbol, bool requires_init = true) -> nvmlReturn_t
+{
+    auto& sys = system();
+    unsigned int latency_us;
+    nvmlReturn_t result = NVML_SUCCESS;
+    {
+        std::unique_lock lock { sys.mutex };
+        ensure_configured(sys);
+
+        auto& entry_point =
+            sys.entry_points[static_cast<std::size_t>(symbol)];
+        entry_point.calls += 1;
+        latency_us = entry_point.latency_us;
+
+        if (requires_init && !sys.init_count) {
+            result = NVML_ERROR_UNINITIALIZED;
+        }
+        else if (entry_point.error != NVML_SUCCESS &&
+                 entry_point.calls % entry_point.error_every == 0) {
+            result = entry_point.error;
+        }
+    }
+
+    if (latency_us) {
+        std::this_thread::sleep_for(std::chrono::microseconds(latency_us));
+    }
+
+    return result;
+}
+
+auto to_device(nvmlDevice_t handle) noexcept -> Device*
+{
+    auto& sys = system();
+    for (auto& device : sys.devices) {
+        if (reinterpret_cast<nvmlDevice_t>(&device) == handle) {
+            return &device;
+        }
+    }
+
+    return nullptr;
+}
+
+/* NOTE:
+ * Every call on a lost device fails, just as it does after an Xid error
+ * until the GPU has been reset
+ */
+auto check_device(nvmlDevice_t handle) noexcept -> nvmlReturn_t
+{
+    auto* device = to_device(handle);
+    if (!device) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+
+    return device->lost ? NVML_ERROR_GPU_IS_LOST : NVML_SUCCESS;
+}
+
+auto to_event_set(nvmlEventSet_t handle) noexcept -> EventSet*
+{
+    auto& sys = system();
+    for (auto& set : sys.event_sets) {
+        if (reinterpret_cast<nvmlEventSet_t>(&set) == handle) {
+            return &set;
+        }
+    }
+
+    return nullptr;
+}
+
+auto to_fan(nvmlDevice_t handle, unsigned int fan) noexcept -> Fan*
+{
+    auto* device = to_device(handle);
+    if (!device || fan >= device->fans.size()) {
+        return nullptr;
+    }
+
+    return &device->fans[fan];
+}
+
+} // namespace
+
+FAKE_NVML_EXPORT nvmlReturn_t nvmlInit_v2()
+{
+    if (auto const r = enter(Symbol::nvmlInit_v2, false); r != NVML_SUCCESS) {
+        return r;
+    }
+
+    std::unique_lock lock { system().mutex };
+    system().init_count += 1;
+    return NVML_SUCCESS;
+}
+
+FAKE_NVML_EXPORT nvmlReturn_t nvmlShutdown()
+{
+    if (auto const r = enter(Symbol::nvmlShutdown); r != NVML_SUCCESS) {
+        return r;
+    }
+
+    std::unique_lock lock { system().mutex };
+    system().init_count -= 1;
+    return NVML_SUCCESS;
+}
+
+FAKE_NVML_EXPORT char const* nvmlErrorString(nvmlReturn_t result)
+{
+    switch (result) {
+    case NVML_SUCCESS:
+        return "Success";
+    case NVML_ERROR_UNINITIALIZED:
+        return "Uninitialized";
+    case NVML_ERROR_INVALID_ARGUMENT:
+        return "Invalid Argument";
+    case NVML_ERROR_NOT_SUPPORTED:
+        return "Not Supported";
+    case NVML_ERROR_NO_PERMISSION:
+        return "Insufficient Permissions";
+    case NVML_ERROR_NOT_FOUND:
+        return "Not Found";
+    case NVML_ERROR_TIMEOUT:
+        return "Timeout";
+    case NVML_ERROR_GPU_IS_LOST:
+        return "GPU is lost";
+    default:
+        break;
+    }
+
+    return "Unknown Error";
+}
+
+FAKE_NVML_EXPORT nvmlReturn_t nvmlDeviceGetCount_v2(unsigned int* count)
+{
+    if (auto const r = enter(Symbol::nvmlDeviceGetCount_v2);
+        r != NVML_SUCCESS) {
+        return r;
+    }
+
+    if (!count) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::unique_lock lock { system().mutex };
+    *count = static_cast<unsigned int>(system().devices.size());
+    return NVML_SUCCESS;
+}
+
+FAKE_NVML_EXPORT nvmlReturn_t nvmlDeviceGetHandleByIndex_v2(
+    unsigned int index, nvmlDevice_t* device)
+{
+    if (auto const r = enter(Symbol::nvmlDeviceGetHandleByIndex_v2);
+        r != NVML_SUCCESS) {
+        return r;
+    }
+
+    auto& sys = system();
+    std::unique_lock lock { sys.mutex };
+    if (!device || index >= sys.devices.size()) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+
+    auto& target = sys.devices[sys.enumeration_order[index]];
+    if (target.lost) {
+        return NVML_ERROR_GPU_IS_LOST;
+    }
+
+    *device = reinterpret_cast<nvmlDevice_t>(&target);
+    return NVML_SUCCESS;
+}
+
+FAKE_NVML_EXPORT nvmlReturn_t nvmlDeviceGetHandleByUUID(char const* uuid,
+                                                        nvmlDevice_t* device)
+{
+    if (auto const r = enter(Symbol::nvmlDeviceGetHandleByUUID);
+        r != NVML_SUCCESS) {
+        return r;
+    }
+
+    std::unique_lock lock { system().mutex };
+    if (!uuid || !device) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+
+    for (auto& target : system().devices) {
+        if (target.uuid != uuid) {
+            continue;
+        }
+
+        if (target.lost) {
+            return NVML_ERROR_GPU_IS_LOST;
+        }
+
+        *device = reinterpret_cast<nvmlDevice_t>(&target);
+        return NVML_SUCCESS;
+    }
+
+    return NVML_ERROR_NOT_FOUND;
+}
+
+FAKE_NVML_EXPORT nvmlReturn_t nvmlDeviceGetUUID(nvmlDevice_t handle,
+                                                char* uuid,
+                                                unsigned int length)
+{
+    if (auto const r = enter(Symbol::nvmlDeviceGetUUID); r != NVML_SUCCESS) {
+        return r;
+    }
+
+    std::unique_lock lock { system().mutex };
+    if (auto const r = check_device(handle); r != NVML_SUCCESS) {
+        return r;
+    }
+
+    auto* device = to_device(handle);
+    if (!uuid) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (length <= device->uuid.size()) {
+        return NVML_ERROR_INSUFFICIENT_SIZE;
+    }
+
+    std::memcpy(uuid, device->uuid.c_str(), device->uuid.size() + 1);
+    return NVML_SUCCESS;
+}
+
+FAKE_NVML_EXPORT nvmlReturn_t nvmlDeviceGetPciInfo_v3(nvmlDevice_t handle,
+                                                      nvmlPciInfo_t* pci)
+{
+    if (auto const r = enter(Symbol::nvmlDeviceGetPciInfo_v3);
+        r != NVML_SUCCESS) {
+        return r;
+    }
+
+    std::unique_lock lock { system().mutex };
+    if (auto const r = check_device(handle); r != NVML_SUCCESS) {
+        return r;
+    }
+
+    auto* device = to_device(handle);
+    if (!pci) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+
+    *pci = device->pci;
+    return NVML_SUCCESS;
+}
+
+FAKE_NVML_EXPORT nvmlReturn_t nvmlDeviceGetTemperature(
+    nvmlDevice_t handle, nvmlTemperatureSensors_t sensor, unsigned int* temp)
+{
+    if (auto const r = enter(Symbol::nvmlDeviceGetTemperature);
+        r != NVML_SUCCESS) {
+        return r;
+    }
+
+    std::unique_lock lock { system().mutex };
+    if (auto const r = check_device(handle); r != NVML_SUCCESS) {
+        return r;
+    }
+
+    auto* device = to_device(handle);
+    if (!device || !temp || sensor != NVML_TEMPERATURE_GPU) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+
+    auto const& trace = device->temperature_trace;
+    *temp = trace[device->trace_position++ % trace.size()];
+    return NVML_SUCCESS;
+}
+
+FAKE_NVML_EXPORT nvmlReturn_t nvmlDeviceSetFanSpeed_v2(nvmlDevice_t handle,
+                                                       unsigned int fan,
+                                                       unsigned int speed)
+{
+    if (auto const r = enter(Symbol::nvmlDeviceSetFanSpeed_v2);
+        r != NVML_SUCCESS) {
+        return r;
+    }
+
+    std::unique_lock lock { system().mutex };
+    if (auto const r = check_device(handle); r != NVML_SUCCESS) {
+        return r;
+    }
+
+    auto* target = to_fan(handle, fan);
+    auto* device = to_device(handle);
+    if (!target || speed < device->min_fan_speed ||
+        speed > device->max_fan_speed) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (target->ignores_commands) {
+        return NVML_SUCCESS;
+    }
+
+    target->manual = true;
+    target->speed = speed;
+    return NVML_SUCCESS;
+}
+
+FAKE_NVML_EXPORT nvmlReturn_t
+nvmlDeviceSetDefaultFanSpeed_v2(nvmlDevice_t handle, unsigned int fan)
+{
+    if (auto const r = enter(Symbol::nvmlDeviceSetDefaultFanSpeed_v2);
+        r != NVML_SUCCESS) {
+        return r;
+    }
+
+    std::unique_lock lock { system().mutex };
+    if (auto const r = check_device(handle); r != NVML_SUCCESS) {
+        return r;
+    }
+
+    auto* target = to_fan(handle, fan);
+    if (!target) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+
+    target->manual = false;
+    target->speed = 0;
+    return NVML_SUCCESS;
+}
+
+FAKE_NVML_EXPORT nvmlReturn_t nvmlDeviceGetNumFans(nvmlDevice_t handle,
+                                                   unsigned int* count)
+{
+    if (auto const r = enter(Symbol::nvmlDeviceGetNumFans);
+        r != NVML_SUCCESS) {
+        return r;
+    }
+
+    std::unique_lock lock { system().mutex };
+    if (auto const r = check_device(handle); r != NVML_SUCCESS) {
+        return r;
+    }
+
+    auto* device = to_device(handle);
+    if (!device || !count) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+
+    *count = static_cast<unsigned int>(device->fans.size());
+    return NVML_SUCCESS;
+}
+
+FAKE_NVML_EXPORT nvmlReturn_t
+nvmlDeviceSetPersistenceMode(nvmlDevice_t handle, nvmlEnableState_t mode)
+{
+    if (auto const r = enter(Symbol::nvmlDeviceSetPersistenceMode);
+        r != NVML_SUCCESS) {
+        return r;
+    }
+
+    std::unique_lock lock { system().mutex };
+    if (auto const r = check_device(handle); r != NVML_SUCCESS) {
+        return r;
+    }
+
+    auto* device = to_device(handle);
+    if (!device) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+
+    device->persistence_mode = mode;
+    return NVML_SUCCESS;
+}
+
+FAKE_NVML_EXPORT nvmlReturn_t nvmlDeviceGetFanSpeed_v2(nvmlDevice_t handle,
+                                                       unsigned int fan,
+                                                       unsigned int* speed)
+{
+    if (auto const r = enter(Symbol::nvmlDeviceGetFanSpeed_v2);
+        r != NVML_SUCCESS) {
+        return r;
+    }
+
+    std::unique_lock lock { system().mutex };
+    if (auto const r = check_device(handle); r != NVML_SUCCESS) {
+        return r;
+    }
+
+    auto* target = to_fan(handle, fan);
+    if (!target || !speed) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+
+    /* NOTE:
+     * The simulated fans reach their target speed immediately
+     */
+    *speed = target_speed(*target);
+    return NVML_SUCCESS;
+}
+
+FAKE_NVML_EXPORT nvmlReturn_t nvmlDeviceGetTargetFanSpeed(
+    nvmlDevice_t handle, unsigned int fan, unsigned int* speed)
+{
+    if (auto const r = enter(Symbol::nvmlDeviceGetTargetFanSpeed);
+        r != NVML_SUCCESS) {
+        return r;
+    }
+
+    std::unique_lock lock { system().mutex };
+    if (auto const r = check_device(handle); r != NVML_SUCCESS) {
+        return r;
+    }
+
+    auto* target = to_fan(handle, fan);
+    if (!target || !speed) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+
+    *speed = target_speed(*target);
+    return NVML_SUCCESS;
+}
+
+FAKE_NVML_EXPORT nvmlReturn_t nvmlDeviceGetMinMaxFanSpeed(
+    nvmlDevice_t handle, unsigned int* min_speed, unsigned int* max_speed)
+{
+    if (auto const r = enter(Symbol::nvmlDeviceGetMinMaxFanSpeed);
+        r != NVML_SUCCESS) {
+        return r;
+    }
+
+    std::unique_lock lock { system().mutex };
+    if (auto const r = check_device(handle); r != NVML_SUCCESS) {
+        return r;
+    }
+
+    auto* device = to_device(handle);
+    if (!min_speed || !max_speed) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+
+    *min_speed = device->min_fan_speed;
+    *max_speed = device->max_fan_speed;
+    return NVML_SUCCESS;
+}
+
+FAKE_NVML_EXPORT nvmlReturn_t
+nvmlDeviceGetTemperatureThreshold(nvmlDevice_t handle,
+                                  nvmlTemperatureThresholds_t threshold,
+                                  unsigned int* temp)
+{
+    if (auto const r = enter(Symbol::nvmlDeviceGetTemperatureThreshold);
+        r != NVML_SUCCESS) {
+        return r;
+    }
+
+    std::unique_lock lock { system().mutex };
+    if (auto const r = check_device(handle); r != NVML_SUCCESS) {
+        return r;
+    }
+
+    auto* device = to_device(handle);
+    if (!temp) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+
+    switch (threshold) {
+    case NVML_TEMPERATURE_THRESHOLD_SHUTDOWN:
+        *temp = device->shutdown_temperature;
+        return NVML_SUCCESS;
+    case NVML_TEMPERATURE_THRESHOLD_SLOWDOWN:
+        *temp = device->slowdown_temperature;
+        return NVML_SUCCESS;
+    default:
+        break;
+    }
+
+    return NVML_ERROR_NOT_SUPPORTED;
+}
+
+FAKE_NVML_EXPORT nvmlReturn_t nvmlDeviceGetFieldValues(
+    nvmlDevice_t handle, int count, nvmlFieldValue_t* values)
+{
+    if (auto const r = enter(Symbol::nvmlDeviceGetFieldValues);
+        r != NVML_SUCCESS) {
+        return r;
+    }
+
+    std::unique_lock lock { system().mutex };
+    if (auto const r = check_device(handle); r != NVML_SUCCESS) {
+        return r;
+    }
+
+    auto* device = to_device(handle);
+    if (!values || count < 0) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        auto& value = values[i];
+        value.nvmlReturn = NVML_ERROR_NOT_SUPPORTED;
+        for (auto const& field : device->field_values) {
+            if (field.field_id == value.fieldId) {
+                value.valueType = NVML_VALUE_TYPE_UNSIGNED_LONG_LONG;
+                value.value.ullVal = field.value;
+                value.nvmlReturn = NVML_SUCCESS;
+                break;
+            }
+        }
+    }
+
+    return NVML_SUCCESS;
+}
+
+FAKE_NVML_EXPORT nvmlReturn_t
+nvmlDeviceGetCurrentClocksThrottleReasons(nvmlDevice_t handle,
+                                          unsigned long long* reasons)
+{
+    if (auto const r = enter(Symbol::nvmlDeviceGetCurrentClocksThrottleReasons);
+        r != NVML_SUCCESS) {
+        return r;
+    }
+
+    std::unique_lock lock { system().mutex };
+    if (auto const r = check_device(handle); r != NVML_SUCCESS) {
+        return r;
+    }
+
+    auto* device = to_device(handle);
+    if (!reasons) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+
+    *reasons = device->throttle_reasons;
+    return NVML_SUCCESS;
+}
+
+FAKE_NVML_EXPORT nvmlReturn_t nvmlDeviceGetPowerManagementLimitConstraints(
+    nvmlDevice_t handle, unsigned int* min_limit, unsigned int* max_limit)
+{
+    if (auto const r =
+            enter(Symbol::nvmlDeviceGetPowerManagementLimitConstraints);
+        r != NVML_SUCCESS) {
+        return r;
+    }
+
+    std::unique_lock lock { system().mutex };
+    if (auto const r = check_device(handle); r != NVML_SUCCESS) {
+        return r;
+    }
+
+    auto* device = to_device(handle);
+    if (!min_limit || !max_limit) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+
+    *min_limit = device->min_power_limit;
+    *max_limit = device->max_power_limit;
+    return NVML_SUCCESS;
+}
+
+FAKE_NVML_EXPORT nvmlReturn_t
+nvmlDeviceGetPowerManagementLimit(nvmlDevice_t handle, unsigned int* limit)
+{
+    if (auto const r = enter(Symbol::nvmlDeviceGetPowerManagementLimit);
+        r != NVML_SUCCESS) {
+        return r;
+    }
+
+    std::unique_lock lock { system().mutex };
+    if (auto const r = check_device(handle); r != NVML_SUCCESS) {
+        return r;
+    }
+
+    auto* device = to_device(handle);
+    if (!limit) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+
+    *limit = device->power_limit;
+    return NVML_SUCCESS;
+}
+
+FAKE_NVML_EXPORT nvmlReturn_t
+nvmlDeviceSetPowerManagementLimit(nvmlDevice_t handle, unsigned int limit)
+{
+    if (auto const r = enter(Symbol::nvmlDeviceSetPowerManagementLimit);
+        r != NVML_SUCCESS) {
+        return r;
+    }
+
+    std::unique_lock lock { system().mutex };
+    if (auto const r = check_device(handle); r != NVML_SUCCESS) {
+        return r;
+    }
+
+    auto* device = to_device(handle);
+    if (limit < device->min_power_limit || limit > device->max_power_limit) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+
+    device->power_limit = limit;
+    return NVML_SUCCESS;
+}
+
+FAKE_NVML_EXPORT nvmlReturn_t nvmlEventSetCreate(nvmlEventSet_t* set)
+{
+    if (auto const r = enter(Symbol::nvmlEventSetCreate); r != NVML_SUCCESS) {
+        return r;
+    }
+
+    if (!set) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::unique_lock lock { system().mutex };
+    auto& created = system().event_sets.emplace_back();
+    *set = reinterpret_cast<nvmlEventSet_t>(&created);
+    return NVML_SUCCESS;
+}
+
+FAKE_NVML_EXPORT nvmlReturn_t nvmlDeviceRegisterEvents(
+    nvmlDevice_t handle, unsigned long long event_types, nvmlEventSet_t set)
+{
+    if (auto const r = enter(Symbol::nvmlDeviceRegisterEvents);
+        r != NVML_SUCCESS) {
+        return r;
+    }
+
+    auto& sys = system();
+    std::unique_lock lock { sys.mutex };
+    if (auto const r = check_device(handle); r != NVML_SUCCESS) {
+        return r;
+    }
+
+    auto* device = to_device(handle);
+    auto* event_set = to_event_set(set);
+    if (!event_set || !event_types) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+
+    if ((event_types & device->supported_event_types) != event_types) {
+        return NVML_ERROR_NOT_SUPPORTED;
+    }
+
+    event_set->registrations.push_back(EventRegistration {
+        static_cast<std::size_t>(device - sys.devices.data()), event_types });
+    return NVML_SUCCESS;
+}
+
+FAKE_NVML_EXPORT nvmlReturn_t nvmlDeviceGetSupportedEventTypes(
+    nvmlDevice_t handle, unsigned long long* event_types)
+{
+    if (auto const r = enter(Symbol::nvmlDeviceGetSupportedEventTypes);
+        r != NVML_SUCCESS) {
+        return r;
+    }
+
+    std::unique_lock lock { system().mutex };
+    if (auto const r = check_device(handle); r != NVML_SUCCESS) {
+        return r;
+    }
+
+    auto* device = to_device(handle);
+    if (!event_types) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+
+    *event_types = device->supported_event_types;
+    return NVML_SUCCESS;
+}
+
+FAKE_NVML_EXPORT nvmlReturn_t nvmlEventSetWait_v2(nvmlEventSet_t set,
+                                                  nvmlEventData_t* data,
+                                                  unsigned int timeout_ms)
+{
+    if (auto const r = enter(Symbol::nvmlEventSetWait_v2); r != NVML_SUCCESS) {
+        return r;
+    }
+
+    auto& sys = system();
+    std::unique_lock lock { sys.mutex };
+    auto* event_set = to_event_set(set);
+    if (!event_set || !data) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (!sys.event_posted.wait_for(
+            lock, std::chrono::milliseconds(timeout_ms), [&] {
+                return event_set->pending.size() > 0;
+            })) {
+        return NVML_ERROR_TIMEOUT;
+    }
+
+    *data = event_set->pending.front();
+    event_set->pending.pop_front();
+    return NVML_SUCCESS;
+}
+
+FAKE_NVML_EXPORT nvmlReturn_t nvmlEventSetFree(nvmlEventSet_t set)
+{
+    if (auto const r = enter(Symbol::nvmlEventSetFree); r != NVML_SUCCESS) {
+        return r;
+    }
+
+    auto& sys = system();
+    std::unique_lock lock { sys.mutex };
+    auto* event_set = to_event_set(set);
+    if (!event_set) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+
+    sys.event_sets.remove_if(
+        [&](auto const& other) { return &other == event_set; });
+    return NVML_SUCCESS;
+}
+
+FAKE_NVML_EXPORT void fake_nvml_reset()
+{
+    auto& sys = system();
+    std::unique_lock lock { sys.mutex };
+    sys.init_count = 0;
+    sys.event_sets.clear();
+    configure(sys);
+}
+
+FAKE_NVML_EXPORT nvmlReturn_t fake_nvml_set_temperature_trace(
+    unsigned int device_index,
+    unsigned int const* temperatures,
+    unsigned int count)
+{
+    auto& sys = system();
+    std::unique_lock lock { sys.mutex };
+    ensure_configured(sys);
+
+    if (device_index >= sys.devices.size() || !temperatures || !count) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+
+    auto& device = sys.devices[device_index];
+    device.temperature_trace.assign(temperatures, temperatures + count);
+    device.trace_position = 0;
+    return NVML_SUCCESS;
+}
+
+FAKE_NVML_EXPORT nvmlReturn_t fake_nvml_set_latency(char const* symbol,
+                                                    unsigned int microseconds)
+{
+    auto& sys = system();
+    std::unique_lock lock { sys.mutex };
+    ensure_configured(sys);
+
+    auto* entry_point = find_symbol(symbol ? symbol : "");
+    if (!entry_point) {
+        return NVML_ERROR_NOT_FOUND;
+    }
+
+    entry_point->latency_us = microseconds;
+    return NVML_SUCCESS;
+}
+
+FAKE_NVML_EXPORT nvmlReturn_t fake_nvml_set_error(char const* symbol,
+                                                  nvmlReturn_t code,
+                                                  unsigned int every)
+{
+    auto& sys = system();
+    std::unique_lock lock { sys.mutex };
+    ensure_configured(sys);
+
+    auto* entry_point = find_symbol(symbol ? symbol : "");
+    if (!entry_point) {
+        return NVML_ERROR_NOT_FOUND;
+    }
+
+    entry_point->error = code;
+    entry_point->error_every = every ? every : 1;
+    return NVML_SUCCESS;
+}
+
+FAKE_NVML_EXPORT nvmlReturn_t
+fake_nvml_set_device_lost(unsigned int device_index, int lost)
+{
+    auto& sys = system();
+    std::unique_lock lock { sys.mutex };
+    ensure_configured(sys);
+
+    if (device_index >= sys.devices.size()) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+
+    auto& device = sys.devices[device_index];
+    if (device.lost && !lost) {
+        for (auto& fan : device.fans) {
+            fan = Fan {};
+        }
+
+        for (auto& set : sys.event_sets) {
+            std::erase_if(set.registrations, [&](auto const& registration) {
+                return registration.device_index == device_index;
+            });
+        }
+    }
+    device.lost = lost != 0;
+    return NVML_SUCCESS;
+}
+
+FAKE_NVML_EXPORT nvmlReturn_t fake_nvml_set_enumeration_order(
+    unsigned int const* order, unsigned int count)
+{
+    auto& sys = system();
+    std::unique_lock lock { sys.mutex };
+    ensure_configured(sys);
+
+    if (!order || count != sys.devices.size()) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::vector<bool> seen(count, false);
+    for (unsigned int i = 0; i < count; ++i) {
+        if (order[i] >= count || seen[order[i]]) {
+            return NVML_ERROR_INVALID_ARGUMENT;
+        }
+        seen[order[i]] = true;
+    }
+
+    sys.enumeration_order.assign(order, order + count);
+    return NVML_SUCCESS;
+}
+
+FAKE_NVML_EXPORT nvmlReturn_t fake_nvml_set_fan_ignores_commands(
+    unsigned int device_index, unsigned int fan_index, int ignores)
+{
+    auto& sys = system();
+    std::unique_lock lock { sys.mutex };
+    ensure_configured(sys);
+
+    if (device_index >= sys.devices.size() ||
+        fan_index >= sys.devices[device_index].fans.size()) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+
+    sys.devices[device_index].fans[fan_index].ignores_commands = ignores != 0;
+    return NVML_SUCCESS;
+}
+
+FAKE_NVML_EXPORT nvmlReturn_t
+fake_nvml_set_fan_speed_range(unsigned int device_index,
+                              unsigned int min_speed,
+                              unsigned int max_speed)
+{
+    auto& sys = system();
+    std::unique_lock lock { sys.mutex };
+    ensure_configured(sys);
+
+    if (device_index >= sys.devices.size() || min_speed > max_speed) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+
+    auto& device = sys.devices[device_index];
+    device.min_fan_speed = min_speed;
+    device.max_fan_speed = max_speed;
+    return NVML_SUCCESS;
+}
+
+FAKE_NVML_EXPORT nvmlReturn_t
+fake_nvml_set_temperature_thresholds(unsigned int device_index,
+                                     unsigned int slowdown,
+                                     unsigned int shutdown)
+{
+    auto& sys = system();
+    std::unique_lock lock { sys.mutex };
+    ensure_configured(sys);
+
+    if (device_index >= sys.devices.size()) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+
+    auto& device = sys.devices[device_index];
+    device.slowdown_temperature = slowdown;
+    device.shutdown_temperature = shutdown;
+    return NVML_SUCCESS;
+}
+
+FAKE_NVML_EXPORT nvmlReturn_t
+fake_nvml_set_field_value(unsigned int device_index,
+                          unsigned int field_id,
+                          int supported,
+                          unsigned long long value)
+{
+    auto& sys = system();
+    std::unique_lock lock { sys.mutex };
+    ensure_configured(sys);
+
+    if (device_index >= sys.devices.size()) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+
+    auto& fields = sys.devices[device_index].field_values;
+    std::erase_if(fields, [&](auto const& field) {
+        return field.field_id == field_id;
+    });
+    if (supported) {
+        fields.push_back(FieldValue { field_id, value });
+    }
+    return NVML_SUCCESS;
+}
+
+FAKE_NVML_EXPORT nvmlReturn_t
+fake_nvml_set_throttle_reasons(unsigned int device_index,
+                               unsigned long long reasons)
+{
+    auto& sys = system();
+    std::unique_lock lock { sys.mutex };
+    ensure_configured(sys);
+
+    if (device_index >= sys.devices.size()) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+
+    sys.devices[device_index].throttle_reasons = reasons;
+    return NVML_SUCCESS;
+}
+
+FAKE_NVML_EXPORT nvmlReturn_t
+fake_nvml_set_supported_event_types(unsigned int device_index,
+                                    unsigned long long event_types)
+{
+    auto& sys = system();
+    std::unique_lock lock { sys.mutex };
+    ensure_configured(sys);
+
+    if (device_index >= sys.devices.size()) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+
+    sys.devices[device_index].supported_event_types = event_types;
+    return NVML_SUCCESS;
+}
+
+FAKE_NVML_EXPORT nvmlReturn_t fake_nvml_post_event(
+    unsigned int device_index, unsigned long long event_type)
+{
+    auto& sys = system();
+    std::unique_lock lock { sys.mutex };
+    ensure_configured(sys);
+
+    if (device_index >= sys.devices.size()) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+
+    auto const handle =
+        reinterpret_cast<nvmlDevice_t>(&sys.devices[device_index]);
+    for (auto& set : sys.event_sets) {
+        for (auto const& registration : set.registrations) {
+            if (registration.device_index == device_index &&
+                (registration.event_types & event_type)) {
+                set.pending.push_back(
+                    nvmlEventData_t { handle, event_type, 0, 0, 0 });
+                break;
+            }
+        }
+    }
+
+    sys.event_posted.notify_all();
+    return NVML_SUCCESS;
+}
+
+FAKE_NVML_EXPORT nvmlReturn_t
+fake_nvml_get_power_limit(unsigned int device_index, unsigned int* limit)
+{
+    auto& sys = system();
+    std::unique_lock lock { sys.mutex };
+    ensure_configured(sys);
+
+    if (device_index >= sys.devices.size() || !limit) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+
+    *limit = sys.devices[device_index].power_limit;
+    return NVML_SUCCESS;
+}
+
+FAKE_NVML_EXPORT nvmlReturn_t fake_nvml_get_fan_state(unsigned int device_index,
+                                                      unsigned int fan_index,
+                                                      int* is_manual,
+                                                      unsigned int* speed)
+{
+    auto& sys = system();
+    std::unique_lock lock { sys.mutex };
+    ensure_configured(sys);
+
+    if (device_index >= sys.devices.size() ||
+        fan_index >= sys.devices[device_index].fans.size()) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+
+    auto const& fan = sys.devices[device_index].fans[fan_index];
+    if (is_manual) {
+        *is_manual = fan.manual ? 1 : 0;
+    }
+    if (speed) {
+        *speed = fan.speed;
+    }
+    return NVML_SUCCESS;
+}
+
+FAKE_NVML_EXPORT unsigned long long fake_nvml_get_call_count(char const* symbol)
+{
+    auto& sys = system();
+    std::unique_lock lock { sys.mutex };
+
+    auto* entry_point = find_symbol(symbol ? symbol : "");
+    return entry_point ? entry_point->calls : 0;
+}
+
+static_assert(std::is_same_v<decltype(&nvmlInit_v2), PFN_nvmlInit_v2>);
+static_assert(std::is_same_v<decltype(&nvmlShutdown), PFN_nvmlShutdown>);
+static_assert(std::is_same_v<decltype(&nvmlErrorString), PFN_nvmlErrorString>);
+static_assert(std::is_same_v<decltype(&nvmlDeviceGetCount_v2),
+                             PFN_nvmlDeviceGetCount_v2>);
+static_assert(std::is_same_v<decltype(&nvmlDeviceGetHandleByIndex_v2),
+                             PFN_nvmlDeviceGetHandleByIndex_v2>);
+static_assert(std::is_same_v<decltype(&nvmlDeviceGetTemperature),
+                             PFN_nvmlDeviceGetTemperature>);
+static_assert(std::is_same_v<decltype(&nvmlDeviceSetFanSpeed_v2),
+                             PFN_nvmlDeviceSetFanSpeed_v2>);
+static_assert(std::is_same_v<decltype(&nvmlDeviceSetDefaultFanSpeed_v2),
+                             PFN_nvmlDeviceSetDefaultFanSpeed_v2>);
+static_assert(std::is_same_v<decltype(&nvmlDeviceGetNumFans),
+                             PFN_nvmlDeviceGetNumFans>);
+static_assert(std::is_same_v<decltype(&nvmlDeviceSetPersistenceMode),
+                             PFN_nvmlDeviceSetPersistenceMode>);
+static_assert(std::is_same_v<decltype(&nvmlDeviceGetFanSpeed_v2),
+                             PFN_nvmlDeviceGetFanSpeed_v2>);
+static_assert(std::is_same_v<decltype(&nvmlDeviceGetTargetFanSpeed),
+                             PFN_nvmlDeviceGetTargetFanSpeed>);
+static_assert(std::is_same_v<decltype(&nvmlDeviceGetMinMaxFanSpeed),
+                             PFN_nvmlDeviceGetMinMaxFanSpeed>);
+static_assert(std::is_same_v<decltype(&nvmlDeviceGetTemperatureThreshold),
+                             PFN_nvmlDeviceGetTemperatureThreshold>);
+static_assert(std::is_same_v<decltype(&nvmlDeviceGetFieldValues),
+                             PFN_nvmlDeviceGetFieldValues>);
+static_assert(
+    std::is_same_v<decltype(&nvmlDeviceGetCurrentClocksThrottleReasons),
+                   PFN_nvmlDeviceGetCurrentClocksThrottleReasons>);
+static_assert(
+    std::is_same_v<decltype(&nvmlEventSetCreate), PFN_nvmlEventSetCreate>);
+static_assert(std::is_same_v<decltype(&nvmlDeviceRegisterEvents),
+                             PFN_nvmlDeviceRegisterEvents>);
+static_assert(std::is_same_v<decltype(&nvmlDeviceGetSupportedEventTypes),
+                             PFN_nvmlDeviceGetSupportedEventTypes>);
+static_assert(
+    std::is_same_v<decltype(&nvmlEventSetWait_v2), PFN_nvmlEventSetWait_v2>);
+static_assert(
+    std::is_same_v<decltype(&nvmlEventSetFree), PFN_nvmlEventSetFree>);
+static_assert(
+    std::is_same_v<decltype(&nvmlDeviceGetPowerManagementLimitConstraints),
+                   PFN_nvmlDeviceGetPowerManagementLimitConstraints>);
+static_assert(std::is_same_v<decltype(&nvmlDeviceGetPowerManagementLimit),
+                             PFN_nvmlDeviceGetPowerManagementLimit>);
+static_assert(std::is_same_v<decltype(&nvmlDeviceSetPowerManagementLimit),
+                             PFN_nvmlDeviceSetPowerManagementLimit>);
+static_assert(std::is_same_v<decltype(&nvmlDeviceGetHandleByUUID),
+                             PFN_nvmlDeviceGetHandleByUUID>);
+static_assert(
+    std::is_same_v<decltype(&nvmlDeviceGetUUID), PFN_nvmlDeviceGetUUID>);
+static_assert(std::is_same_v<decltype(&nvmlDeviceGetPciInfo_v3),
+                             PFN_nvmlDeviceGetPciInfo_v3>);
@@ -0,0 +1,136 @@
+#ifndef GPUFANCTL_FAKE_NVML_H_INCLUDED
+#define GPUFANCTL_FAKE_NVML_H_INCLUDED
+
+/* NOTE:
+ * Control interface for the stand-in `libnvidia-ml`. These symbols are only
+ * exported by the fake library, so test code that uses them must link against
+ * the `fake-nvml` target directly. The simulated system is configured from
+ * the environment when `nvmlInit_v2()` is first called...
+ *
+ * - FAKE_NVML_DEVICE_COUNT=<N>           Number of devices (default 1)
+ * - FAKE_NVML_FAN_COUNT=<M>              Fans per device (default 2)
+ * - FAKE_NVML_MIN_FAN_SPEED=<PC>         The lowest fan speed that can be set
+ *                                        (default 0)
+ * - FAKE_NVML_MAX_FAN_SPEED=<PC>         The highest fan speed that can be set
+ *                                        (default 100)
+ * - FAKE_NVML_TEMPERATURE_TRACE=<T,...>  Temperatures returned by successive
+ *                                        `nvmlDeviceGetTemperature` calls.
+ *                                        Wraps around (default 45)
+ * - FAKE_NVML_TEMPERATURE_TRACE_<I>=...  As above, for device index <I> only
+ * - FAKE_NVML_LATENCY_US=<US>            Latency added to every call
+ * - FAKE_NVML_LATENCY_US_<SYMBOL>=<US>   Latency added to calls of <SYMBOL>
+ * - FAKE_NVML_ERROR_<SYMBOL>=<CODE>[@<N>] Make every <N>th call of <SYMBOL>
+ *                                        return the `nvmlReturn_t` <CODE>
+ *                                        (default every call)
+ */
+
+#include "nvml.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Discards all state and re-reads the configuration from the environment.
+ */
+void fake_nvml_reset(void);
+
+nvmlReturn_t fake_nvml_set_temperature_trace(unsigned int device_index,
+                                             unsigned int const* temperatures,
+                                             unsigned int count);
+
+nvmlReturn_t fake_nvml_set_latency(char const* symbol,
+                                   unsigned int microseconds);
+
+nvmlReturn_t
+fake_nvml_set_error(char const* symbol, nvmlReturn_t code, unsigned int every);
+
+/* While `lost` is non-zero, every call on the device fails with
+ * NVML_ERROR_GPU_IS_LOST. Clearing it simulates a GPU reset, which also
+ * returns the device's fans to their default state, and drops its event
+ * registrations.
+ */
+nvmlReturn_t fake_nvml_set_device_lost(unsigned int device_index, int lost);
+
+/* Changes the order that NVML enumerates devices in, as a reboot or GPU reset
+ * can. `order[i]` is the device returned for NVML index `i`, and `count` must
+ * be the number of devices. Each device has the UUID
+ * `GPU-00000000-0000-0000-0000-<I + 1>` and the PCI bus ID
+ * `00000000:<I + 1>:00.0`, where `<I>` is the index the other control
+ * functions take, which this doesn't change.
+ */
+nvmlReturn_t fake_nvml_set_enumeration_order(unsigned int const* order,
+                                             unsigned int count);
+
+/* While `ignores` is non-zero, writes to the fan succeed but have no effect,
+ * as with a fan whose controller has stopped responding. A fan that isn't
+ * under manual control reports a speed of 30%.
+ */
+nvmlReturn_t fake_nvml_set_fan_ignores_commands(unsigned int device_index,
+                                                unsigned int fan_index,
+                                                int ignores);
+
+/* Writes outside of `min_speed` to `max_speed` fail with
+ * NVML_ERROR_INVALID_ARGUMENT, as they do on real hardware.
+ */
+nvmlReturn_t fake_nvml_set_fan_speed_range(unsigned int device_index,
+                                           unsigned int min_speed,
+                                           unsigned int max_speed);
+
+/* Defaults to a slowdown temperature of 93, and shutdown at 98.
+ */
+nvmlReturn_t fake_nvml_set_temperature_thresholds(unsigned int device_index,
+                                                  unsigned int slowdown,
+                                                  unsigned int shutdown);
+
+/* Sets the value returned for `field_id` by `nvmlDeviceGetFieldValues`. If
+ * `supported` is zero, the field fails with NVML_ERROR_NOT_SUPPORTED. By
+ * default, every device reports a memory temperature of 60C and a power usage
+ * of 150W, and doesn't support any other field.
+ */
+nvmlReturn_t fake_nvml_set_field_value(unsigned int device_index,
+                                       unsigned int field_id,
+                                       int supported,
+                                       unsigned long long value);
+
+/* Sets the bitmask of `nvmlClocksThrottleReason*` values that the device
+ * reports. No reasons are reported by default.
+ */
+nvmlReturn_t fake_nvml_set_throttle_reasons(unsigned int device_index,
+                                            unsigned long long reasons);
+
+/* Sets the bitmask of `nvmlEventType*` values that the device supports. By
+ * default, every device supports PState and clock events.
+ */
+nvmlReturn_t fake_nvml_set_supported_event_types(
+    unsigned int device_index, unsigned long long event_types);
+
+/* Queues `event_type` for the device on every event set that has registered
+ * for it, waking any `nvmlEventSetWait_v2` callers.
+ */
+nvmlReturn_t fake_nvml_post_event(unsigned int device_index,
+                                  unsigned long long event_type);
+
+/* The device's current power limit, in milliwatts. Every device starts with
+ * a limit of 250W, and accepts limits from 100W to 300W.
+ */
+nvmlReturn_t fake_nvml_get_power_limit(unsigned int device_index,
+                                       unsigned int* limit);
+
+/* Reports whether fan `fan_index` is under manual control, and if so, the
+ * last speed that was written to it.
+ */
+nvmlReturn_t fake_nvml_get_fan_state(unsigned int device_index,
+                                     unsigned int fan_index,
+                                     int* is_manual,
+                                     unsigned int* speed);
+
+/* The number of times `symbol` has been called since the last reset. Failed
+ * (injected) calls are included.
+ */
+unsigned long long fake_nvml_get_call_count(char const* symbol);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GPUFANCTL_FAKE_NVML_H_INCLUDED
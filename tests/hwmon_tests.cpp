@@ -0,0 +1,232 @@
+#include "backend.hpp"
+#include "curve.hpp"
+#include "hwmon.hpp"
+#include "slope.hpp"
+#include "testing.hpp"
+#include <array>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+namespace
+{
+/* NOTE:
+ * A fake hwmon directory, made of regular files, that's removed when it
+ * goes out of scope
+ */
+struct FakeSysfs
+{
+    FakeSysfs()
+    {
+        char path_template[] = "/tmp/gpufanctl-hwmon-XXXXXX";
+        if (!::mkdtemp(path_template)) {
+            throw std::system_error { errno, std::system_category() };
+        }
+        path = path_template;
+
+        write("temp1_input", "45000");
+        write("temp1_label", "edge");
+        write("temp2_input", "52000");
+        write("temp2_label", "junction");
+        write("temp3_input", "70000");
+        write("temp3_label", "mem");
+        write("power1_average", "120000000");
+        write("pwm1", "0");
+        write("pwm1_enable", "2");
+        write("pwm2", "0");
+        write("pwm2_enable", "2");
+    }
+
+    ~FakeSysfs()
+    {
+        std::error_code ec {};
+        std::filesystem::remove_all(path, ec);
+    }
+
+    /* NOTE:
+     * Rewrites the file in place, as sysfs does, so a descriptor that's
+     * already open sees the new value
+     */
+    auto write(std::string const& name, std::string const& value) const
+        -> void
+    {
+        std::ofstream { path + "/" + name, std::ios::trunc } << value << "\n";
+    }
+
+    auto read(std::string const& name) const -> long long
+    {
+        long long value = -1;
+        std::ifstream { path + "/" + name } >> value;
+        return value;
+    }
+
+    std::string path;
+};
+
+auto open_backend(FakeSysfs const& sysfs) -> gfc::HwmonBackend
+{
+    gfc::HwmonBackend backend { sysfs.path };
+    std::error_code ec {};
+    EXPECT(backend.open(ec));
+    return backend;
+}
+} // namespace
+
+auto should_open_hwmon_attributes() -> void
+{
+    FakeSysfs const sysfs;
+    auto backend = open_backend(sysfs);
+
+    EXPECT(backend.fan_count() == 2);
+
+    std::error_code ec {};
+    gfc::Sample sample {};
+    EXPECT(backend.sample(gfc::SampleSensors { true, true, true }, sample, ec));
+    EXPECT(sample.gpu_temperature == 45);
+    EXPECT(sample.memory_temperature == 70u);
+    EXPECT(sample.power_usage == 120'000u);
+    EXPECT(!sample.thermal_slowdown);
+
+    EXPECT(backend.sample(gfc::SampleSensors {}, sample, ec));
+    EXPECT(!sample.memory_temperature);
+    EXPECT(!sample.power_usage);
+}
+
+auto should_fail_without_temperature() -> void
+{
+    FakeSysfs const sysfs;
+    std::filesystem::remove(sysfs.path + "/temp1_input");
+
+    gfc::HwmonBackend backend { sysfs.path };
+    std::error_code ec {};
+    EXPECT(!backend.open(ec));
+    EXPECT(ec == std::errc::no_such_file_or_directory);
+    EXPECT(std::string_view { gfc::HwmonBackend::error_string(ec) } ==
+           "No such file or directory");
+}
+
+auto should_write_pwm_through_held_descriptors() -> void
+{
+    FakeSysfs const sysfs;
+    auto backend = open_backend(sysfs);
+
+    std::error_code ec {};
+    EXPECT(backend.set_fan_speed(0, 50, ec));
+    EXPECT(sysfs.read("pwm1_enable") == 1);
+    EXPECT(sysfs.read("pwm1") == 128);
+    EXPECT(sysfs.read("pwm2_enable") == 2);
+
+    EXPECT(backend.set_fan_speed(1, 100, ec));
+    EXPECT(sysfs.read("pwm2") == 255);
+
+    sysfs.write("temp1_input", "61000");
+    gfc::Sample sample {};
+    EXPECT(backend.sample(gfc::SampleSensors {}, sample, ec));
+    EXPECT(sample.gpu_temperature == 61);
+
+    /* NOTE:
+     * The attributes aren't opened again on each update, so removing them
+     * doesn't stop the backend from working
+     */
+    std::filesystem::remove(sysfs.path + "/temp1_input");
+    EXPECT(backend.sample(gfc::SampleSensors {}, sample, ec));
+    EXPECT(sample.gpu_temperature == 61);
+
+    EXPECT(backend.set_default_fan_speed(0, ec));
+    EXPECT(sysfs.read("pwm1_enable") == 2);
+    EXPECT(!backend.set_fan_speed(2, 50, ec));
+}
+
+auto should_restore_original_fan_mode() -> void
+{
+    FakeSysfs const sysfs;
+    sysfs.write("pwm1_enable", "5");
+    sysfs.write("pwm2_enable", "1");
+    auto backend = open_backend(sysfs);
+
+    std::error_code ec {};
+    EXPECT(backend.set_fan_speed(0, 50, ec));
+    EXPECT(sysfs.read("pwm1_enable") == 1);
+
+    /* NOTE:
+     * Opening the attributes again, as re-acquiring the device does, keeps
+     * the mode that the fan was first found in
+     */
+    EXPECT(backend.reacquire(ec));
+    EXPECT(backend.set_default_fan_speed(0, ec));
+    EXPECT(sysfs.read("pwm1_enable") == 5);
+
+    /* NOTE:
+     * A fan that was already under manual control goes back to the
+     * driver's automatic control
+     */
+    EXPECT(backend.set_default_fan_speed(1, ec));
+    EXPECT(sysfs.read("pwm2_enable") == 2);
+
+    /* NOTE:
+     * A re-open that fails partway keeps the modes for the next one
+     */
+    EXPECT(backend.set_fan_speed(0, 50, ec));
+    std::filesystem::rename(sysfs.path + "/temp1_input",
+                            sysfs.path + "/temp1_saved");
+    EXPECT(!backend.reacquire(ec));
+    std::filesystem::rename(sysfs.path + "/temp1_saved",
+                            sysfs.path + "/temp1_input");
+    EXPECT(backend.reacquire(ec));
+    EXPECT(backend.set_default_fan_speed(0, ec));
+    EXPECT(sysfs.read("pwm1_enable") == 5);
+
+    /* NOTE:
+     * The modes follow the `pwm*` channel, not the fan's position
+     */
+    EXPECT(backend.set_fan_speed(1, 50, ec));
+    std::filesystem::remove(sysfs.path + "/pwm1");
+    std::filesystem::remove(sysfs.path + "/pwm1_enable");
+    EXPECT(backend.reacquire(ec));
+    EXPECT(backend.fan_count() == 1);
+    EXPECT(backend.set_default_fan_speed(0, ec));
+    EXPECT(sysfs.read("pwm2_enable") == 2);
+}
+
+auto should_drive_curve_through_hwmon() -> void
+{
+    FakeSysfs const sysfs;
+    sysfs.write("temp1_input", "60000");
+
+    std::array<gfc::Slope, 1> const slopes { gfc::Slope { { 40, 30 },
+                                                          { 80, 100 } } };
+    auto curve = gfc::curve(open_backend(sysfs),
+                            0,
+                            gfc::DeviceCapabilities {},
+                            slopes,
+                            false,
+                            true,
+                            gfc::ControlSensor::memory);
+
+    /* NOTE:
+     * hwmon can't read back the fan speeds, so this is open-loop
+     */
+    EXPECT(!curve.closed_loop);
+
+    curve();
+    EXPECT(curve.fans_set_to(82));
+    EXPECT(sysfs.read("pwm1") == 209);
+    EXPECT(sysfs.read("pwm2") == 209);
+
+    sysfs.write("temp3_input", "40000");
+    curve();
+    EXPECT(curve.fans_set_to(30));
+    EXPECT(sysfs.read("pwm1") == 77);
+}
+
+auto main() -> int
+{
+    return testing::run({ TEST(should_open_hwmon_attributes),
+                          TEST(should_fail_without_temperature),
+                          TEST(should_write_pwm_through_held_descriptors),
+                          TEST(should_restore_original_fan_mode),
+                          TEST(should_drive_curve_through_hwmon) });
+}
@@ -0,0 +1,1093 @@
+#include "curve.hpp"
+#include "device.hpp"
+#include "errors.hpp"
+#include "event_listener.hpp"
+#include "fake_nvml.h"
+#include "nvml.h"
+#include "nvml.hpp"
+#include "nvml_backend.hpp"
+#include "nvml_stats.hpp"
+#include "power_curve.hpp"
+#include "scope_guard.hpp"
+#include "slope.hpp"
+#include "testing.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+
+namespace
+{
+/* NOTE:
+ * Resets the fake NVML and keeps NVML initialized for the length of a test
+ */
+struct FakeNvml
+{
+    FakeNvml()
+    {
+        fake_nvml_reset();
+        gfc::nvml::init();
+    }
+
+    ~FakeNvml() { gfc::nvml::shutdown(); }
+
+    FakeNvml(FakeNvml const&) = delete;
+    auto operator=(FakeNvml const&) -> FakeNvml& = delete;
+};
+
+constexpr std::array<gfc::Slope, 1> kSlopes { gfc::Slope { { 40, 30 },
+                                                           { 80, 100 } } };
+
+/* NOTE:
+ * A curve for the first fake device, which has two fans
+ */
+auto fake_curve(std::span<gfc::Slope const> slopes = kSlopes,
+                bool closed_loop = false,
+                gfc::ControlSensor control_sensor = gfc::ControlSensor::gpu)
+    -> gfc::Curve
+{
+    return gfc::curve(
+        gfc::Device { 0, gfc::nvml::get_device_handle_by_index(0), 2 },
+        slopes,
+        false,
+        closed_loop,
+        control_sensor);
+}
+} // namespace
+
+auto should_enumerate_fake_devices() -> void
+{
+    FakeNvml const session {};
+
+    EXPECT(gfc::nvml::get_device_count() == 2);
+
+    auto device = gfc::nvml::get_device_handle_by_index(1);
+    EXPECT(gfc::nvml::get_device_fan_count(device) == 2);
+    EXPECT_THROWS(gfc::nvml::get_device_handle_by_index(2));
+}
+
+auto should_replay_temperature_trace() -> void
+{
+    FakeNvml const session {};
+
+    std::array<unsigned int, 3> const trace { 40, 50, 60 };
+    EXPECT(fake_nvml_set_temperature_trace(
+               0, trace.data(), static_cast<unsigned int>(trace.size())) ==
+           NVML_SUCCESS);
+
+    auto device = gfc::nvml::get_device_handle_by_index(0);
+    for (auto const expected : { 40u, 50u, 60u, 40u }) {
+        EXPECT(gfc::nvml::get_device_temperature(
+                   device, NVML_TEMPERATURE_GPU) == expected);
+    }
+    EXPECT(fake_nvml_get_call_count("nvmlDeviceGetTemperature") == 4);
+}
+
+auto should_record_fan_speed_writes() -> void
+{
+    FakeNvml const session {};
+
+    auto device = gfc::nvml::get_device_handle_by_index(0);
+    gfc::nvml::set_device_fan_speed(device, 1, 65);
+
+    int is_manual = 0;
+    unsigned int speed = 0;
+    EXPECT(fake_nvml_get_fan_state(0, 1, &is_manual, &speed) == NVML_SUCCESS);
+    EXPECT(is_manual && speed == 65);
+
+    gfc::nvml::set_device_default_fan_speed(device, 1);
+    EXPECT(fake_nvml_get_fan_state(0, 1, &is_manual, &speed) == NVML_SUCCESS);
+    EXPECT(!is_manual);
+}
+
+auto should_throw_injected_errors() -> void
+{
+    FakeNvml const session {};
+
+    auto device = gfc::nvml::get_device_handle_by_index(0);
+    fake_nvml_set_error("nvmlDeviceGetTemperature", NVML_ERROR_UNKNOWN, 2);
+
+    static_cast<void>(
+        gfc::nvml::get_device_temperature(device, NVML_TEMPERATURE_GPU));
+    EXPECT_THROWS(
+        gfc::nvml::get_device_temperature(device, NVML_TEMPERATURE_GPU));
+}
+
+auto should_time_out_hung_calls() -> void
+{
+    using namespace std::chrono_literals;
+
+    FakeNvml const session {};
+
+    gfc::nvml::set_call_timeout(100ms);
+    GFC_SCOPE_GUARD(
+        [] { gfc::nvml::set_call_timeout(gfc::nvml::kDefaultCallTimeout); });
+
+    auto device = gfc::nvml::get_device_handle_by_index(0);
+    fake_nvml_set_latency("nvmlDeviceGetTemperature", 1'000'000);
+
+    auto const start = std::chrono::steady_clock::now();
+    bool timed_out = false;
+    try {
+        static_cast<void>(
+            gfc::nvml::get_device_temperature(device, NVML_TEMPERATURE_GPU));
+    }
+    catch (std::system_error const& e) {
+        timed_out = e.code() == gfc::ErrorCodes::nvml_call_timeout;
+    }
+    EXPECT(timed_out);
+    EXPECT(std::chrono::steady_clock::now() - start < 500ms);
+
+    /* NOTE:
+     * The hung call must not prevent further calls from being made
+     */
+    fake_nvml_set_latency("nvmlDeviceGetTemperature", 0);
+    static_cast<void>(
+        gfc::nvml::get_device_temperature(device, NVML_TEMPERATURE_GPU));
+}
+
+auto should_block_without_call_timeout() -> void
+{
+    using namespace std::chrono_literals;
+
+    FakeNvml const session {};
+
+    gfc::nvml::set_call_timeout(0ms);
+    GFC_SCOPE_GUARD(
+        [] { gfc::nvml::set_call_timeout(gfc::nvml::kDefaultCallTimeout); });
+
+    auto device = gfc::nvml::get_device_handle_by_index(0);
+    fake_nvml_set_latency("nvmlDeviceGetTemperature", 200'000);
+
+    auto const start = std::chrono::steady_clock::now();
+    static_cast<void>(
+        gfc::nvml::get_device_temperature(device, NVML_TEMPERATURE_GPU));
+    EXPECT(std::chrono::steady_clock::now() - start >= 200ms);
+}
+
+auto should_set_full_fan_speed_on_timeout() -> void
+{
+    using namespace std::chrono_literals;
+
+    FakeNvml const session {};
+
+    gfc::nvml::set_call_timeout(100ms);
+    GFC_SCOPE_GUARD(
+        [] { gfc::nvml::set_call_timeout(gfc::nvml::kDefaultCallTimeout); });
+
+    auto curve = fake_curve();
+
+    fake_nvml_set_latency("nvmlDeviceGetTemperature", 1'000'000);
+    curve();
+
+    int is_manual = 0;
+    unsigned int speed = 0;
+    EXPECT(fake_nvml_get_fan_state(0, 1, &is_manual, &speed) == NVML_SUCCESS);
+    EXPECT(is_manual && speed == 100);
+}
+
+auto should_report_errors_without_throwing() -> void
+{
+    FakeNvml const session {};
+
+    auto device = gfc::nvml::get_device_handle_by_index(0);
+    fake_nvml_set_error(
+        "nvmlDeviceSetFanSpeed_v2", NVML_ERROR_NOT_SUPPORTED, 1);
+
+    std::error_code ec {};
+    EXPECT(!gfc::nvml::set_device_fan_speed(device, 0, 50, ec));
+    EXPECT(ec == gfc::nvml::make_error_code(NVML_ERROR_NOT_SUPPORTED));
+    EXPECT(ec.category() == gfc::nvml::nvml_category());
+
+    ec.clear();
+    unsigned int temperature = 0;
+    EXPECT(gfc::nvml::get_device_temperature(
+        device, NVML_TEMPERATURE_GPU, temperature, ec));
+    EXPECT(!ec && temperature > 0);
+
+    /* NOTE:
+     * Errors from outside NVML are described by their own category
+     */
+    auto const io_error = std::make_error_code(std::errc::io_error);
+    EXPECT(std::string_view { gfc::nvml::error_string(io_error) } ==
+           io_error.message());
+    auto const invalid =
+        gfc::make_error_code(gfc::ErrorCodes::too_few_curve_points);
+    EXPECT(std::string_view { gfc::nvml::error_string(invalid) } ==
+           invalid.message());
+}
+
+auto should_keep_running_after_transient_errors() -> void
+{
+    FakeNvml const session {};
+
+    std::array<unsigned int, 1> const trace { 60 };
+    EXPECT(fake_nvml_set_temperature_trace(0, trace.data(), 1) ==
+           NVML_SUCCESS);
+
+    auto curve = fake_curve();
+
+    /* NOTE:
+     * The first write fails, so the second update must write again, even
+     * though the target fan speed hasn't changed
+     */
+    fake_nvml_set_error("nvmlDeviceSetFanSpeed_v2", NVML_ERROR_UNKNOWN, 1);
+    curve();
+    fake_nvml_set_error("nvmlDeviceSetFanSpeed_v2", NVML_SUCCESS, 1);
+    curve();
+
+    int is_manual = 0;
+    unsigned int speed = 0;
+    EXPECT(fake_nvml_get_fan_state(0, 0, &is_manual, &speed) == NVML_SUCCESS);
+    EXPECT(is_manual && speed == 65);
+}
+
+auto should_only_rewrite_failed_fans() -> void
+{
+    FakeNvml const session {};
+
+    std::array<unsigned int, 1> const trace { 60 };
+    EXPECT(fake_nvml_set_temperature_trace(0, trace.data(), 1) ==
+           NVML_SUCCESS);
+
+    auto curve = fake_curve();
+
+    /* NOTE:
+     * Every second write fails, so only fan 1 fails on the first update,
+     * and only fan 1 should be written to on the next
+     */
+    fake_nvml_set_error("nvmlDeviceSetFanSpeed_v2", NVML_ERROR_UNKNOWN, 2);
+    curve();
+    EXPECT(curve.fans[0].speed == 65 && !curve.fans[0].error);
+    EXPECT(curve.fans[1].speed == gfc::kUnknownFanSpeed &&
+           curve.fans[1].error ==
+               gfc::nvml::make_error_code(NVML_ERROR_UNKNOWN));
+
+    fake_nvml_set_error("nvmlDeviceSetFanSpeed_v2", NVML_SUCCESS, 1);
+    curve();
+    EXPECT(fake_nvml_get_call_count("nvmlDeviceSetFanSpeed_v2") == 3);
+    EXPECT(curve.fans[1].speed == 65 && !curve.fans[1].error);
+
+    curve();
+    EXPECT(fake_nvml_get_call_count("nvmlDeviceSetFanSpeed_v2") == 3);
+}
+
+auto should_recover_lost_device() -> void
+{
+    FakeNvml const session {};
+
+    std::array<unsigned int, 1> const trace { 60 };
+    EXPECT(fake_nvml_set_temperature_trace(0, trace.data(), 1) ==
+           NVML_SUCCESS);
+
+    auto curve = fake_curve();
+    curve();
+
+    EXPECT(fake_nvml_set_device_lost(0, 1) == NVML_SUCCESS);
+    curve();
+    EXPECT(curve.recovery.active);
+    EXPECT(curve.recovery.attempts == 1);
+
+    /* NOTE:
+     * The reset puts the fans back to their defaults. Skip the backoff, so
+     * that the next update tries to re-acquire the device straight away
+     */
+    EXPECT(fake_nvml_set_device_lost(0, 0) == NVML_SUCCESS);
+    curve.recovery.next_attempt = {};
+    curve();
+    EXPECT(!curve.recovery.active);
+
+    int is_manual = 0;
+    unsigned int speed = 0;
+    EXPECT(fake_nvml_get_fan_state(0, 1, &is_manual, &speed) == NVML_SUCCESS);
+    EXPECT(is_manual && speed == 65);
+}
+
+auto should_reinitialize_nvml() -> void
+{
+    FakeNvml const session {};
+
+    auto curve = fake_curve();
+
+    gfc::nvml::shutdown();
+    curve();
+    EXPECT(!curve.recovery.active);
+    EXPECT(fake_nvml_get_call_count("nvmlInit_v2") == 2);
+
+    curve();
+    int is_manual = 0;
+    unsigned int speed = 0;
+    EXPECT(fake_nvml_get_fan_state(0, 0, &is_manual, &speed) == NVML_SUCCESS);
+    EXPECT(is_manual);
+}
+
+auto should_select_devices_by_uuid_and_pci_bus_id() -> void
+{
+    FakeNvml const session {};
+
+    auto const devices = gfc::enumerate_devices();
+    EXPECT(devices.size() == 2);
+    EXPECT(devices[0].uuid == "GPU-00000000-0000-0000-0000-000000000001");
+    EXPECT(devices[1].pci && devices[1].pci->bus == 2);
+    EXPECT(std::string_view { devices[1].pci->busId } == "00000000:02:00.0");
+
+    EXPECT(gfc::matches_device(devices[1], "00000000:02:00.0"));
+    EXPECT(gfc::matches_device(devices[1], "0000:02:00.0"));
+    EXPECT(gfc::matches_device(devices[1], "2:0.0"));
+    EXPECT(gfc::matches_device(devices[1], "02:00"));
+    EXPECT(!gfc::matches_device(devices[1], "02:00.1"));
+    EXPECT(!gfc::matches_device(devices[0], "02:00.0"));
+    EXPECT(gfc::matches_device(devices[0],
+                               "GPU-00000000-0000-0000-0000-000000000001"));
+
+    std::array<std::string_view, 2> const selectors {
+        "02:00.0", "GPU-00000000-0000-0000-0000-000000000001"
+    };
+    auto const selected = gfc::select_devices(devices, selectors);
+    EXPECT(selected.size() == 2);
+    EXPECT(selected[0].index == 1);
+    EXPECT(selected[1].index == 0);
+
+    std::array<std::string_view, 1> const missing { "03:00.0" };
+    EXPECT_THROWS(gfc::select_devices(devices, missing));
+
+    std::array<std::string_view, 1> const invalid { "card1" };
+    EXPECT_THROWS(gfc::select_devices(devices, invalid));
+
+    std::array<std::string_view, 2> const duplicate {
+        "GPU-00000000-0000-0000-0000-000000000002", "0:2:0.0"
+    };
+    EXPECT_THROWS(gfc::select_devices(devices, duplicate));
+}
+
+auto should_reacquire_device_by_uuid() -> void
+{
+    FakeNvml const session {};
+
+    std::array<unsigned int, 1> const trace { 60 };
+    EXPECT(fake_nvml_set_temperature_trace(1, trace.data(), 1) ==
+           NVML_SUCCESS);
+
+    auto const devices = gfc::enumerate_devices();
+    std::array<std::string_view, 1> const selectors { "02:00.0" };
+    auto const selected = gfc::select_devices(devices, selectors);
+
+    auto curve = gfc::curve(selected[0], kSlopes);
+    curve();
+
+    /* NOTE:
+     * The reset also changes the order the devices are enumerated in, so
+     * the device that was at index 1 is now at index 0
+     */
+    EXPECT(fake_nvml_set_device_lost(1, 1) == NVML_SUCCESS);
+    curve();
+    EXPECT(curve.recovery.active);
+
+    std::array<unsigned int, 2> const order { 1, 0 };
+    EXPECT(fake_nvml_set_enumeration_order(order.data(), order.size()) ==
+           NVML_SUCCESS);
+    EXPECT(fake_nvml_set_device_lost(1, 0) == NVML_SUCCESS);
+    curve.recovery.next_attempt = {};
+    curve();
+    EXPECT(!curve.recovery.active);
+
+    int is_manual = 0;
+    unsigned int speed = 0;
+    EXPECT(fake_nvml_get_fan_state(1, 0, &is_manual, &speed) == NVML_SUCCESS);
+    EXPECT(is_manual && speed == 65);
+    EXPECT(fake_nvml_get_fan_state(0, 0, &is_manual, &speed) == NVML_SUCCESS);
+    EXPECT(!is_manual);
+}
+
+auto should_only_write_diverged_fans() -> void
+{
+    FakeNvml const session {};
+
+    std::array<unsigned int, 1> const trace { 60 };
+    EXPECT(fake_nvml_set_temperature_trace(0, trace.data(), 1) ==
+           NVML_SUCCESS);
+
+    auto curve = fake_curve(kSlopes, true);
+
+    curve();
+    EXPECT(fake_nvml_get_call_count("nvmlDeviceSetFanSpeed_v2") == 2);
+
+    /* NOTE:
+     * The fans are already at the target speed, so there's nothing to write
+     */
+    curve();
+    EXPECT(fake_nvml_get_call_count("nvmlDeviceSetFanSpeed_v2") == 2);
+
+    /* NOTE:
+     * Something else has handed fan 1 back to the driver. Only that fan
+     * should be written to
+     */
+    gfc::nvml::set_device_default_fan_speed(curve.backend.handle, 1);
+    curve();
+    EXPECT(fake_nvml_get_call_count("nvmlDeviceSetFanSpeed_v2") == 3);
+
+    int is_manual = 0;
+    unsigned int speed = 0;
+    EXPECT(fake_nvml_get_fan_state(0, 1, &is_manual, &speed) == NVML_SUCCESS);
+    EXPECT(is_manual && speed == 65);
+}
+
+auto should_detect_fans_ignoring_commands() -> void
+{
+    FakeNvml const session {};
+
+    std::array<unsigned int, 1> const trace { 60 };
+    EXPECT(fake_nvml_set_temperature_trace(0, trace.data(), 1) ==
+           NVML_SUCCESS);
+    EXPECT(fake_nvml_set_fan_ignores_commands(0, 0, 1) == NVML_SUCCESS);
+
+    auto curve = fake_curve(kSlopes, true);
+
+    for (auto i = 0; i < 3; ++i) {
+        curve();
+    }
+
+    /* NOTE:
+     * The write to fan 0 never takes, so it's re-issued on every update
+     */
+    EXPECT(curve.fans[0].diverged_ticks == 3);
+    EXPECT(curve.fans[1].diverged_ticks == 0);
+    EXPECT(fake_nvml_get_call_count("nvmlDeviceSetFanSpeed_v2") == 4);
+
+    EXPECT(fake_nvml_set_fan_ignores_commands(0, 0, 0) == NVML_SUCCESS);
+    curve();
+    EXPECT(curve.fans[0].diverged_ticks == 0);
+}
+
+auto should_fall_back_to_open_loop() -> void
+{
+    FakeNvml const session {};
+
+    fake_nvml_set_error(
+        "nvmlDeviceGetTargetFanSpeed", NVML_ERROR_NOT_SUPPORTED, 1);
+
+    auto curve = fake_curve(kSlopes, true);
+
+    curve();
+    EXPECT(!curve.closed_loop);
+
+    int is_manual = 0;
+    unsigned int speed = 0;
+    EXPECT(fake_nvml_get_fan_state(0, 1, &is_manual, &speed) == NVML_SUCCESS);
+    EXPECT(is_manual && speed == 38);
+}
+
+auto should_probe_device_capabilities() -> void
+{
+    FakeNvml const session {};
+
+    EXPECT(fake_nvml_set_fan_speed_range(0, 35, 90) == NVML_SUCCESS);
+    EXPECT(fake_nvml_set_temperature_thresholds(0, 88, 95) == NVML_SUCCESS);
+
+    auto const devices = gfc::enumerate_devices();
+    EXPECT(devices.size() == 2);
+    EXPECT(devices[0].capabilities.min_fan_speed == 35);
+    EXPECT(devices[0].capabilities.max_fan_speed == 90);
+    EXPECT(devices[0].capabilities.slowdown_temperature == 88);
+    EXPECT(devices[0].capabilities.shutdown_temperature == 95);
+    EXPECT(devices[1].capabilities.min_fan_speed == 0);
+    EXPECT(devices[1].capabilities.max_fan_speed == 100);
+}
+
+auto should_clamp_curve_to_device() -> void
+{
+    FakeNvml const session {};
+
+    EXPECT(fake_nvml_set_fan_speed_range(0, 35, 90) == NVML_SUCCESS);
+    std::array<unsigned int, 2> const trace { 40, 80 };
+    EXPECT(fake_nvml_set_temperature_trace(0, trace.data(), 2) ==
+           NVML_SUCCESS);
+
+    std::array<gfc::Slope, 1> const slopes { gfc::Slope { { 40, 20 },
+                                                          { 80, 100 } } };
+    auto const devices = gfc::enumerate_devices();
+    auto const clamped = gfc::clamp_curve(slopes, devices[0].capabilities);
+    EXPECT(clamped.size() == 1);
+    EXPECT(clamped[0].start().fan_speed == 35);
+    EXPECT(clamped[0].end().fan_speed == 90);
+
+    /* NOTE:
+     * A 0% point is the driver's default fan profile, not a speed to raise
+     */
+    std::array<gfc::Slope, 2> const from_default {
+        gfc::Slope { { 30, 0 }, { 40, 20 } },
+        gfc::Slope { { 40, 20 }, { 80, 100 } }
+    };
+    auto const kept = gfc::clamp_curve(from_default, devices[0].capabilities);
+    EXPECT(kept.size() == 2);
+    EXPECT(kept[0].start().fan_speed == 0);
+    EXPECT(kept[0].end().fan_speed == 35);
+    EXPECT(kept[1].end().fan_speed == 90);
+
+    /* NOTE:
+     * Neither write is outside of the range, so neither is rejected
+     */
+    auto curve = gfc::curve(devices[0], clamped);
+    for (auto const expected : { 35u, 90u }) {
+        curve();
+        int is_manual = 0;
+        unsigned int speed = 0;
+        EXPECT(fake_nvml_get_fan_state(0, 0, &is_manual, &speed) ==
+               NVML_SUCCESS);
+        EXPECT(is_manual && speed == expected);
+    }
+
+    /* NOTE:
+     * The fail-safe speed is the device's maximum
+     */
+    curve.fail_safe();
+    int is_manual = 0;
+    unsigned int speed = 0;
+    EXPECT(fake_nvml_get_fan_state(0, 1, &is_manual, &speed) == NVML_SUCCESS);
+    EXPECT(is_manual && speed == 90);
+}
+
+auto should_sample_sensors_in_one_call() -> void
+{
+    FakeNvml const session {};
+
+    auto device = gfc::nvml::get_device_handle_by_index(0);
+    EXPECT(fake_nvml_set_field_value(0, NVML_FI_DEV_MEMORY_TEMP, 1, 72) ==
+           NVML_SUCCESS);
+
+    std::error_code ec {};
+    gfc::Sample sample {};
+    EXPECT(gfc::nvml::sample_device(device, { true, true }, sample, ec));
+    EXPECT(sample.gpu_temperature == 45);
+    EXPECT(sample.memory_temperature && *sample.memory_temperature == 72);
+    EXPECT(sample.power_usage && *sample.power_usage == 150'000);
+    EXPECT(fake_nvml_get_call_count("nvmlDeviceGetFieldValues") == 1);
+
+    /* NOTE:
+     * A sensor that the device doesn't support is left empty, without
+     * failing the sample
+     */
+    EXPECT(fake_nvml_set_field_value(0, NVML_FI_DEV_POWER_INSTANT, 0, 0) ==
+           NVML_SUCCESS);
+    EXPECT(gfc::nvml::sample_device(device, { true, true }, sample, ec));
+    EXPECT(sample.memory_temperature && !sample.power_usage);
+
+    /* NOTE:
+     * Nothing beyond the GPU temperature is read unless it's requested
+     */
+    EXPECT(gfc::nvml::sample_device(device, {}, sample, ec));
+    EXPECT(!sample.memory_temperature && !sample.power_usage);
+    EXPECT(fake_nvml_get_call_count("nvmlDeviceGetFieldValues") == 2);
+}
+
+auto should_drive_curve_from_memory_temperature() -> void
+{
+    FakeNvml const session {};
+
+    std::array<unsigned int, 1> const trace { 40 };
+    EXPECT(fake_nvml_set_temperature_trace(0, trace.data(), 1) ==
+           NVML_SUCCESS);
+    EXPECT(fake_nvml_set_field_value(0, NVML_FI_DEV_MEMORY_TEMP, 1, 80) ==
+           NVML_SUCCESS);
+
+    auto curve =
+        fake_curve(kSlopes, false, gfc::ControlSensor::hottest);
+    curve();
+
+    int is_manual = 0;
+    unsigned int speed = 0;
+    EXPECT(fake_nvml_get_fan_state(0, 0, &is_manual, &speed) == NVML_SUCCESS);
+    EXPECT(is_manual && speed == 100);
+
+    /* NOTE:
+     * Without a memory temperature, the GPU temperature is used
+     */
+    EXPECT(fake_nvml_set_field_value(0, NVML_FI_DEV_MEMORY_TEMP, 0, 0) ==
+           NVML_SUCCESS);
+    curve.control_sensor = gfc::ControlSensor::memory;
+    curve();
+    EXPECT(fake_nvml_get_fan_state(0, 0, &is_manual, &speed) == NVML_SUCCESS);
+    EXPECT(is_manual && speed == 30);
+}
+
+auto should_hold_fan_speed_within_hysteresis() -> void
+{
+    FakeNvml const session {};
+
+    std::array<unsigned int, 7> const trace { 60, 61, 60, 61, 62, 63, 61 };
+    EXPECT(fake_nvml_set_temperature_trace(
+               0, trace.data(), static_cast<unsigned int>(trace.size())) ==
+           NVML_SUCCESS);
+
+    auto curve = fake_curve();
+    curve.hysteresis.up = 2;
+    curve.hysteresis.down = 2;
+
+    /* NOTE:
+     * The speed only changes once the temperature is 2C away from where it
+     * was last changed, at 60C and then at 62C
+     */
+    for (auto const expected : { 65u, 65u, 65u, 65u, 68u, 68u, 68u }) {
+        curve();
+        EXPECT(curve.fans_set_to(expected));
+    }
+
+    EXPECT(curve.write_counts.fan_writes == 4);
+    EXPECT(curve.write_counts.unbanded_fan_writes == 14);
+    EXPECT(fake_nvml_get_call_count("nvmlDeviceSetFanSpeed_v2") == 4);
+
+    /* NOTE:
+     * Without a band, a rise in temperature within the dwell time still
+     * speeds the fans up straight away, but a fall doesn't slow them down
+     */
+    std::array<unsigned int, 3> const jump { 60, 79, 60 };
+    EXPECT(fake_nvml_set_temperature_trace(
+               0, jump.data(), static_cast<unsigned int>(jump.size())) ==
+           NVML_SUCCESS);
+    curve.hysteresis = {};
+    curve.hysteresis.dwell = std::chrono::hours(1);
+    for (auto const expected : { 65u, 98u, 98u }) {
+        curve();
+        EXPECT(curve.fans_set_to(expected));
+    }
+    EXPECT(curve.write_counts.fan_writes == 8);
+}
+
+auto should_ramp_fan_speed_at_slew_rate() -> void
+{
+    FakeNvml const session {};
+
+    std::array<unsigned int, 2> const trace { 40, 80 };
+    EXPECT(fake_nvml_set_temperature_trace(0, trace.data(), 2) ==
+           NVML_SUCCESS);
+
+    auto curve = fake_curve();
+    curve.ramp.rate = 10;
+    EXPECT(curve.ramp_step_period() == std::chrono::milliseconds(100));
+
+    /* NOTE:
+     * The first write has nothing to ramp from
+     */
+    curve();
+    EXPECT(curve.fans_set_to(30));
+    EXPECT(!curve.ramp.active);
+
+    curve();
+    EXPECT(curve.fans_set_to(30));
+    EXPECT(curve.ramp.active && curve.ramp.target == 100);
+
+    curve.ramp.started -= std::chrono::seconds(2);
+    curve.step_ramp();
+    EXPECT(curve.fans_set_to(50));
+
+    /* NOTE:
+     * A new target replaces the ramp, starting from where it had got to
+     */
+    curve();
+    EXPECT(curve.ramp.active && curve.ramp.target == 30);
+    EXPECT(curve.ramp.from == 50);
+
+    curve.ramp.started -= std::chrono::seconds(10);
+    curve.step_ramp();
+    EXPECT(curve.fans_set_to(30));
+    EXPECT(!curve.ramp.active);
+
+    /* NOTE:
+     * The fail-safe isn't ramped
+     */
+    curve();
+    EXPECT(curve.ramp.active);
+    curve.fail_safe();
+    EXPECT(!curve.ramp.active);
+    EXPECT(curve.fans_set_to(100));
+}
+
+auto should_release_fan_speed_slowly() -> void
+{
+    FakeNvml const session {};
+
+    std::array<unsigned int, 2> const trace { 80, 40 };
+    EXPECT(fake_nvml_set_temperature_trace(0, trace.data(), 2) ==
+           NVML_SUCCESS);
+
+    auto curve = fake_curve();
+    curve.response.release = std::chrono::seconds(10);
+
+    curve();
+    EXPECT(curve.fans_set_to(100));
+
+    /* NOTE:
+     * One time constant covers 63% of the way down
+     */
+    curve.response.updated -= std::chrono::seconds(10);
+    curve();
+    EXPECT(curve.fans_set_to(56));
+
+    /* NOTE:
+     * Without an attack time, a rise is followed straight away
+     */
+    curve();
+    EXPECT(curve.fans_set_to(100));
+}
+
+auto should_hold_target_temperature_with_pid() -> void
+{
+    FakeNvml const session {};
+
+    std::array<unsigned int, 1> const trace { 70 };
+    EXPECT(fake_nvml_set_temperature_trace(0, trace.data(), 1) ==
+           NVML_SUCCESS);
+
+    auto curve = fake_curve();
+    curve.pid = gfc::PidController {};
+    curve.pid->setpoint = 75;
+    curve.pid->gains = gfc::PidGains { 4, 0, 0 };
+
+    /* NOTE:
+     * The curve gives 82% at 70C, and being 5C below the setpoint takes
+     * 20% off that
+     */
+    curve();
+    EXPECT(curve.fans_set_to(62));
+
+    curve.pid->setpoint = 60;
+    curve();
+    EXPECT(curve.fans_set_to(100));
+}
+
+auto should_raise_fan_speed_with_power_draw() -> void
+{
+    FakeNvml const session {};
+
+    std::array<unsigned int, 1> const trace { 50 };
+    EXPECT(fake_nvml_set_temperature_trace(0, trace.data(), 1) ==
+           NVML_SUCCESS);
+
+    std::array<gfc::Slope, 1> const slopes { gfc::Slope { { 40, 40 },
+                                                          { 80, 80 } } };
+    std::array<gfc::Slope, 1> const power_slopes {
+        gfc::Slope { { 40, 60 }, { 60, 100 } }
+    };
+    std::array<gfc::PowerCurveRow, 2> const rows {
+        gfc::PowerCurveRow { 0, gfc::fan_speed_table(slopes) },
+        gfc::PowerCurveRow { 300, gfc::fan_speed_table(power_slopes) }
+    };
+    auto curve = fake_curve(slopes);
+    curve.power_curve = gfc::power_curve(rows);
+    curve.sensors.power_usage = true;
+
+    /* NOTE:
+     * The fake device draws 150 W, half way to the curve for 300 W
+     */
+    curve();
+    EXPECT(curve.fans_set_to(65));
+
+    EXPECT(fake_nvml_set_field_value(
+               0, NVML_FI_DEV_POWER_INSTANT, 1, 300'000) == NVML_SUCCESS);
+    curve();
+    EXPECT(curve.fans_set_to(80));
+
+    /* NOTE:
+     * Without a power reading, the main curve is used
+     */
+    EXPECT(fake_nvml_set_field_value(0, NVML_FI_DEV_POWER_INSTANT, 0, 0) ==
+           NVML_SUCCESS);
+    curve();
+    EXPECT(curve.fans_set_to(50));
+}
+
+auto should_escalate_on_thermal_slowdown() -> void
+{
+    FakeNvml const session {};
+
+    std::array<unsigned int, 1> const trace { 60 };
+    EXPECT(fake_nvml_set_temperature_trace(0, trace.data(), 1) ==
+           NVML_SUCCESS);
+
+    auto curve = fake_curve();
+
+    auto const fan_speed = [] {
+        unsigned int speed = 0;
+        fake_nvml_get_fan_state(0, 0, nullptr, &speed);
+        return speed;
+    };
+
+    /* NOTE:
+     * A power cap isn't a thermal slowdown, so the curve is followed
+     */
+    EXPECT(fake_nvml_set_throttle_reasons(
+               0, nvmlClocksThrottleReasonHwPowerBrakeSlowdown) ==
+           NVML_SUCCESS);
+    curve();
+    EXPECT(!curve.throttling.active);
+    EXPECT(fan_speed() == 65);
+
+    EXPECT(fake_nvml_set_throttle_reasons(
+               0, nvmlClocksThrottleReasonSwThermalSlowdown) == NVML_SUCCESS);
+    curve();
+    EXPECT(curve.throttling.active);
+    EXPECT(curve.throttling.events == 1);
+    EXPECT(fan_speed() == 100);
+
+    curve();
+    EXPECT(curve.throttling.events == 1);
+
+    EXPECT(fake_nvml_set_throttle_reasons(0, 0) == NVML_SUCCESS);
+    curve();
+    EXPECT(!curve.throttling.active);
+    EXPECT(fan_speed() == 65);
+
+    EXPECT(fake_nvml_set_throttle_reasons(
+               0, nvmlClocksThrottleReasonHwThermalSlowdown) == NVML_SUCCESS);
+    curve();
+    EXPECT(curve.throttling.events == 2);
+    EXPECT(fan_speed() == 100);
+}
+
+auto should_govern_power_limit() -> void
+{
+    FakeNvml const session {};
+
+    std::array<unsigned int, 11> const trace { 70, 82, 84, 85, 85, 83,
+                                               76, 70, 70, 70, 90 };
+    EXPECT(fake_nvml_set_temperature_trace(
+               0, trace.data(), static_cast<unsigned int>(trace.size())) ==
+           NVML_SUCCESS);
+
+    auto curve = fake_curve();
+
+    std::error_code ec {};
+    EXPECT(curve.enable_power_governor(ec));
+    EXPECT(curve.power_governor.default_limit == 250'000);
+    EXPECT(curve.power_governor.min_limit == 100'000);
+
+    auto const power_limit = [] {
+        unsigned int limit = 0;
+        fake_nvml_get_power_limit(0, &limit);
+        return limit;
+    };
+
+    /* NOTE:
+     * The fans are saturated above 80C. One step is taken at most every
+     * other update, and only while the temperature is rising.
+     */
+    std::array<unsigned int, 11> const expected_limits {
+        250'000, 237'500, 237'500, 225'000, 225'000, 225'000,
+        237'500, 237'500, 250'000, 250'000, 237'500
+    };
+    for (auto const expected : expected_limits) {
+        curve();
+        EXPECT(power_limit() == expected);
+        EXPECT(curve.power_governor.limit == expected);
+    }
+
+    curve.restore_power_limit();
+    EXPECT(power_limit() == 250'000);
+    EXPECT(fake_nvml_get_call_count("nvmlDeviceSetPowerManagementLimit") ==
+           6);
+}
+
+auto should_govern_power_limit_below_full_speed() -> void
+{
+    FakeNvml const session {};
+
+    std::array<unsigned int, 2> const trace { 82, 84 };
+    EXPECT(fake_nvml_set_temperature_trace(
+               0, trace.data(), static_cast<unsigned int>(trace.size())) ==
+           NVML_SUCCESS);
+
+    /* NOTE:
+     * The curve tops out at 80%, so that's as much as the fans will do
+     */
+    std::array<gfc::Slope, 1> const slopes { gfc::Slope { { 40, 30 },
+                                                          { 80, 80 } } };
+    auto curve = fake_curve(slopes);
+
+    std::error_code ec {};
+    EXPECT(curve.enable_power_governor(ec));
+    curve();
+    curve();
+    EXPECT(curve.fans_set_to(80));
+    EXPECT(curve.power_governor.limit == 237'500);
+}
+
+auto should_deliver_device_events() -> void
+{
+    using namespace std::chrono_literals;
+
+    FakeNvml const session {};
+
+    EXPECT(fake_nvml_set_supported_event_types(0, 0) == NVML_SUCCESS);
+
+    std::array<gfc::Device, 2> const devices {
+        gfc::Device { 0, gfc::nvml::get_device_handle_by_index(0), 2 },
+        gfc::Device { 1, gfc::nvml::get_device_handle_by_index(1), 2 },
+    };
+
+    std::atomic<std::size_t> events { 0 };
+    std::atomic<std::size_t> last_device { devices.size() };
+
+    {
+        gfc::EventListener listener;
+        EXPECT(!listener.start(std::span { devices.data(), 1 },
+                               [](std::size_t) {}));
+    }
+
+    gfc::EventListener listener;
+    EXPECT(listener.start(devices, [&](std::size_t device) {
+        last_device = device;
+        events += 1;
+    }));
+
+    /* NOTE:
+     * Device 0 supports no events, and device 1 doesn't support power source
+     * events, so neither of these are delivered
+     */
+    EXPECT(fake_nvml_post_event(0, nvmlEventTypeClock) == NVML_SUCCESS);
+    EXPECT(fake_nvml_post_event(1, nvmlEventTypePowerSourceChange) ==
+           NVML_SUCCESS);
+    EXPECT(fake_nvml_post_event(1, nvmlEventTypePState) == NVML_SUCCESS);
+
+    auto const deadline = std::chrono::steady_clock::now() + 2s;
+    while (!events && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(10ms);
+    }
+
+    listener.stop();
+    EXPECT(events == 1);
+    EXPECT(last_device == 1);
+    EXPECT(fake_nvml_get_call_count("nvmlEventSetFree") == 2);
+}
+
+auto should_wake_after_recovery() -> void
+{
+    using namespace std::chrono_literals;
+
+    FakeNvml const session {};
+
+    std::array<gfc::Device, 1> const devices { gfc::Device {
+        0, gfc::nvml::get_device_handle_by_index(0), 2 } };
+    auto curve = gfc::curve(devices[0], kSlopes);
+
+    std::atomic<std::size_t> events { 0 };
+    gfc::EventListener listener;
+    EXPECT(listener.start(devices, [&](std::size_t) { events += 1; }));
+
+    EXPECT(fake_nvml_set_device_lost(0, 1) == NVML_SUCCESS);
+    curve();
+    EXPECT(curve.recovery.active);
+    EXPECT(fake_nvml_set_device_lost(0, 0) == NVML_SUCCESS);
+    curve.recovery.next_attempt = {};
+    curve();
+    EXPECT(!curve.recovery.active);
+
+    /* NOTE:
+     * The reset dropped the device's registration, so its events aren't
+     * delivered until it has been registered again
+     */
+    EXPECT(fake_nvml_post_event(0, nvmlEventTypeClock) == NVML_SUCCESS);
+    std::this_thread::sleep_for(2 * gfc::EventListener::kWaitTimeout);
+    EXPECT(events == 0);
+
+    listener.refresh(0, curve.backend.handle);
+    std::this_thread::sleep_for(2 * gfc::EventListener::kWaitTimeout);
+    EXPECT(fake_nvml_post_event(0, nvmlEventTypeClock) == NVML_SUCCESS);
+
+    auto const deadline = std::chrono::steady_clock::now() + 2s;
+    while (!events && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(10ms);
+    }
+
+    listener.stop();
+    EXPECT(events == 1);
+}
+
+auto should_record_call_stats() -> void
+{
+    using gfc::nvml::EntryPoint;
+
+    FakeNvml const session {};
+
+    auto device = gfc::nvml::get_device_handle_by_index(0);
+    auto const before =
+        gfc::nvml::get_call_stats(EntryPoint::get_device_temperature);
+
+    fake_nvml_set_error("nvmlDeviceGetTemperature", NVML_ERROR_GPU_IS_LOST, 2);
+    static_cast<void>(
+        gfc::nvml::get_device_temperature(device, NVML_TEMPERATURE_GPU));
+    EXPECT_THROWS(
+        gfc::nvml::get_device_temperature(device, NVML_TEMPERATURE_GPU));
+
+    auto const after =
+        gfc::nvml::get_call_stats(EntryPoint::get_device_temperature);
+    EXPECT(after.calls - before.calls == 2);
+    EXPECT(after.results[NVML_SUCCESS] - before.results[NVML_SUCCESS] == 1);
+    EXPECT(after.results[NVML_ERROR_GPU_IS_LOST] -
+               before.results[NVML_ERROR_GPU_IS_LOST] ==
+           1);
+
+    std::uint64_t latency_before = 0;
+    std::uint64_t latency_after = 0;
+    for (std::size_t i = 0; i < gfc::nvml::kLatencyBucketCount; ++i) {
+        latency_before += before.latency[i];
+        latency_after += after.latency[i];
+    }
+    EXPECT(latency_after - latency_before == 2);
+}
+
+auto should_bucket_call_latency() -> void
+{
+    using namespace std::chrono_literals;
+
+    EXPECT(gfc::nvml::latency_bucket(0ns) == 0);
+    EXPECT(gfc::nvml::latency_bucket(1ns) == 1);
+    EXPECT(gfc::nvml::latency_bucket(1000ns) == 10);
+    EXPECT(gfc::nvml::latency_bucket(1024ns) == 11);
+    EXPECT(gfc::nvml::latency_bucket(10'000h) ==
+           gfc::nvml::kLatencyBucketCount - 1);
+    EXPECT(gfc::nvml::result_bucket(NVML_ERROR_UNKNOWN) ==
+           gfc::nvml::kResultBucketCount - 1);
+}
+
+auto main() -> int
+{
+    return testing::run({ TEST(should_enumerate_fake_devices),
+                          TEST(should_replay_temperature_trace),
+                          TEST(should_record_fan_speed_writes),
+                          TEST(should_throw_injected_errors),
+                          TEST(should_time_out_hung_calls),
+                          TEST(should_block_without_call_timeout),
+                          TEST(should_set_full_fan_speed_on_timeout),
+                          TEST(should_report_errors_without_throwing),
+                          TEST(should_keep_running_after_transient_errors),
+                          TEST(should_only_rewrite_failed_fans),
+                          TEST(should_recover_lost_device),
+                          TEST(should_reinitialize_nvml),
+                          TEST(should_select_devices_by_uuid_and_pci_bus_id),
+                          TEST(should_reacquire_device_by_uuid),
+                          TEST(should_only_write_diverged_fans),
+                          TEST(should_detect_fans_ignoring_commands),
+                          TEST(should_fall_back_to_open_loop),
+                          TEST(should_probe_device_capabilities),
+                          TEST(should_clamp_curve_to_device),
+                          TEST(should_sample_sensors_in_one_call),
+                          TEST(should_drive_curve_from_memory_temperature),
+                          TEST(should_hold_fan_speed_within_hysteresis),
+                          TEST(should_ramp_fan_speed_at_slew_rate),
+                          TEST(should_release_fan_speed_slowly),
+                          TEST(should_hold_target_temperature_with_pid),
+                          TEST(should_raise_fan_speed_with_power_draw),
+                          TEST(should_escalate_on_thermal_slowdown),
+                          TEST(should_govern_power_limit),
+                          TEST(should_govern_power_limit_below_full_speed),
+                          TEST(should_deliver_device_events),
+                          TEST(should_wake_after_recovery),
+                          TEST(should_record_call_stats),
+                          TEST(should_bucket_call_latency) });
+}
@@ -0,0 +1,84 @@
+#include "pid_controller.hpp"
+#include "testing.hpp"
+#include <cmath>
+
+namespace
+{
+auto near(double value, double expected) -> bool
+{
+    return std::abs(value - expected) < 1e-9;
+}
+} // namespace
+
+auto should_add_proportional_term_to_feed_forward() -> void
+{
+    gfc::PidController pid {};
+    pid.setpoint = 70;
+    pid.gains = gfc::PidGains { 4, 0, 0 };
+
+    EXPECT(near(pid(75, 50, 1), 70));
+    EXPECT(near(pid(65, 50, 1), 30));
+    EXPECT(near(pid.terms.proportional, -20));
+
+    /* NOTE:
+     * The output is clamped to its range
+     */
+    EXPECT(near(pid(90, 50, 1), 100));
+    EXPECT(near(pid(50, 50, 1), 0));
+}
+
+auto should_not_wind_up_integral() -> void
+{
+    gfc::PidController pid {};
+    pid.setpoint = 70;
+    pid.gains = gfc::PidGains { 0, 1, 0 };
+
+    /* NOTE:
+     * The first update has no time to integrate over
+     */
+    EXPECT(near(pid(80, 90, 10), 90));
+    EXPECT(near(pid.integral, 0));
+
+    /* NOTE:
+     * 10 degrees for 10 seconds would add 100%, but only 10% is needed to
+     * saturate the output, however long it stays too hot
+     */
+    EXPECT(near(pid(80, 90, 10), 100));
+    EXPECT(near(pid.integral, 10));
+    EXPECT(near(pid(80, 90, 100), 100));
+    EXPECT(near(pid.integral, 10));
+
+    /* NOTE:
+     * So it comes back down as soon as it's too cold
+     */
+    EXPECT(near(pid(68, 90, 2), 96));
+    EXPECT(near(pid.integral, 6));
+
+    pid.reset();
+    EXPECT(near(pid.integral, 0));
+    EXPECT(near(pid(68, 90, 2), 90));
+}
+
+auto should_damp_with_rate_of_temperature_change() -> void
+{
+    gfc::PidController pid {};
+    pid.setpoint = 70;
+    pid.gains = gfc::PidGains { 0, 0, 2 };
+
+    EXPECT(near(pid(60, 50, 5), 50));
+    EXPECT(near(pid(65, 50, 5), 52));
+    EXPECT(near(pid.terms.derivative, 2));
+
+    /* NOTE:
+     * A change of setpoint doesn't kick the output
+     */
+    pid.setpoint = 50;
+    EXPECT(near(pid(65, 50, 5), 50));
+}
+
+auto main() -> int
+{
+    return testing::run({ TEST(should_add_proportional_term_to_feed_forward),
+                          TEST(should_not_wind_up_integral),
+                          TEST(should_damp_with_rate_of_temperature_change) });
+}
@@ -0,0 +1,101 @@
+#include "errors.hpp"
+#include "power_curve.hpp"
+#include "slope.hpp"
+#include "testing.hpp"
+#include <array>
+#include <system_error>
+
+namespace
+{
+auto row(unsigned int power, gfc::Slope const& slope) -> gfc::PowerCurveRow
+{
+    std::array<gfc::Slope, 1> const slopes { slope };
+    return gfc::PowerCurveRow { power, gfc::fan_speed_table(slopes) };
+}
+
+auto throws_error(std::span<gfc::PowerCurveRow const> rows,
+                  gfc::ErrorCodes error) -> bool
+{
+    try {
+        static_cast<void>(gfc::power_curve(rows));
+    }
+    catch (std::system_error const& e) {
+        return e.code() == error;
+    }
+    return false;
+}
+} // namespace
+
+auto should_interpolate_between_powers() -> void
+{
+    /* NOTE:
+     * The rows don't have to be in order of power
+     */
+    std::array<gfc::PowerCurveRow, 2> const rows {
+        row(200, gfc::Slope { { 40, 60 }, { 60, 100 } }),
+        row(0, gfc::Slope { { 40, 40 }, { 80, 80 } })
+    };
+    auto const curve = gfc::power_curve(rows);
+
+    EXPECT(curve.powers.size() == 2);
+    EXPECT(curve.width == 81);
+    EXPECT(curve(50, 0) == 50);
+    EXPECT(curve(50, 100'000) == 65);
+    EXPECT(curve(50, 150'000) == 73);
+    EXPECT(curve(50, 200'000) == 80);
+    EXPECT(curve(50, 300'000) == 80);
+
+    /* NOTE:
+     * Beyond the end of a row, it keeps its last fan speed
+     */
+    EXPECT(curve(70, 200'000) == 100);
+    EXPECT(curve(70, 100'000) == 85);
+    EXPECT(curve(120, 0) == 80);
+    EXPECT(curve(30, 200'000) == 0);
+
+    EXPECT(gfc::PowerCurve {}(50, 100'000) == 0);
+}
+
+auto should_not_interpolate_default_fan_speed() -> void
+{
+    std::array<gfc::PowerCurveRow, 2> const rows {
+        row(0, gfc::Slope { { 40, 40 }, { 80, 80 } }),
+        row(200, gfc::Slope { { 30, 30 }, { 65, 100 } })
+    };
+    auto const curve = gfc::power_curve(rows);
+
+    EXPECT(curve(35, 0) == 0);
+    EXPECT(curve(35, 199'000) == 0);
+    EXPECT(curve(35, 200'000) == 40);
+}
+
+auto should_reject_fan_speeds_dropping_with_power() -> void
+{
+    std::array<gfc::PowerCurveRow, 2> const lower {
+        row(0, gfc::Slope { { 40, 40 }, { 80, 80 } }),
+        row(200, gfc::Slope { { 40, 30 }, { 60, 100 } })
+    };
+    EXPECT(throws_error(lower, gfc::ErrorCodes::power_curve_order));
+
+    /* NOTE:
+     * Handing the fans back to the driver at a higher power is also a drop
+     */
+    std::array<gfc::PowerCurveRow, 2> const later {
+        row(0, gfc::Slope { { 40, 40 }, { 80, 80 } }),
+        row(200, gfc::Slope { { 50, 60 }, { 60, 100 } })
+    };
+    EXPECT(throws_error(later, gfc::ErrorCodes::power_curve_order));
+
+    std::array<gfc::PowerCurveRow, 2> const duplicate {
+        row(100, gfc::Slope { { 40, 40 }, { 80, 80 } }),
+        row(100, gfc::Slope { { 40, 60 }, { 60, 100 } })
+    };
+    EXPECT(throws_error(duplicate, gfc::ErrorCodes::duplicate_power));
+}
+
+auto main() -> int
+{
+    return testing::run({ TEST(should_interpolate_between_powers),
+                          TEST(should_not_interpolate_default_fan_speed),
+                          TEST(should_reject_fan_speeds_dropping_with_power) });
+}
@@ -1,8 +1,12 @@
 #include "slope.hpp"
+#include "spline.hpp"
 #include "testing.hpp"
 #include "utils.hpp"
+#include <algorithm>
 #include <array>
+#include <cstddef>
 #include <iterator>
+#include <span>
 #include <vector>
 
 auto should_construct_slopes_from_iterator_pairs() -> void
@@ -35,7 +39,161 @@ auto should_construct_slopes_from_iterator_pairs() -> void
     EXPECT(slopes[1](80) == 100);
 }
 
+/* NOTE:
+ * Slopes are evaluated in fixed-point, which gives the exact fan speed
+ * rounded down. These are points where evaluating the line in `float`, as
+ * was done before, came out one below.
+ */
+auto should_evaluate_slopes_exactly() -> void
+{
+    gfc::Slope const short_slope { { 20, 1 }, { 25, 4 } };
+    EXPECT(short_slope(20) == 1);
+    EXPECT(short_slope(25) == 4);
+
+    EXPECT((gfc::Slope { { 20, 1 }, { 48, 79 } }(34) == 40));
+    EXPECT((gfc::Slope { { 20, 1 }, { 78, 27 } }(49) == 14));
+    EXPECT((gfc::Slope { { 20, 1 }, { 90, 53 } }(55) == 27));
+    EXPECT((gfc::Slope { { 20, 34 }, { 78, 86 } }(49) == 60));
+
+    EXPECT(short_slope.slope_value() == 0.6f);
+    EXPECT(short_slope.y_intersect() == 4.0f - 0.6f * 25.0f);
+}
+
+auto should_look_up_fan_speeds_in_table() -> void
+{
+    std::array<gfc::Slope, 2> const slopes { gfc::Slope { { 35, 30 },
+                                                          { 60, 50 } },
+                                             gfc::Slope { { 60, 50 },
+                                                          { 80, 100 } } };
+
+    auto const table = gfc::fan_speed_table(slopes);
+    EXPECT(table.speeds.size() == 81);
+
+    for (unsigned int t = 0; t <= 120; ++t) {
+        EXPECT(table(t) == gfc::evaluate_curve(slopes, t));
+    }
+
+    EXPECT(table(34) == 0);
+    EXPECT(table(35) == 30);
+    EXPECT(table(70) == 75);
+    EXPECT(table(80) == 100);
+    EXPECT(table(500) == 100);
+
+    auto const empty = gfc::fan_speed_table({});
+    EXPECT(!empty.speeds.size());
+    EXPECT(empty(50) == 0);
+}
+
+auto should_evaluate_curves_in_batches() -> void
+{
+    std::array<gfc::Slope, 2> const rising { gfc::Slope { { 35, 30 },
+                                                          { 60, 50 } },
+                                             gfc::Slope { { 60, 50 },
+                                                          { 80, 100 } } };
+
+    /* NOTE:
+     * A curve that's been clamped to a device's fan speed range has flat
+     * slopes, whose rate is 0
+     */
+    std::array<gfc::Slope, 3> const clamped { gfc::Slope { { 20, 40 },
+                                                           { 45, 40 } },
+                                              gfc::Slope { { 45, 40 },
+                                                           { 72, 87 } },
+                                              gfc::Slope { { 72, 87 },
+                                                           { 90, 87 } } };
+
+    std::vector<unsigned int> temperatures;
+    for (unsigned int t = 0; t <= 120; ++t) {
+        temperatures.push_back(t);
+    }
+    temperatures.push_back(500);
+
+    std::array<gfc::SlopeArrays, 3> const curves {
+        gfc::slope_arrays(rising),
+        gfc::slope_arrays(clamped),
+        gfc::slope_arrays({}),
+    };
+
+    std::vector<unsigned int> fan_speeds(curves.size() *
+                                         temperatures.size());
+    gfc::evaluate_curves(curves, temperatures, fan_speeds);
+
+    for (std::size_t i = 0; i < temperatures.size(); ++i) {
+        auto const t = temperatures[i];
+        EXPECT(fan_speeds[i] == gfc::evaluate_curve(rising, t));
+        EXPECT(fan_speeds[temperatures.size() + i] ==
+               gfc::evaluate_curve(clamped, t));
+        EXPECT(fan_speeds[2 * temperatures.size() + i] == 0);
+    }
+
+    std::vector<unsigned int> single(temperatures.size());
+    gfc::evaluate_curve(curves[0], temperatures, single);
+    EXPECT(std::equal(single.begin(), single.end(), fan_speeds.begin()));
+}
+
+auto should_interpolate_monotone_spline() -> void
+{
+    std::array<gfc::Slope, 4> const slopes {
+        gfc::Slope { { 35, 30 }, { 50, 35 } },
+        gfc::Slope { { 50, 35 }, { 60, 80 } },
+        gfc::Slope { { 60, 80 }, { 70, 80 } },
+        gfc::Slope { { 70, 80 }, { 80, 100 } },
+    };
+
+    auto const spline = gfc::monotone_spline(slopes);
+    EXPECT(spline.segments.size() == 4);
+
+    /* NOTE:
+     * It goes through every point, never drops, and never leaves the range
+     * of the two points either side. The flat slope stays flat.
+     */
+    for (auto const& slope : slopes) {
+        EXPECT(spline(slope.start().temperature) ==
+               slope.start().fan_speed);
+        EXPECT(spline(slope.end().temperature) == slope.end().fan_speed);
+
+        for (auto t = slope.start().temperature;
+             t < slope.end().temperature;
+             ++t) {
+            EXPECT(spline(t) <= spline(t + 1));
+            EXPECT(spline(t) >= slope.start().fan_speed);
+            EXPECT(spline(t) <= slope.end().fan_speed);
+        }
+    }
+    EXPECT(spline(65) == 80);
+
+    /* NOTE:
+     * Unlike the straight slopes, there's no corner at 50C
+     */
+    EXPECT(spline(51) - spline(50) < 5);
+    EXPECT(gfc::evaluate_curve(slopes, 51) - gfc::evaluate_curve(slopes, 50) ==
+           4);
+
+    EXPECT(spline(34) == 0);
+    EXPECT(spline(200) == 100);
+
+    auto const table = gfc::spline_fan_speed_table(spline);
+    EXPECT(table.speeds.size() == 81);
+    for (unsigned int t = 0; t <= 90; ++t) {
+        EXPECT(table(t) == spline(t));
+    }
+
+    /* NOTE:
+     * A single slope is a straight line either way, give or take rounding
+     */
+    auto const single = std::span { slopes.data(), 1 };
+    auto const line = gfc::monotone_spline(single);
+    for (unsigned int t = 35; t <= 50; ++t) {
+        auto const linear = gfc::evaluate_curve(single, t);
+        EXPECT(line(t) == linear || line(t) == linear + 1);
+    }
+}
+
 auto main() -> int
 {
-    return testing::run({ TEST(should_construct_slopes_from_iterator_pairs) });
+    return testing::run({ TEST(should_construct_slopes_from_iterator_pairs),
+                          TEST(should_evaluate_slopes_exactly),
+                          TEST(should_look_up_fan_speeds_in_table),
+                          TEST(should_evaluate_curves_in_batches),
+                          TEST(should_interpolate_monotone_spline) });
 }
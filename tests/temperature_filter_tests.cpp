@@ -0,0 +1,55 @@
+#include "temperature_filter.hpp"
+#include "testing.hpp"
+#include <initializer_list>
+
+auto should_pass_temperatures_through_unfiltered() -> void
+{
+    gfc::TemperatureFilter filter {};
+    for (auto const temperature : { 40u, 90u, 41u }) {
+        EXPECT(gfc::filter_temperature(filter, temperature) == temperature);
+    }
+}
+
+auto should_average_temperatures() -> void
+{
+    gfc::TemperatureFilter filter { gfc::EmaTemperatureFilter { 3 } };
+
+    /* NOTE:
+     * With a span of 3, each sample moves the average half of the way
+     */
+    EXPECT(gfc::filter_temperature(filter, 40) == 40);
+    EXPECT(gfc::filter_temperature(filter, 60) == 50);
+    EXPECT(gfc::filter_temperature(filter, 60) == 55);
+    EXPECT(gfc::filter_temperature(filter, 40) == 48);
+
+    for (auto i = 0; i < 20; ++i) {
+        static_cast<void>(gfc::filter_temperature(filter, 70));
+    }
+    EXPECT(gfc::filter_temperature(filter, 70) == 70);
+}
+
+auto should_take_median_of_window() -> void
+{
+    gfc::TemperatureFilter filter { gfc::MedianTemperatureFilter { 3 } };
+
+    /* NOTE:
+     * The window starts out full of the first sample, so a single spike
+     * doesn't get through a window of 3, even while it fills
+     */
+    EXPECT(gfc::filter_temperature(filter, 50) == 50);
+    EXPECT(gfc::filter_temperature(filter, 90) == 50);
+    EXPECT(gfc::filter_temperature(filter, 51) == 51);
+    EXPECT(gfc::filter_temperature(filter, 52) == 52);
+    EXPECT(gfc::filter_temperature(filter, 20) == 51);
+    EXPECT(gfc::filter_temperature(filter, 53) == 52);
+
+    gfc::MedianTemperatureFilter const oversized { 100 };
+    EXPECT(oversized.window == gfc::MedianTemperatureFilter::kMaxWindow);
+}
+
+auto main() -> int
+{
+    return testing::run({ TEST(should_pass_temperatures_through_unfiltered),
+                          TEST(should_average_temperatures),
+                          TEST(should_take_median_of_window) });
+}